@@ -27,11 +27,65 @@
 #   OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
 #   ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+import contextlib
 import os
 import re
+import struct
+import time
+import numpy as np
 from pynq.lib import MicroblazeLibrary
 from pynq.lib.pynqmicroblaze.compile import preprocess, checkmodule
 from pynq.lib.pynqmicroblaze.bsp import add_module_path
+from . import firmware_cache
+
+
+def _batch_hash(name):
+    """FNV-1a hash of a function name, as computed by grove_batch.c."""
+    value = 2166136261
+    for c in name.encode():
+        value = ((value ^ c) * 16777619) & 0xFFFFFFFF
+    return value
+
+
+class _Device:
+    """Device of a GroveAdapter that takes part in its batch context.
+
+    Attributes are those of the device returned by the module. Inside
+    `GroveAdapter.batch`, calls of the methods that the IOP can batch are
+    recorded instead of made, and any other access first sends the calls
+    recorded so far.
+
+    """
+    def __init__(self, adapter, module, device):
+        object.__setattr__(self, '_adapter', adapter)
+        object.__setattr__(self, '_module', module)
+        object.__setattr__(self, '_device', device)
+
+    def __getattr__(self, name):
+        adapter = self._adapter
+        if adapter._batch is not None:
+            function = f'{self._module}_{name}'
+            if adapter._batch_supported(function):
+                handle = int(self._device)
+                return lambda *args: adapter._batch_record(function, handle,
+                                                           args)
+            adapter._batch_flush()
+        return getattr(self._device, name)
+
+    def __setattr__(self, name, value):
+        if self._adapter._batch is not None:
+            self._adapter._batch_flush()
+        setattr(self._device, name, value)
+
+    def __int__(self):
+        return int(self._device)
+
+    def __dir__(self):
+        return dir(self._device)
+
+    def __repr__(self):
+        return repr(self._device)
+
 
 class GroveAdapter:
     """This abstract class controls multiple Grove modules connected to a given adapter."""
@@ -46,6 +100,10 @@ class GroveAdapter:
             One of "PMOD", "ARDUINO_SEEED", "ARDUINO_DIGILENT"
         args: list of ports
 
+        The IOP firmware of a module set is compiled once and then loaded
+        from the cache in `firmware_cache`, keyed by the modules, the IOP
+        type and the module sources.
+
         """
         modules = set()
         for _, v in kwargs.items():
@@ -58,13 +116,19 @@ class GroveAdapter:
         for mod in modules:
             if not checkmodule(mod, iop):
                 raise RuntimeError(f"Module {mod} not found")
-        if 'i2c' in modules or 'gpio' in modules or 'analog' in modules:
-            modules.add('grove_interfaces')
-        self._lib = MicroblazeLibrary(iop, modules)
+        modules.add('grove_interfaces')
+        self._lib = firmware_cache.build_library(MicroblazeLibrary, iop,
+                                                 modules)
+        self._port_names = {}
+        self._batch = None
+        self._batch_words = []
+        self._batch_names = []
+        self._batch_functions = {}
         for k, v in kwargs.items():
             if v is None:
                 continue
             port = getattr(self._lib, f'{port_prefix}_{k}')
+            self._port_names[port] = k
             try:
                 if type(v) is str:
                     setattr(self, k, self._instantiate_device(v, port))
@@ -74,6 +138,157 @@ class GroveAdapter:
             except Exception as exc:
                 raise RuntimeError(f"Failed to initialise port {k}") from exc
         
+    _stats_types = {1: 'i2c', 2: 'gpio', 3: 'analog'}
+    _stats_counters = ['transactions', 'bytes_read', 'bytes_written', 'naks']
+
+    def stats(self):
+        """Return the bus usage counters of the devices on this adapter.
+
+        There is one entry per I2C target address and per gpio or analog
+        interface opened by the modules. Cycles are counted with the IOP
+        timer, at the IOP clock frequency.
+
+        Returns
+        -------
+        list of dict
+            Entries with the keys 'port', 'type', 'address',
+            'transactions', 'bytes_read', 'bytes_written', 'naks' and
+            'cycles'
+
+        """
+        entries = []
+        for handle in range(self._lib.grove_stats_count()):
+            entry = {
+                'port': self._port_names.get(
+                    self._lib.grove_stats_port(handle)),
+                'type': self._stats_types[self._lib.grove_stats_type(handle)],
+                'address': self._lib.grove_stats_address(handle)
+            }
+            for counter, name in enumerate(self._stats_counters):
+                entry[name] = self._lib.grove_stats_get(handle, counter)
+            cycles = len(self._stats_counters)
+            entry['cycles'] = self._lib.grove_stats_get(handle, cycles) | \
+                (self._lib.grove_stats_get(handle, cycles + 1) << 32)
+            entries.append(entry)
+        return entries
+
+    def reset_stats(self):
+        """Clear the bus usage counters of all devices on this adapter."""
+        self._lib.grove_stats_reset()
+
+    # Layout of the GROVE_SAMPLE_WORDS words of a sampler sample
+    _sample_dtype = np.dtype([('source', '<u4'), ('value', '<f4'),
+                              ('time_us', '<u8')])
+    # Samples moved per RPC, bounded by the size of the mailbox
+    _sample_chunk = 64
+
+    def drain(self, count=256, timeout_us=0):
+        """Return the readings buffered by the IOP sampler.
+
+        Readings are started with the sample method of a device, which
+        returns the source id carried by its samples. The IOP keeps taking
+        readings until `count` are buffered or `timeout_us` has passed.
+
+        Parameters
+        ----------
+        count : int
+            Largest number of samples to return
+        timeout_us : int
+            Longest time in microseconds the IOP samples for before
+            returning fewer samples, 0 to return those already buffered
+
+        Returns
+        -------
+        numpy.ndarray
+            Samples oldest first, with the fields 'source', 'value' and
+            'time_us' on the IOP time base
+
+        """
+        chunks = []
+        remaining = count
+        deadline = time.monotonic() + timeout_us / 1e6
+        while remaining > 0:
+            size = min(remaining, self._sample_chunk)
+            words = np.zeros(4 * size, dtype=np.uint32)
+            # Each chunk waits for what is left of the whole timeout
+            left_us = max(0, int((deadline - time.monotonic()) * 1e6))
+            got = self._lib.grove_sampler_drain(words, size, left_us)
+            chunks.append(words[:4 * got].view(self._sample_dtype))
+            remaining -= got
+            if got < size:
+                break
+        return np.concatenate(chunks) if chunks else \
+            np.zeros(0, dtype=self._sample_dtype)
+
+    # Command buffer words sent per RPC, bounded by the size of the mailbox
+    _batch_limit = 256
+
+    @contextlib.contextmanager
+    def batch(self):
+        """Send the calls made on the devices of this adapter in one RPC.
+
+        Inside the block, calls of device methods that the IOP can batch,
+        such as set_pixel of an LED stick or on and off of a relay, are
+        recorded and return None. They are sent together when the block
+        ends, or earlier when another device attribute is used, so calls
+        still run in the order they were made.
+
+        Returns
+        -------
+        list
+            Return values of the batched calls, filled as they are sent
+
+        """
+        if self._batch is not None:
+            yield self._batch
+            return
+        self._batch = []
+        try:
+            yield self._batch
+            self._batch_flush()
+        finally:
+            self._batch = None
+            self._batch_words = []
+            self._batch_names = []
+
+    def _batch_supported(self, function):
+        # Drivers register their functions when opened, which is done by
+        # the time the adapter is constructed, so the answer is kept
+        supported = self._batch_functions.get(function)
+        if supported is None:
+            supported = hasattr(self._lib, function) and \
+                bool(self._lib.grove_batch_supported(_batch_hash(function)))
+            self._batch_functions[function] = supported
+        return supported
+
+    def _batch_record(self, function, handle, args):
+        words = []
+        floats = 0
+        for i, arg in enumerate(args):
+            if isinstance(arg, float):
+                floats |= 1 << i
+                words.append(struct.unpack('<I', struct.pack('<f', arg))[0])
+            else:
+                words.append(int(arg) & 0xFFFFFFFF)
+        self._batch_words += [_batch_hash(function), handle & 0xFFFFFFFF,
+                              len(args) | (floats << 8)] + words
+        self._batch_names.append(function)
+        if len(self._batch_words) >= self._batch_limit:
+            self._batch_flush()
+
+    def _batch_flush(self):
+        if not self._batch_names:
+            return
+        words = np.array(self._batch_words, dtype=np.uint32)
+        results = np.zeros(len(self._batch_names), dtype=np.int32)
+        names = self._batch_names
+        self._batch_words = []
+        self._batch_names = []
+        done = self._lib.grove_batch_run(words, len(words), results)
+        self._batch.extend(int(r) for r in results[:done])
+        if done < len(names):
+            raise RuntimeError(f"Batched call {names[done]} was not run")
+
     def _module_basename(self, name):
         return self._module_re.match(name)[1]
         
@@ -102,14 +317,16 @@ class GroveAdapter:
     def _instantiate_device(self, spec, port):
         chain = spec.split('.')
         if len(chain) == 1:
-                return self._open_device(chain[0], port)
+                return _Device(self, self._module_basename(chain[0]),
+                               self._open_device(chain[0], port))
         else:
             if self._module_basename(chain[0]) == 'grove_adc':
                 adc = self._open_device(chain[0], port)
                 if not hasattr(self._lib, f'{chain[1]}_open_adc'):
                     raise RuntimeError(
                             f'{chain[1]} should not be connected to an ADC')
-                return getattr(self._lib, f'{chain[1]}_open_adc')(adc)
+                return _Device(self, chain[1],
+                               getattr(self._lib, f'{chain[1]}_open_adc')(adc))
             else:
                 raise RuntimeError("Only grove_adc can be used in a chain")
 
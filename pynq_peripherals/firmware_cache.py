@@ -0,0 +1,292 @@
+#   Copyright (c) 2021, Xilinx, Inc.
+#   All rights reserved.
+# 
+#   Redistribution and use in source and binary forms, with or without 
+#   modification, are permitted provided that the following conditions are met:
+#
+#   1.  Redistributions of source code must retain the above copyright notice, 
+#       this list of conditions and the following disclaimer.
+#
+#   2.  Redistributions in binary form must reproduce the above copyright 
+#       notice, this list of conditions and the following disclaimer in the 
+#       documentation and/or other materials provided with the distribution.
+#
+#   3.  Neither the name of the copyright holder nor the names of its 
+#       contributors may be used to endorse or promote products derived from 
+#       this software without specific prior written permission.
+#
+#   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+#   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+#   THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR 
+#   PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+#   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+#   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+#   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+#   OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+#   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+#   OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+#   ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+import contextlib
+import hashlib
+import os
+import shutil
+import tempfile
+import threading
+import pynq
+from pynq.lib.pynqmicroblaze import rpc
+from pynq.lib.pynqmicroblaze.compile import MicroblazeProgram
+from pynq.lib.pynqmicroblaze.pynqmicroblaze import PynqMicroblaze
+
+THIS_DIR = os.path.dirname(os.path.realpath(__file__))
+MODULES_DIR = os.path.join(THIS_DIR, "modules")
+DEFAULT_DIR = os.path.join(os.path.expanduser("~"), ".cache",
+                           "pynq_peripherals")
+
+PROGRAM_FILE = "program.bin"
+SOURCE_FILE = "program.i"
+
+_sources_digest = None
+_file_digests = {}
+# The RPC generator is patched module-wide, so only one library is built
+# at a time
+_build_lock = threading.Lock()
+
+
+def cache_dir():
+    """Return the directory of the firmware cache.
+
+    The PYNQ_PERIPHERALS_CACHE environment variable overrides the default
+    of ~/.cache/pynq_peripherals. Setting it to an empty string disables
+    the cache.
+
+    """
+    return os.environ.get("PYNQ_PERIPHERALS_CACHE", DEFAULT_DIR)
+
+
+def clear():
+    """Remove every cached firmware image."""
+    directory = cache_dir()
+    if directory:
+        shutil.rmtree(directory, ignore_errors=True)
+
+
+def _hash_sources():
+    global _sources_digest
+    if _sources_digest is None:
+        digest = hashlib.sha256()
+        for root, dirs, files in os.walk(MODULES_DIR):
+            dirs.sort()
+            for name in sorted(files):
+                path = os.path.join(root, name)
+                digest.update(os.path.relpath(path, MODULES_DIR).encode())
+                with open(path, "rb") as f:
+                    digest.update(hashlib.sha256(f.read()).digest())
+        _sources_digest = digest.hexdigest()
+    return _sources_digest
+
+
+def _hash_file(path):
+    # Bitstreams are large, so a digest is kept while the file is unchanged
+    stat = os.stat(path)
+    stamp = (path, stat.st_mtime_ns, stat.st_size)
+    if stamp not in _file_digests:
+        digest = hashlib.sha256()
+        with open(path, "rb") as f:
+            for block in iter(lambda: f.read(1 << 20), b""):
+                digest.update(block)
+        _file_digests[stamp] = digest.hexdigest()
+    return _file_digests[stamp]
+
+
+def _overlay_identity():
+    # The hwh describes the IOP address map and the peripherals in it; older
+    # overlays only ship the bitstream
+    bitfile = getattr(getattr(pynq, "PL", None), "bitfile_name", None)
+    if not bitfile:
+        return ""
+    for path in (os.path.splitext(bitfile)[0] + ".hwh", bitfile):
+        if os.path.isfile(path):
+            return _hash_file(path)
+    return str(bitfile)
+
+
+def _bsp_identity(iop):
+    try:
+        from pynq.lib.pynqmicroblaze.bsp import BSPs
+    except ImportError:
+        return ""
+    bsp = BSPs.get(iop.get("mbtype")) if isinstance(iop, dict) else None
+    if bsp is None:
+        return ""
+    parts = [str(path) for path in getattr(bsp, "include_path", [])]
+    for path in ([getattr(bsp, "linker_script", None)] +
+                 list(getattr(bsp, "libraries", []))):
+        if path and os.path.isfile(path):
+            parts.append(path + ":" + _hash_file(path))
+    return ",".join(parts)
+
+
+def _iop_type(iop):
+    if isinstance(iop, dict):
+        return str(iop.get("mbtype", iop.get("ip_name")))
+    return type(iop).__name__
+
+
+def cache_key(iop, modules):
+    """Return the cache key of a driver set built for an IOP.
+
+    The key covers the module names, the IOP type, the PYNQ version whose
+    BSP and RPC generator are used, the BSP of the IOP with the contents of
+    its linker script and libraries, the hwh (or bitstream) of the loaded
+    overlay and the contents of every file under the modules directory.
+
+    Parameters
+    ----------
+    iop : dict
+        mb_info of the IOP the library is built for
+    modules : iterable of str
+        Names of the modules in the library
+
+    """
+    digest = hashlib.sha256()
+    for part in (",".join(sorted(modules)), _iop_type(iop),
+                 getattr(pynq, "__version__", ""), _bsp_identity(iop),
+                 _overlay_identity(), _hash_sources()):
+        digest.update(part.encode())
+        digest.update(b"\0")
+    return digest.hexdigest()
+
+
+class _Entry:
+    """Cached firmware of one driver set and the text its bindings use."""
+
+    def __init__(self, directory, key):
+        self.path = os.path.join(directory, key)
+        self.program = os.path.join(self.path, PROGRAM_FILE)
+        self.source = os.path.join(self.path, SOURCE_FILE)
+
+    def exists(self):
+        return os.path.isfile(self.program) and os.path.isfile(self.source)
+
+    def read_source(self):
+        with open(self.source) as f:
+            return f.read()
+
+    def remove(self):
+        shutil.rmtree(self.path, ignore_errors=True)
+
+    def store(self, program, source):
+        parent = os.path.dirname(self.path)
+        os.makedirs(parent, exist_ok=True)
+        staging = tempfile.mkdtemp(dir=parent)
+        try:
+            shutil.copyfile(program, os.path.join(staging, PROGRAM_FILE))
+            with open(os.path.join(staging, SOURCE_FILE), "w") as f:
+                f.write(source)
+            os.replace(staging, self.path)
+        except OSError:
+            # Another process stored the same entry first
+            shutil.rmtree(staging, ignore_errors=True)
+
+
+def _cached_program(entry):
+    class CachedProgram(MicroblazeProgram):
+        def __init__(self, mb_info, program_text, bsp=None):
+            PynqMicroblaze.__init__(self, mb_info, entry.program)
+    return CachedProgram
+
+
+def _capturing_program(captured):
+    class Capture(PynqMicroblaze):
+        def __init__(self, mb_info, mb_program, *args, **kwargs):
+            fd, captured["program"] = tempfile.mkstemp(suffix=".bin")
+            os.close(fd)
+            shutil.copyfile(mb_program, captured["program"])
+            super().__init__(mb_info, mb_program, *args, **kwargs)
+
+    class CapturingProgram(MicroblazeProgram, Capture):
+        pass
+    return CapturingProgram
+
+
+@contextlib.contextmanager
+def _patched(**replacements):
+    # Only names the RPC generator imports are replaced, so a PYNQ release
+    # that moves one of them falls back to building as usual
+    saved = {name: getattr(rpc, name) for name in replacements
+             if hasattr(rpc, name)}
+    for name in saved:
+        setattr(rpc, name, replacements[name])
+    try:
+        yield
+    finally:
+        for name, value in saved.items():
+            setattr(rpc, name, value)
+
+
+def _load(library, iop, modules, entry):
+    source = entry.read_source()
+    with _patched(MicroblazeProgram=_cached_program(entry),
+                  preprocess=lambda *args, **kwargs: source):
+        return library(iop, modules)
+
+
+def _build(library, iop, modules, entry):
+    captured = {}
+    preprocess = getattr(rpc, "preprocess", None)
+
+    def capture_source(*args, **kwargs):
+        captured["source"] = preprocess(*args, **kwargs)
+        return captured["source"]
+
+    try:
+        with _patched(MicroblazeProgram=_capturing_program(captured),
+                      preprocess=capture_source):
+            lib = library(iop, modules)
+        if "program" in captured and "source" in captured:
+            entry.store(captured["program"], captured["source"])
+    finally:
+        if "program" in captured:
+            os.remove(captured["program"])
+    return lib
+
+
+def build_library(library, iop, modules):
+    """Build a MicroblazeLibrary, reusing a cached firmware image if present.
+
+    A cache hit loads the stored binary onto the IOP and generates the
+    bindings from the stored preprocessed source, so neither the compiler
+    nor the preprocessor of the MicroBlaze toolchain is run. A miss builds
+    the library as usual and stores both for the next start. An entry that
+    fails to load is removed and the library is built as on a miss.
+
+    Builds are serialized, so adapters can be started from several threads.
+
+    Parameters
+    ----------
+    library : class
+        MicroblazeLibrary or a compatible class
+    iop : dict
+        mb_info of the IOP to run the library on
+    modules : iterable of str
+        Names of the modules in the library
+
+    Returns
+    -------
+    The constructed library object
+
+    """
+    directory = cache_dir()
+    if not directory:
+        return library(iop, modules)
+    entry = _Entry(directory, cache_key(iop, modules))
+    with _build_lock:
+        if entry.exists():
+            try:
+                return _load(library, iop, modules, entry)
+            except Exception:
+                # Truncated or corrupt entry, build it again
+                entry.remove()
+        return _build(library, iop, modules, entry)
+
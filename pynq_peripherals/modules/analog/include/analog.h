@@ -117,6 +117,102 @@ py_float analog_get_voltage(analog dev_id);
  */
 py_int analog_get_raw(analog dev_id);
 
+/* Read the analog signal and return millivolts
+ *
+ * The conversion uses a fixed-point scale resolved when the device was
+ * opened and only integer arithmetic.
+ *
+ * Parameters
+ * ----------
+ *     None
+ *
+ * Returns
+ * -------
+ *   integer:
+ *     Voltage in mV, rounded to the nearest mV
+ *     -ENXIO if the device is not open
+ *     -EIO otherwise to raise exception
+ */
+py_int analog_get_millivolts(analog dev_id);
+
+/* Read the reference voltage in millivolts
+ *
+ * Parameters
+ * ----------
+ *     None
+ *
+ * Returns
+ * -------
+ *   integer:
+ *     3100 if Grove ADC, 3300 if System Monitor
+ *     -ENXIO if the device is not open
+ */
+py_int analog_get_reference_millivolts(analog dev_id);
+
+/* Largest number of Grove ADC conversions averaged per reading */
+#define ANALOG_AVERAGE_MAX 256
+
+/* Average several conversions into every reading of a device
+ *
+ * System Monitor channels use the hardware averaging of the sequencer
+ * over 16, 64 or 256 conversions: the channel then takes that many
+ * sequencer passes to produce a new value. The averaging count is shared
+ * by all System Monitor channels that use it. Grove ADC devices average
+ * consecutive conversions in software, so every reading takes samples
+ * times as long. The setting applies to every read function.
+ *
+ * Parameters
+ * ----------
+ * samples: int
+ *     Conversions per reading: 1, 16, 64 or 256 for the System Monitor,
+ *     1 to ANALOG_AVERAGE_MAX for a Grove ADC; 1 turns averaging off
+ *
+ * Returns
+ * -------
+ *     PY_SUCCESS if the setting was applied
+ *     -EINVAL if the number of samples is not supported
+ *     -EBUSY if another System Monitor channel averages a different number
+ *     -ENXIO if the device is not open
+ *
+ */
+py_int analog_set_averaging(analog dev_id, int samples);
+
+/* Number of conversions averaged into every reading of a device
+ *
+ * Parameters
+ * ----------
+ *     None
+ *
+ * Returns
+ * -------
+ *     Conversions per reading
+ *     -ENXIO if the device is not open
+ *
+ */
+py_int analog_get_averaging(analog dev_id);
+
+/* Read several analog signals from the same conversion cycle
+ *
+ * System Monitor channels are read after a single end of sequence, so
+ * the values were converted in the same pass of the sequencer. Grove ADC
+ * devices are read one after another.
+ *
+ * Parameters
+ * ----------
+ * devs: const analog*
+ *     Devices to read
+ * n: int
+ *     Number of devices
+ * out: py_int*
+ *     Raw values in the order of devs, as returned by analog_get_raw
+ *
+ * Returns
+ * -------
+ *     PY_SUCCESS if every device was read
+ *     -EIO otherwise to raise exception
+ */
+py_int analog_get_raw_multi(const analog *devs, int n, py_int *out);
+
 /* Read the reference voltage
  *
  * Parameters
@@ -144,3 +240,119 @@ py_float analog_get_reference(analog dev_id);
  *     -PY_INT_ERROR otherwise to raise exception
  */
 py_int analog_get_max(analog dev_id);
+
+// Streaming
+/* Number of System Monitor channels that can stream at the same time */
+#ifndef ANALOG_STREAMS
+#define ANALOG_STREAMS 2
+#endif
+
+/* Samples buffered per stream, must be a power of two */
+#ifndef ANALOG_STREAM_DEPTH
+#define ANALOG_STREAM_DEPTH 1024
+#endif
+
+/* Highest sample rate of a stream in Hz */
+#define ANALOG_STREAM_RATE_MAX 100000
+
+/* Start sampling a System Monitor channel into a ring buffer
+ *
+ * The channel is added to the continuous sequence of the System Monitor
+ * and sampled every 1/rate seconds, paced by the IOP timer. Samples are
+ * captured whenever analog_stream_poll runs, either directly, from
+ * analog_stream_wait and analog_stream_read, or from the scheduler while
+ * a driver waits for a conversion. Starting a stream that is
+ * already running restarts it with an empty buffer.
+ *
+ * Parameters
+ * ----------
+ * rate: unsigned int
+ *     Samples per second, up to ANALOG_STREAM_RATE_MAX
+ *
+ * Returns
+ * -------
+ *     PY_SUCCESS if the stream was started
+ *     -EINVAL if the rate is out of range
+ *     -ENOMEM if ANALOG_STREAMS channels are already streaming
+ *     -ENXIO if the device is not a System Monitor channel
+ *
+ */
+py_int analog_stream_start(analog dev_id, unsigned int rate);
+
+/* Capture the samples that are due on every running stream
+ *
+ * Parameters
+ * ----------
+ *     None
+ *
+ * Returns
+ * -------
+ *     Number of samples captured
+ *
+ */
+py_int analog_stream_poll(void);
+
+/* Sample until a stream has buffered a number of samples or a timeout
+ * expires
+ *
+ * Parameters
+ * ----------
+ * count: int
+ *     Samples to wait for, limited to ANALOG_STREAM_DEPTH
+ * timeout_us: unsigned int
+ *     Longest wait in microseconds
+ *
+ * Returns
+ * -------
+ *     Number of samples buffered, fewer than count if the timeout expired
+ *     or the stream was stopped
+ *     -EINVAL if the device is not streaming
+ *
+ */
+py_int analog_stream_wait(analog dev_id, int count, unsigned int timeout_us);
+
+/* Move buffered samples of a stream out of its ring buffer
+ *
+ * Samples are returned oldest first as 16-bit System Monitor values.
+ *
+ * Parameters
+ * ----------
+ * samples: unsigned short*
+ *     Destination of the samples
+ * count: int
+ *     Largest number of samples to return
+ *
+ * Returns
+ * -------
+ *     Number of samples returned
+ *     -EINVAL if the device is not streaming
+ *
+ */
+py_int analog_stream_read(analog dev_id, unsigned short *samples, int count);
+
+/* Number of samples lost because the ring buffer of a stream was full
+ *
+ * Parameters
+ * ----------
+ *     None
+ *
+ * Returns
+ * -------
+ *     Samples dropped since the stream was started
+ *     -EINVAL if the device is not streaming
+ *
+ */
+py_int analog_stream_dropped(analog dev_id);
+
+/* Stop sampling a channel and discard its buffered samples
+ *
+ * Parameters
+ * ----------
+ *     None
+ *
+ * Returns
+ * -------
+ *     None
+ *
+ */
+py_void analog_stream_stop(analog dev_id);
@@ -43,11 +43,98 @@ static int sysmon_init = 0;
 
 #include <analog.h>
 #include <grove_adc.h>
+#define GROVE_INTERFACES_INTERNAL
+#include <grove_interfaces.h>
+#include <grove_sched.h>
 
 #define XADC_TYPE 0l
 #define GROVE_ADC_TYPE (1l << 24)
 #define TYPE_MASK 0xF000000
 
+#define XADC_CHANNELS 16
+
+/* Conversion of a handle, resolved when the device is opened */
+struct analog_desc {
+    unsigned short reference;   // reference voltage in mV, 0 if not open
+    unsigned short samples;     // conversions averaged per reading
+    unsigned int scale;         // mV per raw count in 16.16 fixed point
+};
+
+static struct analog_desc descs[XADC_CHANNELS + GROVE_ADC_INSTANCES];
+
+static struct analog_desc *desc_find(analog dev_id) {
+    unsigned int index = dev_id & ~TYPE_MASK;
+    if ((dev_id & TYPE_MASK) == GROVE_ADC_TYPE) index += XADC_CHANNELS;
+    else if ((dev_id & TYPE_MASK) != XADC_TYPE || index >= XADC_CHANNELS)
+        return 0;
+    if (dev_id < 0 || index >= XADC_CHANNELS + GROVE_ADC_INSTANCES) return 0;
+    return &descs[index];
+}
+
+static void desc_init(analog dev_id) {
+    struct analog_desc *d = desc_find(dev_id);
+    if (!d) return;
+    d->reference = (unsigned short)(analog_get_reference(dev_id) * 1000 + 0.5f);
+    d->scale = ((unsigned int)d->reference << 16) / analog_get_max(dev_id);
+    if (!d->samples) d->samples = 1;
+}
+
+/* Boxcar average of consecutive conversions of a Grove ADC */
+static py_int adc_get_raw(analog dev_id) {
+    struct analog_desc *d = desc_find(dev_id);
+    unsigned int samples = d && d->samples ? d->samples : 1;
+    unsigned int sum = 0;
+    for (unsigned int i = 0; i < samples; i++) {
+        py_int raw = grove_adc_read_raw(dev_id ^ GROVE_ADC_TYPE);
+        if (raw < 0) return raw;
+        sum += raw;
+    }
+    return (sum + samples / 2) / samples;
+}
+
+#ifdef XPAR_SYSMON_0_DEVICE_ID
+static py_int xadc_get_raw(unsigned int channel) {
+    while ((XSysMon_GetStatus(SysMonInstPtr) &
+                    XSM_SR_EOS_MASK) != XSM_SR_EOS_MASK);
+    return XSysMon_GetAdcData(SysMonInstPtr, XSM_CH_AUX_MIN + channel);
+}
+#endif
+
+#ifdef XPAR_SYSMON_0_DEVICE_ID
+struct analog_stream {
+    analog dev_id;
+    unsigned int period;    // timer cycles between samples, 0 if unused
+    unsigned int next;      // timer count the next sample is due at
+    unsigned int head;
+    unsigned int count;
+    unsigned int dropped;
+    unsigned short samples[ANALOG_STREAM_DEPTH];
+};
+
+static struct analog_stream streams[ANALOG_STREAMS];
+static int stream_task = -1;
+
+// Captures due samples on every pass of the scheduler
+static unsigned long long stream_run(void *arg, unsigned long long now) {
+    for (int i = 0; i < ANALOG_STREAMS; i++) {
+        if (streams[i].period) {
+            analog_stream_poll();
+            return now;
+        }
+    }
+    stream_task = -1;
+    return GROVE_SCHED_DONE;
+}
+
+static struct analog_stream *stream_find(analog dev_id) {
+    for (int i = 0; i < ANALOG_STREAMS; i++) {
+        if (streams[i].period && streams[i].dev_id == dev_id)
+            return &streams[i];
+    }
+    return 0;
+}
+#endif
+
 analog analog_open_xadc(int pin_id) {
 #ifdef XPAR_SYSMON_0_DEVICE_ID
     if (!sysmon_init) {
@@ -57,6 +144,7 @@ analog analog_open_xadc(int pin_id) {
         XSysMon_GetStatus(SysMonInstPtr);
         sysmon_init = 1;
     }
+    desc_init(pin_id);
     return pin_id;
 #else
     return -ENXIO;
@@ -64,6 +152,7 @@ analog analog_open_xadc(int pin_id) {
 }
 
 analog analog_open_grove_adc(grove_adc adc) {
+    desc_init(GROVE_ADC_TYPE | adc);
     return GROVE_ADC_TYPE | adc; 
 }
 
@@ -80,19 +169,124 @@ py_int analog_get_raw(analog dev_id) {
     switch (dev_id & TYPE_MASK) {
     case XADC_TYPE:
 #ifdef XPAR_SYSMON_0_DEVICE_ID
-        while ((XSysMon_GetStatus(SysMonInstPtr) &
-                        XSM_SR_EOS_MASK) != XSM_SR_EOS_MASK);
-        return XSysMon_GetAdcData(SysMonInstPtr, XSM_CH_AUX_MIN+dev_id);
+        return xadc_get_raw(dev_id);
 #else
         return -ENXIO;
 #endif
 
     case GROVE_ADC_TYPE:
-        return grove_adc_read_raw(dev_id ^ GROVE_ADC_TYPE);
+        return adc_get_raw(dev_id);
     }
     return PY_SUCCESS;
 }
 
+py_int analog_get_millivolts(analog dev_id) {
+    struct analog_desc *d = desc_find(dev_id);
+    py_int raw;
+    if (!d || !d->reference) return -ENXIO;
+    if ((dev_id & TYPE_MASK) == XADC_TYPE) {
+#ifdef XPAR_SYSMON_0_DEVICE_ID
+        raw = xadc_get_raw(dev_id);
+#else
+        return -ENXIO;
+#endif
+    } else {
+        raw = adc_get_raw(dev_id);
+        if (raw < 0) return raw;
+    }
+    return ((unsigned int)raw * d->scale + 0x8000) >> 16;
+}
+
+py_int analog_get_reference_millivolts(analog dev_id) {
+    struct analog_desc *d = desc_find(dev_id);
+    if (!d || !d->reference) return -ENXIO;
+    return d->reference;
+}
+
+py_int analog_set_averaging(analog dev_id, int samples) {
+    struct analog_desc *d = desc_find(dev_id);
+    if (!d || !d->reference) return -ENXIO;
+    if ((dev_id & TYPE_MASK) == GROVE_ADC_TYPE) {
+        if (samples < 1 || samples > ANALOG_AVERAGE_MAX) return -EINVAL;
+        d->samples = samples;
+        return PY_SUCCESS;
+    }
+#ifdef XPAR_SYSMON_0_DEVICE_ID
+    u8 average;
+    switch (samples) {
+    case 1:
+        average = XSM_AVG_0_SAMPLES;
+        break;
+    case 16:
+        average = XSM_AVG_16_SAMPLES;
+        break;
+    case 64:
+        average = XSM_AVG_64_SAMPLES;
+        break;
+    case 256:
+        average = XSM_AVG_256_SAMPLES;
+        break;
+    default:
+        return -EINVAL;
+    }
+    // The System Monitor has one averaging setting for all channels
+    for (int i = 0; samples > 1 && i < XADC_CHANNELS; i++) {
+        if (i != dev_id && descs[i].samples > 1 && descs[i].samples != samples)
+            return -EBUSY;
+    }
+    u32 enables = XSysMon_GetSeqAvgEnables(SysMonInstPtr);
+    u32 channel = XSM_SEQ_CH_AUX00 << dev_id;
+    u32 wanted = samples > 1 ? enables | channel : enables & ~channel;
+    if (samples > 1) XSysMon_SetAvg(SysMonInstPtr, average);
+    if (wanted != enables) {
+        // The sequence can only be changed in safe mode
+        u8 mode = XSysMon_GetSequencerMode(SysMonInstPtr);
+        XSysMon_SetSequencerMode(SysMonInstPtr, XSM_SEQ_MODE_SAFE);
+        XSysMon_SetSeqAvgEnables(SysMonInstPtr, wanted);
+        XSysMon_SetSequencerMode(SysMonInstPtr, mode);
+    }
+    d->samples = samples;
+    return PY_SUCCESS;
+#else
+    return -ENXIO;
+#endif
+}
+
+py_int analog_get_averaging(analog dev_id) {
+    struct analog_desc *d = desc_find(dev_id);
+    if (!d || !d->reference) return -ENXIO;
+    return d->samples;
+}
+
+py_int analog_get_raw_multi(const analog *devs, int n, py_int *out) {
+    py_int ret = PY_SUCCESS;
+#ifdef XPAR_SYSMON_0_DEVICE_ID
+    int waited = 0;
+#endif
+    for (int i = 0; i < n; i++) {
+        switch (devs[i] & TYPE_MASK) {
+        case XADC_TYPE:
+#ifdef XPAR_SYSMON_0_DEVICE_ID
+            if (!waited) {
+                while ((XSysMon_GetStatus(SysMonInstPtr) &
+                                XSM_SR_EOS_MASK) != XSM_SR_EOS_MASK);
+                waited = 1;
+            }
+            out[i] = XSysMon_GetAdcData(SysMonInstPtr,
+                                        XSM_CH_AUX_MIN + devs[i]);
+#else
+            out[i] = -ENXIO;
+#endif
+            break;
+        default:
+            out[i] = analog_get_raw(devs[i]);
+            break;
+        }
+        if (out[i] < 0) ret = -EIO;
+    }
+    return ret;
+}
+
 py_float analog_get_reference(analog dev_id) {
     switch (dev_id & TYPE_MASK) {
     case XADC_TYPE:
@@ -113,3 +307,111 @@ py_int analog_get_max(analog dev_id) {
     return -ENXIO;
 }
 
+
+py_int analog_stream_start(analog dev_id, unsigned int rate) {
+#ifdef XPAR_SYSMON_0_DEVICE_ID
+    if ((dev_id & TYPE_MASK) != XADC_TYPE || dev_id > 15 || !sysmon_init)
+        return -ENXIO;
+    if (rate == 0 || rate > ANALOG_STREAM_RATE_MAX) return -EINVAL;
+    struct analog_stream *s = stream_find(dev_id);
+    for (int i = 0; !s && i < ANALOG_STREAMS; i++) {
+        if (!streams[i].period) s = &streams[i];
+    }
+    if (!s) return -ENOMEM;
+
+    u32 channels = XSysMon_GetSeqChEnables(SysMonInstPtr);
+    u32 channel = XSM_SEQ_CH_AUX00 << dev_id;
+    if (!(channels & channel)) {
+        // The sequence can only be changed in safe mode
+        XSysMon_SetSequencerMode(SysMonInstPtr, XSM_SEQ_MODE_SAFE);
+        XSysMon_SetSeqChEnables(SysMonInstPtr, channels | channel);
+        XSysMon_SetSequencerMode(SysMonInstPtr, XSM_SEQ_MODE_CONTINPASS);
+    }
+    s->dev_id = dev_id;
+    s->period = XPAR_TMRCTR_0_CLOCK_FREQ_HZ / rate;
+    s->next = grove_timer_cycles();
+    s->head = 0;
+    s->count = 0;
+    s->dropped = 0;
+    if (stream_task < 0) stream_task = grove_sched_add(stream_run, 0, 0);
+    return PY_SUCCESS;
+#else
+    return -ENXIO;
+#endif
+}
+
+py_int analog_stream_poll(void) {
+    int captured = 0;
+#ifdef XPAR_SYSMON_0_DEVICE_ID
+    unsigned int now = grove_timer_cycles();
+    for (int i = 0; i < ANALOG_STREAMS; i++) {
+        struct analog_stream *s = &streams[i];
+        if (!s->period || (int)(now - s->next) < 0) continue;
+        s->next += s->period;
+        // Samples missed while nobody polled are not made up for
+        if ((int)(now - s->next) >= 0) s->next = now + s->period;
+        if (s->count == ANALOG_STREAM_DEPTH) {
+            s->dropped++;
+            continue;
+        }
+        s->samples[(s->head + s->count) & (ANALOG_STREAM_DEPTH - 1)] =
+            XSysMon_GetAdcData(SysMonInstPtr, XSM_CH_AUX_MIN + s->dev_id);
+        s->count++;
+        captured++;
+    }
+#endif
+    return captured;
+}
+
+py_int analog_stream_wait(analog dev_id, int count, unsigned int timeout_us) {
+#ifdef XPAR_SYSMON_0_DEVICE_ID
+    struct analog_stream *s = stream_find(dev_id);
+    if (!s) return -EINVAL;
+    unsigned long long deadline = grove_time_us() + timeout_us;
+    if (count > ANALOG_STREAM_DEPTH) count = ANALOG_STREAM_DEPTH;
+    while ((int)s->count < count && s->period &&
+           grove_time_us() < deadline) {
+        analog_stream_poll();
+        grove_sched_run();
+    }
+    return s->count;
+#else
+    return -EINVAL;
+#endif
+}
+
+py_int analog_stream_read(analog dev_id, unsigned short *samples, int count) {
+#ifdef XPAR_SYSMON_0_DEVICE_ID
+    struct analog_stream *s = stream_find(dev_id);
+    if (!s) return -EINVAL;
+    analog_stream_poll();
+    if (count < 0) count = 0;
+    if ((unsigned int)count > s->count) count = s->count;
+    for (int i = 0; i < count; i++) {
+        samples[i] = s->samples[s->head];
+        s->head = (s->head + 1) & (ANALOG_STREAM_DEPTH - 1);
+    }
+    s->count -= count;
+    return count;
+#else
+    return -EINVAL;
+#endif
+}
+
+py_int analog_stream_dropped(analog dev_id) {
+#ifdef XPAR_SYSMON_0_DEVICE_ID
+    struct analog_stream *s = stream_find(dev_id);
+    if (!s) return -EINVAL;
+    return s->dropped;
+#else
+    return -EINVAL;
+#endif
+}
+
+py_void analog_stream_stop(analog dev_id) {
+#ifdef XPAR_SYSMON_0_DEVICE_ID
+    struct analog_stream *s = stream_find(dev_id);
+    if (s) s->period = 0;
+#endif
+    return PY_SUCCESS;
+}
@@ -59,6 +59,7 @@ typedef py_int geared_motor;
  * -------
  * geared_motor
  *     The device object  
+ *     -EBUSY if no PWM channel of the IOP is free
  * 
  */
 geared_motor geared_motor_open(int grove_id);
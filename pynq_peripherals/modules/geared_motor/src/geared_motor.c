@@ -31,10 +31,13 @@
  *****************************************************************************/
 
 #include <grove_interfaces.h>
+#include <grove_pool.h>
 #include <geared_motor.h>
 #include <gpio.h>
 
-#define DEVICE_MAX 4
+#ifndef GEARED_MOTOR_INSTANCES
+#define GEARED_MOTOR_INSTANCES 4
+#endif
 #define PERIOD 2000000
 #define DUTY_MAX 1999999
 #define DUTY_MIN 20000
@@ -45,7 +48,8 @@ struct info {
     int count;
 };
 
-static struct info info[DEVICE_MAX];
+static struct info info[GEARED_MOTOR_INSTANCES];
+GROVE_POOL(pool, GEARED_MOTOR_INSTANCES);
 
 /*
  * Documentation for public functions is provided as part of the external 
@@ -67,16 +71,18 @@ static struct info info[DEVICE_MAX];
  * 
  */
 static int next_index() {
-    for (int i = 0; i < DEVICE_MAX; ++i) {
-        if (info[i].count == 0) return i;
-    }
-    return -ENOMEM;
+    return grove_pool_alloc(&pool);
 }
 geared_motor geared_motor_open(int grove_id) {
     geared_motor dev_id = next_index();
     if (dev_id >= 0) {
         info[dev_id].count++;
         info[dev_id].motor_pin = timer_open_grove_b(grove_id);
+        if (info[dev_id].motor_pin < 0) {
+            info[dev_id].count--;
+            grove_pool_free(&pool, dev_id);
+            return info[dev_id].motor_pin;
+        }
         info[dev_id].dir_pin = gpio_open_grove_a(grove_id);
         timer_pwm_generate(info[dev_id].motor_pin, PERIOD, 0);
         gpio_set_direction(info[dev_id].dir_pin, GPIO_OUT);
@@ -92,6 +98,7 @@ void geared_motor_close(geared_motor p) {
     timer_pwm_stop(motor_pin);
     timer_close(motor_pin);
     gpio_close(dir_pin);
+    grove_pool_free(&pool, p);
 }
 
 py_void geared_motor_set_speed(geared_motor p, int value) {
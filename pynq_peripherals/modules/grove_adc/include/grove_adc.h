@@ -46,6 +46,11 @@
  */
 typedef py_int grove_adc;
 
+/* Number of ADC modules that can be open at the same time */
+#ifndef GROVE_ADC_INSTANCES
+#define GROVE_ADC_INSTANCES 4
+#endif
+
 // Device lifetime functions
 /* Open an ADC module connected to the specified port with the default 
  * I2C address
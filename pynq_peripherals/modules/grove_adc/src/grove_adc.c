@@ -31,6 +31,7 @@
  *****************************************************************************/
 
 #include <grove_interfaces.h>
+#include <grove_pool.h>
 #include <grove_adc.h>
 #include <math.h>
 
@@ -71,10 +72,7 @@ static int read_adc(i2c device, u8 address, u8 reg){
     u32 sample;
     u8 num_bytes;
 
-    data_buffer[0] = reg; // Set the address pointer register
-    if(i2c_write(device, address, data_buffer, 1) != 1) return -EIO;
-
-    if(i2c_read(device, address, data_buffer, 2) != 2) return -EIO;
+    if(i2c_read_reg(device, address, reg, data_buffer, 2) != 2) return -EIO;
     sample = ((data_buffer[0]&0x0f) << 8) | data_buffer[1];
     return sample;
 }
@@ -115,7 +113,7 @@ static int write_adc(i2c device, u8 address, u8 reg, u32 data, u8 bytes){
 }
 
 #define I2C_ADDRESS 0x50
-#define DEVICE_MAX 4
+#define I2C_MAX_HZ GROVE_I2C_FAST_HZ // ADC121C021 fast mode
 
 struct info {
     i2c i2c_dev;
@@ -123,7 +121,8 @@ struct info {
     int count;
 };
 
-static struct info info[DEVICE_MAX];
+static struct info info[GROVE_ADC_INSTANCES];
+GROVE_POOL(pool, GROVE_ADC_INSTANCES);
 
 /* Get next instance space
  * 
@@ -138,10 +137,7 @@ static struct info info[DEVICE_MAX];
  * 
  */
 static int next_index() {
-    for (int i = 0; i < DEVICE_MAX; ++i) {
-        if (info[i].count == 0) return i;
-    }
-    return -ENOMEM; 
+    return grove_pool_alloc(&pool);
 }
 
 grove_adc grove_adc_open(int grove_id) {
@@ -152,10 +148,11 @@ grove_adc grove_adc_open_at_address(int grove_id, int address) {
     grove_adc dev_id = next_index();
     if (dev_id >=0 ) {
         info[dev_id].count++;
-        info[dev_id].i2c_dev = i2c_open_grove(grove_id);
+        info[dev_id].i2c_dev = i2c_open_grove_speed(grove_id, I2C_MAX_HZ);
         info[dev_id].address = address;
         if(write_adc(info[dev_id].i2c_dev,info[dev_id].address, REG_ADDR_CONFIG,0x20,1) == -EIO){
             info[dev_id].count--;
+            grove_pool_free(&pool, dev_id);
             i2c_close(info[dev_id].i2c_dev);
             return -EIO;
         } 
@@ -167,6 +164,7 @@ void grove_adc_close(grove_adc adc) {
     if (--info[adc].count != 0) return;
     i2c i2c_dev = info[adc].i2c_dev;
     i2c_close(i2c_dev);
+    grove_pool_free(&pool, adc);
 }
 
 py_int grove_adc_read_raw(grove_adc adc) {
@@ -44,6 +44,7 @@
  *    open, open_at_address,close,configure,
  *    start_conversion, set oversample rate, set mode, read temperature raw value
  *    read pressure raw value, read temerature, read pressure, read registers
+ *    start measurement, poll measurement, measured temperature and pressure
  *    
  */
 typedef py_int grove_barometer;
@@ -258,6 +259,68 @@ py_float grove_barometer_temperature(grove_barometer p);
  */
 py_float grove_barometer_pressure(grove_barometer p);
 
+/* Start a temperature and pressure measurement without waiting for it
+ *
+ * The pressure conversion is started from the scheduler once the
+ * temperature conversion is done, whenever this or another driver polls,
+ * so other sensors can convert in the meantime.
+ * 
+ * Parameters
+ * ----------
+ *     None
+ * 
+ * Returns
+ * -------
+ *     0 if the measurement was started
+ *     -EBUSY if a measurement is already in flight
+ *     -ENOMEM if the scheduler has no free task
+ *     -EIO if the conversion could not be started
+ *
+ */
+py_int grove_barometer_start_measurement(grove_barometer p);
+
+/* Check whether a measurement started with start_measurement is done
+ * 
+ * Parameters
+ * ----------
+ *     None
+ * 
+ * Returns
+ * -------
+ *     GROVE_PENDING while the measurement is in flight
+ *     0 once its values can be read with measured_temperature and
+ *     measured_pressure
+ *     -EIO if the pressure conversion could not be started
+ *
+ */
+py_int grove_barometer_poll_measurement(grove_barometer p);
+
+/* Temperature of the last completed measurement
+ * 
+ * Parameters
+ * ----------
+ *     None
+ * 
+ * Returns
+ * -------
+ *     converted temperature value : float
+ *
+ */
+py_float grove_barometer_measured_temperature(grove_barometer p);
+
+/* Pressure of the last completed measurement
+ * 
+ * Parameters
+ * ----------
+ *     None
+ * 
+ * Returns
+ * -------
+ *     converted pressure value : float
+ *
+ */
+py_float grove_barometer_measured_pressure(grove_barometer p);
+
 /* Read mesurement fifo empty status from grove barometer sensor
  * 
  * Parameters
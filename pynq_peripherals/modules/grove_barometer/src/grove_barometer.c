@@ -36,17 +36,42 @@
 #include <stdbool.h>
 #include "timer.h"
 #include <grove_interfaces.h>
+#include <grove_pool.h>
+#include <grove_regcache.h>
+#include <grove_sched.h>
 #include <grove_barometer.h>
 #include <grove_barometer_hw.h>
 
 #define I2C_ADDRESS 0x77
-#define DEVICE_MAX 4
+#define I2C_MAX_HZ GROVE_I2C_FAST_HZ // DPS310 fast mode
+#ifndef GROVE_BAROMETER_INSTANCES
+#define GROVE_BAROMETER_INSTANCES 4
+#endif
+
+/* Conversion a measurement in flight waits for */
+enum bps_stage {
+    BPS_IDLE,
+    BPS_TEMPERATURE,
+    BPS_PRESSURE,
+};
 
 struct grove_barometer_info {
     i2c i2c_dev;
     unsigned char address;
     py_int data;
     py_int count;
+    struct grove_regcache regs;
+    int task;               // scheduler task of a measurement, -1 if none
+    enum bps_stage stage;
+    py_int status;          // result of the last measurement
+    int raw_temp, raw_press;
+};
+
+/* Result, status and command registers are never cached */
+static const struct grove_regrange bps_uncached[] = {
+    {BPS_REG_PRS_BASE, BPS_REG_TMP_BASE + 2},
+    {BPS_REG_MEASCFG, BPS_REG_MEASCFG},
+    {BPS_REG_CFGREG + 1, BPS_REG_RESET},
 };
 
 static py_int coeffs[BPS_COEFFICIENT_COUNT-2];
@@ -131,23 +156,25 @@ typedef enum {
 
 static barometer_config_t bps = {BPS_OSR_128, BPS_OSR_128, BPS_MR_128, BPS_MR_128, BPS_MODE_STANDBY};
 
-static struct grove_barometer_info info[DEVICE_MAX];
+static struct grove_barometer_info info[GROVE_BAROMETER_INSTANCES];
+GROVE_POOL(pool, GROVE_BAROMETER_INSTANCES);
 
 static py_int bps_write(grove_barometer p, unsigned char addr, unsigned char value) {
 
-    i2c i2c_dev = info[p].i2c_dev;
-    unsigned char temp[2];
-    temp[0] = addr;
-    temp[1] = value;
-    if(i2c_write(i2c_dev, info[p].address, temp, 2) != 2) return -EIO;
+    if(grove_regcache_write(&info[p].regs, addr, value)) return -EIO;
     else return 0;
 }
 
+static py_int bps_read_cached(grove_barometer p, unsigned char addr, unsigned char *value) {
+
+    if(grove_regcache_read(&info[p].regs, addr, value)) return -EIO;
+    return 0;
+}
+
 static py_int bps_read(grove_barometer p, unsigned char addr, unsigned char length, unsigned char data[]) {
 
     i2c i2c_dev = info[p].i2c_dev;
-    if (i2c_write(i2c_dev, info[p].address, &addr, 1) != 1) return -EIO;
-    if (i2c_read(i2c_dev, info[p].address, data, length) != length) return -EIO;
+    if (i2c_read_reg(i2c_dev, info[p].address, addr, data, length) != length) return -EIO;
     return 0;
 }
 
@@ -173,10 +200,7 @@ static py_int bps_read_coeffs(grove_barometer p)
     if(bps_read(p, BPS_REG_MEASCFG, 1, &status)) return -EIO;
   }
 
-  for(i=0; i<BPS_COEFFICIENT_SIZE; i++)
-  {
-    if(bps_read(p, BPS_REG_COEFF_BASE+i, 1, coeff_buffer+i)) return -EIO;
-  }
+  if(bps_read(p, BPS_REG_COEFF_BASE, BPS_COEFFICIENT_SIZE, coeff_buffer)) return -EIO;
 
 
   coeff_temp_16 = ((py_int)coeff_buffer[0] << 4) | (((py_int)coeff_buffer[1] >> 4) & 0x0F);
@@ -243,18 +267,22 @@ py_float grove_barometer_calculate_temperature(grove_barometer p, int raw_temp,
 }
 
 static py_int grove_barometer_next_index() {
-    for (py_int i = 0; i < DEVICE_MAX; ++i) {
-        if (info[i].count == 0) return i;
-    }
-    return -1;
+    return grove_pool_alloc(&pool);
 }
 
 grove_barometer grove_barometer_open_at_address(py_int grove_id, py_int address) {
     grove_barometer dev_id = grove_barometer_next_index();
+    if (dev_id == -ENOMEM)
+        return -ENOMEM;
     info[dev_id].count++;
-    info[dev_id].i2c_dev = i2c_open_grove(grove_id);
+    info[dev_id].i2c_dev = i2c_open_grove_speed(grove_id, I2C_MAX_HZ);
     info[dev_id].address = address;
     info[dev_id].data = 0; // Static data initialisation
+    info[dev_id].task = -1;
+    info[dev_id].stage = BPS_IDLE;
+    info[dev_id].status = PY_SUCCESS;
+    grove_regcache_init(&info[dev_id].regs, info[dev_id].i2c_dev, address,
+                        bps_uncached, sizeof(bps_uncached) / sizeof(bps_uncached[0]));
     return dev_id;
 }
 
@@ -265,8 +293,12 @@ grove_barometer grove_barometer_open(py_int grove_id) {
 
 void grove_barometer_close(grove_barometer p) {
     if (--info[p].count != 0) return;
+    grove_sched_cancel(info[p].task);
+    info[p].task = -1;
+    info[p].stage = BPS_IDLE;
     i2c i2c_dev = info[p].i2c_dev;
     i2c_close(i2c_dev);
+    grove_pool_free(&pool, p);
 }
 
 py_void grove_barometer_pressure_oversample_rate(grove_barometer p, int value) {
@@ -308,14 +340,16 @@ py_int grove_barometer_fifo_full(grove_barometer p){
 
 py_int grove_barometer_enable_fifo(grove_barometer p, int value){
     unsigned char reg_value = 0;
-    if(bps_read(p, BPS_REG_CFGREG, 1, &reg_value)) return -EIO;
+    if(bps_read_cached(p, BPS_REG_CFGREG, &reg_value)) return -EIO;
     if(bps_write(p, BPS_REG_CFGREG, reg_value | ((value << 1) & 0x02))) return -EIO;
     return 0;
 }
 
 py_int grove_barometer_reset(grove_barometer p)
 {
-  return bps_write(p, BPS_REG_RESET, BPS_CMD_RESET);
+  py_int ret = bps_write(p, BPS_REG_RESET, BPS_CMD_RESET);
+  grove_regcache_invalidate(&info[p].regs);
+  return ret;
 }
 
 py_int grove_barometer_status(grove_barometer p)
@@ -355,10 +389,7 @@ py_int grove_barometer_pressure_raw(grove_barometer p)
   if(bps_read(p, BPS_REG_MEASCFG, 1, &i)) return -EIO;
 
   if(i & 0x10){
-    for(i=0; i<3; i++)
-      {
-        if(bps_read(p, BPS_REG_PRS_BASE+i, 1, result_buff+i)) return -EIO;
-      }
+      if(bps_read(p, BPS_REG_PRS_BASE, 3, result_buff)) return -EIO;
       result = ((unsigned py_int)result_buff[0]<<16) | ((unsigned py_int)result_buff[1]<<8) | result_buff[2];
       return result;
   }
@@ -374,10 +405,7 @@ py_int grove_barometer_temperature_raw(grove_barometer p)
   if(bps_read(p, BPS_REG_MEASCFG, 1, &i)) return 1;
 
   if(i & 0x20){
-    for(i=0; i<3; i++)
-      {
-        if(bps_read(p, BPS_REG_TMP_BASE+i, 1, result_buff+i)) return 2;
-      }
+      if(bps_read(p, BPS_REG_TMP_BASE, 3, result_buff)) return 2;
       result = ((py_int)result_buff[0]<<16) | ((py_int)result_buff[1]<<8) | result_buff[2];
       return result;
   }
@@ -385,51 +413,102 @@ py_int grove_barometer_temperature_raw(grove_barometer p)
   return -ENODATA;
 }
 
-py_float grove_barometer_temperature(grove_barometer p)
+/* Collect the conversion a measurement waited for and start the next one
+ *
+ * Parameters
+ * ----------
+ * arg: void*
+ *     Entry of the device in info
+ * now: unsigned long long
+ *     Current time in microseconds
+ *
+ * Returns
+ * -------
+ *     Time the next conversion is done, GROVE_SCHED_DONE after the last
+ *
+ */
+static unsigned long long measure_step(void *arg, unsigned long long now)
 {
-  int raw_temp, raw_press;
-  float press, temp;
+  struct grove_barometer_info *dev = (struct grove_barometer_info *)arg;
+  grove_barometer p = dev - info;
+
+  if (dev->stage == BPS_TEMPERATURE) {
+    dev->raw_temp = grove_barometer_temperature_raw(p);
+    if (grove_barometer_start_conversion(p, BAROMETER_PRESSURE) == 0) {
+      dev->stage = BPS_PRESSURE;
+      return now + bps_conversion_time[bps.psr_oversample_rate]*1000;
+    }
+    dev->status = -EIO;
+  } else {
+    dev->raw_press = grove_barometer_pressure_raw(p);
+    dev->status = PY_SUCCESS;
+  }
+  dev->stage = BPS_IDLE;
+  dev->task = -1;
+  return GROVE_SCHED_DONE;
+}
 
-  grove_barometer_start_conversion(p, BAROMETER_TEMPERATURE);
-  delay_us(bps_conversion_time[bps.tmp_oversample_rate]*1000);
-  raw_temp = grove_barometer_temperature_raw(p);
+py_int grove_barometer_start_measurement(grove_barometer p)
+{
+  if (info[p].stage != BPS_IDLE) return -EBUSY;
+  if (grove_barometer_start_conversion(p, BAROMETER_TEMPERATURE)) return -EIO;
+
+  int task = grove_sched_add(measure_step, &info[p], grove_time_us() +
+                             bps_conversion_time[bps.tmp_oversample_rate]*1000);
+  if (task < 0) return task;
+  info[p].task = task;
+  info[p].stage = BPS_TEMPERATURE;
+  return PY_SUCCESS;
+}
 
-  grove_barometer_start_conversion(p, BAROMETER_PRESSURE);
-  delay_us(bps_conversion_time[bps.psr_oversample_rate]*1000);
-  raw_press = grove_barometer_pressure_raw(p);
+py_int grove_barometer_poll_measurement(grove_barometer p)
+{
+  grove_sched_run();
+  if (info[p].stage != BPS_IDLE) return GROVE_PENDING;
+  return info[p].status;
+}
 
-  barometer_calculate(raw_temp, raw_press, &temp, &press);
-  return temp;
+py_float grove_barometer_measured_temperature(grove_barometer p)
+{
+  return grove_barometer_calculate_temperature(p, info[p].raw_temp, info[p].raw_press);
 }
 
-py_float grove_barometer_pressure(grove_barometer p)
+py_float grove_barometer_measured_pressure(grove_barometer p)
 {
-  int raw_temp, raw_press;
-  float press, temp;
+  return grove_barometer_calculate_pressure(p, info[p].raw_temp, info[p].raw_press);
+}
 
-  grove_barometer_start_conversion(p, BAROMETER_TEMPERATURE);
-  delay_us(bps_conversion_time[bps.tmp_oversample_rate]*1000);
-  raw_temp = grove_barometer_temperature_raw(p);
+static py_int barometer_measure(grove_barometer p)
+{
+  py_int ret = grove_barometer_start_measurement(p);
+  if (ret < 0) return ret;
+  while ((ret = grove_barometer_poll_measurement(p)) == GROVE_PENDING)
+    grove_sched_yield();
+  return ret;
+}
 
-  grove_barometer_start_conversion(p, BAROMETER_PRESSURE);
-  delay_us(bps_conversion_time[bps.psr_oversample_rate]*1000);
-  raw_press = grove_barometer_pressure_raw(p);
+py_float grove_barometer_temperature(grove_barometer p)
+{
+  py_int ret = barometer_measure(p);
+  if (ret < 0) return ret;
+  return grove_barometer_measured_temperature(p);
+}
 
-  barometer_calculate(raw_temp, raw_press, &temp, &press);
-  return press;
+py_float grove_barometer_pressure(grove_barometer p)
+{
+  py_int ret = barometer_measure(p);
+  if (ret < 0) return ret;
+  return grove_barometer_measured_pressure(p);
 }
 
 py_int grove_barometer_read_fifo(grove_barometer p)
 {
   unsigned char result_buff[3];
-  unsigned int i, result=0;
+  unsigned int result=0;
 
   if(grove_barometer_fifo_empty(p)) return -EPERM;
 
-  for(i=0; i<3; i++)
-    {
-      if(bps_read(p, BPS_REG_PRS_BASE+i, 1, result_buff+i)) return -EIO;
-    }
+    if(bps_read(p, BPS_REG_PRS_BASE, 3, result_buff)) return -EIO;
     result = ((unsigned py_int)result_buff[0]<<16) | ((unsigned py_int)result_buff[1]<<8) | result_buff[2];
     return result;
 
@@ -440,7 +519,6 @@ py_int grove_barometer_configure(grove_barometer p)
 {
     unsigned char reg_value, shift_value=0;
     int x = 0;
-    i2c i2c_dev = info[p].i2c_dev;
 
     if(grove_barometer_reset(p)) return 1;
     delay_us(5000);
@@ -448,41 +526,41 @@ py_int grove_barometer_configure(grove_barometer p)
     if(x) return x;
 
 
-    if(bps_read(p, BPS_REG_PRSCFG, 1, &reg_value)) return 2;
+    if(bps_read_cached(p, BPS_REG_PRSCFG, &reg_value)) return 2;
     if(bps_write(p, BPS_REG_PRSCFG, reg_value | bps.psr_oversample_rate)) return 3;
 
-    if(bps_read(p, BPS_REG_TMPSRC, 1, &reg_value)) return 4;
+    if(bps_read_cached(p, BPS_REG_TMPSRC, &reg_value)) return 4;
     if(reg_value & 0x80) {
       reg_value = 0x80;
     }
     if(bps_write(p, BPS_REG_TMPCFG, reg_value | bps.tmp_oversample_rate)) return 5;
 
 
-    if(bps_read(p, BPS_REG_CFGREG, 1, &reg_value)) return 6;
+    if(bps_read_cached(p, BPS_REG_CFGREG, &reg_value)) return 6;
     if(bps.tmp_oversample_rate > BPS_OSR_8) {
       shift_value = BPS_CMD_T_SHIFT;
     }
     if(bps_write(p, BPS_REG_CFGREG, reg_value | shift_value)) return 7;
 
-    if(bps_read(p, BPS_REG_CFGREG, 1, &reg_value)) return 8;
+    if(bps_read_cached(p, BPS_REG_CFGREG, &reg_value)) return 8;
     if(bps.psr_oversample_rate > BPS_OSR_8) {
       shift_value = BPS_CMD_P_SHIFT;
     }
     if(bps_write(p, BPS_REG_CFGREG, reg_value | shift_value)) return 9;
 
 
-    if(bps_read(p, BPS_REG_CFGREG, 1, &reg_value)) return 10;
+    if(bps_read_cached(p, BPS_REG_CFGREG, &reg_value)) return 10;
     if(bps_write(p, BPS_REG_CFGREG, reg_value | bps.mode)) return 11;
 
 
     if(bps.mode == BPS_MODE_CONTINUOUS_PSR || bps.mode == BPS_MODE_CONTINUOUS_PSR_TMP) {
-        if(bps_read(p, BPS_REG_PRSCFG, 1, &reg_value)) return 15;
+        if(bps_read_cached(p, BPS_REG_PRSCFG, &reg_value)) return 15;
         if(bps_write(p, BPS_REG_PRSCFG, reg_value | (bps.psr_measurement_rate << 4))) return 12;
     }
 
 
     if(bps.mode == BPS_MODE_CONTINUOUS_TMP || bps.mode == BPS_MODE_CONTINUOUS_PSR_TMP) {
-        if(bps_read(p, BPS_REG_TMPCFG, 1, &reg_value)) return 16;
+        if(bps_read_cached(p, BPS_REG_TMPCFG, &reg_value)) return 16;
         if(bps_write(p, BPS_REG_TMPCFG, reg_value | (bps.tmp_measurement_rate << 4))) return 13;
     }
 
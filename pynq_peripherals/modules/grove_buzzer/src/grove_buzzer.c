@@ -31,18 +31,22 @@
  *****************************************************************************/
 
 #include <grove_interfaces.h>
+#include <grove_pool.h>
 #include <grove_buzzer.h>
 #include <timer.h>
 #include <gpio.h>
 
-#define DEVICE_MAX 4
+#ifndef GROVE_BUZZER_INSTANCES
+#define GROVE_BUZZER_INSTANCES 4
+#endif
 
 struct info {
     gpio pin;
     int count;
 };
 
-static struct info info[DEVICE_MAX];
+static struct info info[GROVE_BUZZER_INSTANCES];
+GROVE_POOL(pool, GROVE_BUZZER_INSTANCES);
 
 /*
  * Documentation for public functions is provided as part of the external 
@@ -64,10 +68,7 @@ static struct info info[DEVICE_MAX];
  * 
  */
 static int next_index() {
-    for (int i = 0; i < DEVICE_MAX; ++i) {
-        if (info[i].count == 0) return i;
-    }
-    return -ENOMEM;
+    return grove_pool_alloc(&pool);
 }
 
 grove_buzzer grove_buzzer_open(int grove_id) {
@@ -84,6 +85,7 @@ void grove_buzzer_close(grove_buzzer buzzer) {
     if (--info[buzzer].count != 0) return;
     gpio pin = info[buzzer].pin;
     gpio_close(pin);
+    grove_pool_free(&pool, buzzer);
 }
 
 py_void grove_buzzer_play_tone(grove_buzzer buzzer, int tone, int duration) {
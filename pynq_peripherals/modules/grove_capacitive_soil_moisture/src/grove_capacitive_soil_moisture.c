@@ -31,18 +31,22 @@
  *****************************************************************************/
 
 #include <grove_interfaces.h>
+#include <grove_pool.h>
 #include <grove_capacitive_soil_moisture.h>
 #include <grove_adc.h>
 #include "grove_constants.h"
 
-#define DEVICE_MAX 4
+#ifndef GROVE_CAPACITIVE_SOIL_MOISTURE_INSTANCES
+#define GROVE_CAPACITIVE_SOIL_MOISTURE_INSTANCES 4
+#endif
 
 struct info {
     analog pin;
     int count;
 };
 
-static struct info info[DEVICE_MAX];
+static struct info info[GROVE_CAPACITIVE_SOIL_MOISTURE_INSTANCES];
+GROVE_POOL(pool, GROVE_CAPACITIVE_SOIL_MOISTURE_INSTANCES);
 
 float voltage_dry = 61.66;
 float voltage_wet = 72.47;
@@ -67,10 +71,7 @@ float voltage_wet = 72.47;
  * 
  */
 static int next_index() {
-    for (int i = 0; i < DEVICE_MAX; ++i) {
-        if (info[i].count == 0) return i;
-    }
-    return -ENOMEM;
+    return grove_pool_alloc(&pool);
 }
 
 static grove_capacitive_soil_moisture grove_capacitive_soil_moisture_open_analog(analog pin) {
@@ -97,11 +98,15 @@ void grove_capacitive_soil_moisture_close(grove_capacitive_soil_moisture moistur
     if (--info[moisture].count != 0) return;
     analog pin = info[moisture].pin;
     analog_close(pin);
+    grove_pool_free(&pool, moisture);
 }
 
 py_float grove_capacitive_soil_moisture_get_moisture(grove_capacitive_soil_moisture moisture) {
     analog pin = info[moisture].pin;
-    float voltage = 100 - (float)analog_get_voltage(pin) * 100.0 / (float)analog_get_reference(pin);
+    // Percentage of the reference voltage in hundredths
+    int level = analog_get_millivolts(pin) * 10000 /
+                analog_get_reference_millivolts(pin);
+    float voltage = 100 - level * 0.01f;
     float humidity = 100/(voltage_wet - voltage_dry)*(voltage - voltage_dry);
     humidity = (humidity < 0) ? 0 : humidity;
     humidity = (humidity > 100) ? 100 : humidity;
@@ -39,13 +39,21 @@
 /* grove_envsensor class 
  *
  * Available Methods:
- *    open, open_at_address,close,init,
+ *    open, open_at_address,close,init,configure,
  *    reg_write, read_data, read_temperature, read_pressure
- *    read_humidity
+ *    read_humidity, read_all, measured temperature, pressure, humidity
+ *    and gas
  *    
  */
 typedef int grove_envsensor;
 
+// Order of the values filled in by grove_envsensor_read_all
+#define GROVE_ENVSENSOR_TEMPERATURE 0
+#define GROVE_ENVSENSOR_PRESSURE 1
+#define GROVE_ENVSENSOR_HUMIDITY 2
+#define GROVE_ENVSENSOR_GAS 3
+#define GROVE_ENVSENSOR_VALUES 4
+
 // Device lifetime functions
 /* Open a grove environment sensor device connected to the specified port 
  * 
@@ -118,6 +126,39 @@ void grove_envsensor_close(grove_envsensor p);
  */
 py_int grove_envsensor_reg_write(grove_envsensor p, unsigned char addr, unsigned char val);
 
+/* Program oversampling and heater settings for later measurements
+ *
+ * The settings are written once; each measurement after that is a single
+ * write of the mode register plus the data read. Devices that are never
+ * configured use 2x temperature, 16x pressure and 1x humidity
+ * oversampling with the heater at 300 degrees C for 100 ms. init resets
+ * the chip, so configure again after it.
+ * 
+ * Parameters
+ * ----------
+ *     os_t: int
+ *     Temperature oversampling: 0 (skipped), 1, 2, 4, 8 or 16
+ *     os_p: int
+ *     Pressure oversampling: 0 (skipped), 1, 2, 4, 8 or 16
+ *     os_h: int
+ *     Humidity oversampling: 0 (skipped), 1, 2, 4, 8 or 16
+ *     heater_temp: int
+ *     Heater target temperature in degrees C, 200 to 400
+ *     heater_ms: int
+ *     Heater duration in milliseconds, below 4032, 0 to skip the gas
+ *     measurement
+ * 
+ * Returns
+ * -------
+ *     0 on success
+ *     -EINVAL if a setting is out of range
+ *     -EBUSY if a measurement of this sensor is in flight
+ *     -EIO if the settings could not be written
+ *
+ */
+py_int grove_envsensor_configure(grove_envsensor p, int os_t, int os_p,
+                                 int os_h, int heater_temp, int heater_ms);
+
 /* Read all raw data from the sensor
  * 
  * Parameters
@@ -134,6 +175,43 @@ py_int grove_envsensor_reg_write(grove_envsensor p, unsigned char addr, unsigned
  */
 py_int grove_envsensor_read_data(grove_envsensor p);
 
+/* Trigger a measurement without waiting for it
+ *
+ * The wait for the conversion and heater runs from the scheduler whenever
+ * this or another driver polls, so other sensors can convert in the
+ * meantime. Each sensor keeps its own calibration and settings, so the
+ * conversions of several environmental sensors can overlap as well.
+ * 
+ * Parameters
+ * ----------
+ *     None
+ * 
+ * Returns
+ * -------
+ *     0 if the measurement was started
+ *     -EBUSY if a measurement of this sensor is already in flight
+ *     -ENOMEM if the scheduler has no free task
+ *     -EIO if the sensor could not be set up
+ *
+ */
+py_int grove_envsensor_start(grove_envsensor p);
+
+/* Check whether a measurement started with start is done
+ * 
+ * Parameters
+ * ----------
+ *     None
+ * 
+ * Returns
+ * -------
+ *     GROVE_PENDING while the measurement is in flight
+ *     0 once its values can be read with the measured_ functions
+ *     -ENODATA if the sensor never reported new data
+ *     -EIO if the sensor data could not be read
+ *
+ */
+py_int grove_envsensor_poll(grove_envsensor p);
+
 /* Read temperature value
  * 
  * Parameters
@@ -174,6 +252,86 @@ py_float grove_envsensor_read_pressure(grove_envsensor p);
 py_float grove_envsensor_read_humidity(grove_envsensor p);
 py_float grove_envsensor_read_gas(grove_envsensor p);
 
+/* Read temperature, pressure, humidity and gas from one measurement
+ *
+ * The read_ functions for a single value each run a full measurement,
+ * heater phase included, so this costs a quarter of reading the four
+ * values one by one.
+ * 
+ * Parameters
+ * ----------
+ *     values: float*
+ *     Array of GROVE_ENVSENSOR_VALUES floats that receives the temperature
+ *     in degrees C, the pressure in Pa, the relative humidity in % and the
+ *     gas resistance in ohms, in that order
+ * 
+ * Returns
+ * -------
+ *     0 = All values read
+ *     1 = Failed to setup sensor
+ *     2 = Failed to set sensor mode
+ *     3 = Failed to read sensor data
+ *
+ */
+py_int grove_envsensor_read_all(grove_envsensor p, float *values);
+
+/* Temperature of the last completed measurement
+ *
+ * Does not start a conversion. Values are 0 until the first measurement
+ * of the device completes.
+ * 
+ * Parameters
+ * ----------
+ *     None
+ * 
+ * Returns
+ * -------
+ *     temperature value: float
+ *
+ */
+py_float grove_envsensor_measured_temperature(grove_envsensor p);
+
+/* Pressure of the last completed measurement
+ * 
+ * Parameters
+ * ----------
+ *     None
+ * 
+ * Returns
+ * -------
+ *     pressure value: float
+ *
+ */
+py_float grove_envsensor_measured_pressure(grove_envsensor p);
+
+/* Humidity of the last completed measurement
+ * 
+ * Parameters
+ * ----------
+ *     None
+ * 
+ * Returns
+ * -------
+ *     humidity value: float
+ *
+ */
+py_float grove_envsensor_measured_humidity(grove_envsensor p);
+
+/* Gas resistance of the last completed measurement
+ *
+ * 0 if the heater had not reached a stable temperature.
+ * 
+ * Parameters
+ * ----------
+ *     None
+ * 
+ * Returns
+ * -------
+ *     gas resistance value: float
+ *
+ */
+py_float grove_envsensor_measured_gas(grove_envsensor p);
+
 /* Initilize grve environement sensor
  * 
  * Parameters
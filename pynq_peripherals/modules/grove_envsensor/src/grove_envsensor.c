@@ -40,17 +40,29 @@
 #include <grove_envsensor_hw.h>
 #include <grove_envsensor.h>
 #include <grove_interfaces.h>
+#include <grove_pool.h>
+#include <grove_regcache.h>
+#include <grove_sched.h>
 
 
 
 #define I2C_ADDRESS 0x77
-#define DEVICE_MAX 4
-
-struct grove_envsensor_info {
-    i2c i2c_dev;
-    unsigned char address;
-    int data;
-    int count;
+#define I2C_MAX_HZ GROVE_I2C_FAST_HZ // BME680 fast mode
+#define READY_POLL_US 500       // new_data polls once the profile is over
+#define READY_SLACK_US 10000    // extra time allowed beyond twice the profile
+#define SET_REGS_MAX (BME680_REG_BUFFER_LENGTH + 2) // settings and heater profile
+#ifndef GROVE_ENVSENSOR_INSTANCES
+#define GROVE_ENVSENSOR_INSTANCES 4
+#endif
+
+/* Measurement data, the mode/trigger and reset registers, and the ID and
+ * calibration bytes that are read once by bme680_init are never cached */
+static const struct grove_regrange bme680_uncached[] = {
+    {BME680_ADDR_RES_HEAT_VAL_ADDR, BME680_ADDR_RANGE_SW_ERR_ADDR},
+    {BME680_FIELD0_ADDR, BME680_FIELD0_ADDR + BME680_FIELD_LENGTH - 1},
+    {BME680_CONF_T_P_MODE_ADDR, BME680_CONF_T_P_MODE_ADDR},
+    {BME680_CHIP_ID_ADDR, BME680_CHIP_ID_ADDR},
+    {BME680_SOFT_RESET_ADDR, BME680_SOFT_RESET_ADDR},
 };
 
 
@@ -141,22 +153,43 @@ typedef struct Result {
     float gas;
 } sensor_result_t;
 
+struct grove_envsensor_info {
+    i2c i2c_dev;
+    unsigned char address;
+    int data;
+    int count;
+    struct grove_regcache regs;
+    bme680_dev_t dev;           // calibration, settings and t_fine
+    sensor_result_t result;     // last completed measurement
+    int configured;             // dev settings are programmed on the chip
+    unsigned char ctrl_meas;    // CONF_T_P_MODE value with the mode bits clear
+    int task;                   // scheduler task of a measurement, -1 if none
+    unsigned long long deadline; // time to give up waiting for new data
+    int8_t status;              // result of the last measurement
+};
 
-static struct grove_envsensor_info info[DEVICE_MAX];
+static struct grove_envsensor_info info[GROVE_ENVSENSOR_INSTANCES];
+GROVE_POOL(pool, GROVE_ENVSENSOR_INSTANCES);
 
 static int grove_envsensor_next_index() {
-    for (int i = 0; i < DEVICE_MAX; ++i) {
-        if (info[i].count == 0) return i;
-    }
-    return -1;
+    return grove_pool_alloc(&pool);
 }
 
 grove_envsensor grove_envsensor_open_at_address(int grove_id, int address) {
     grove_envsensor dev_id = grove_envsensor_next_index();
+    if (dev_id == -ENOMEM)
+        return -ENOMEM;
     info[dev_id].count++;
-    info[dev_id].i2c_dev = i2c_open_grove(grove_id);
+    info[dev_id].i2c_dev = i2c_open_grove_speed(grove_id, I2C_MAX_HZ);
     info[dev_id].address = address;
     info[dev_id].data = 0; // Static data initialisation
+    info[dev_id].dev = (bme680_dev_t){0};
+    info[dev_id].result = (sensor_result_t){0};
+    info[dev_id].configured = 0;
+    info[dev_id].task = -1;
+    info[dev_id].status = BME680_OK;
+    grove_regcache_init(&info[dev_id].regs, info[dev_id].i2c_dev, address,
+                        bme680_uncached, sizeof(bme680_uncached) / sizeof(bme680_uncached[0]));
     return dev_id;
 }
 
@@ -167,25 +200,25 @@ grove_envsensor grove_envsensor_open(int grove_id) {
 
 void grove_envsensor_close(grove_envsensor p) {
     if (--info[p].count != 0) return;
+    if (info[p].task >= 0) {
+        grove_sched_cancel(info[p].task);
+        info[p].task = -1;
+    }
     i2c i2c_dev = info[p].i2c_dev;
     i2c_close(i2c_dev);
+    grove_pool_free(&pool, p);
 }
 
 static int envsensor_write(grove_envsensor p, unsigned char addr, unsigned char value) {
 
-    i2c i2c_dev = info[p].i2c_dev;
-    unsigned char temp[2];
-    temp[0] = addr;
-    temp[1] = value;
-    if(i2c_write(i2c_dev, info[p].address, temp, 2) != 2) return -EIO;
+    if(grove_regcache_write(&info[p].regs, addr, value)) return -EIO;
     else return 0;
 }
 
 static int envsensor_read(grove_envsensor p, unsigned char addr, unsigned char length, unsigned char data[]) {
  
     i2c i2c_dev = info[p].i2c_dev;
-    if (i2c_write(i2c_dev, info[p].address, &addr, 1) != 1) return -EIO;
-    if (i2c_read(i2c_dev, info[p].address, data, length) != length) return -EIO;
+    if (i2c_read_reg(i2c_dev, info[p].address, addr, data, length) != length) return -EIO;
     return 0;
 }
 
@@ -213,7 +246,11 @@ py_int grove_envsensor_reg_write(grove_envsensor p, unsigned char addr, unsigned
 
 static int bme680_get_regs(grove_envsensor p, unsigned char reg_addr, unsigned char* reg_data, unsigned char len) {
     int8_t rslt = 0;
-	rslt = envsensor_read(p, reg_addr, len, reg_data);
+	if (len == 1) {
+		rslt = grove_regcache_read(&info[p].regs, reg_addr, reg_data);
+	} else {
+		rslt = envsensor_read(p, reg_addr, len, reg_data);
+	}
 	if (rslt != 0) {
 		rslt = BME680_E_COM_FAIL;
 	}
@@ -221,15 +258,17 @@ static int bme680_get_regs(grove_envsensor p, unsigned char reg_addr, unsigned c
 }
 
 
+/* The BME680 takes a register address before each data byte of a write,
+ * so all pairs go out interleaved in a single write */
 static int bme680_set_regs(grove_envsensor p,const unsigned char* reg_addr, const unsigned char* reg_data, unsigned char len) {
-    int8_t rslt;
-    unsigned char tmplen = len;
-	while(tmplen--) {
-        rslt = envsensor_write(p,*reg_addr++,*reg_data++);
-        if(rslt)
-            return -EIO;
+    unsigned char pairs[SET_REGS_MAX][2];
+    if (len > SET_REGS_MAX) return BME680_E_INVALID_LENGTH;
+	for (int i = 0; i < len; i++) {
+        pairs[i][0] = reg_addr[i];
+        pairs[i][1] = reg_data[i];
     }
-    return rslt;
+    if (grove_regcache_write_pairs(&info[p].regs, pairs[0], len)) return -EIO;
+    return 0;
 }
 
 
@@ -293,6 +332,7 @@ static int bme680_soft_reset(grove_envsensor p) {
     unsigned char soft_rst_cmd = BME680_SOFT_RESET_CMD;
 
 	rslt = bme680_set_regs(p, &reg_addr, &soft_rst_cmd, 1);
+	grove_regcache_invalidate(&info[p].regs);
 	delay_ms(BME680_RESET_PERIOD);
 
     return rslt;
@@ -355,23 +395,20 @@ static uint8_t calc_heater_res(uint16_t temp, const  bme680_dev_t* dev) {
     return heatr_res;
 }
 
-static int8_t set_gas_config(grove_envsensor p, bme680_dev_t* dev) {
-    int8_t rslt = BME680_OK;
-	unsigned char reg_addr[2] = {0};
-	unsigned char reg_data[2] = {0};
-	if (dev->power_mode == BME680_FORCED_MODE) {
-		reg_addr[0] = BME680_RES_HEAT0_ADDR;
-		reg_data[0] = calc_heater_res(dev->gas_sett.heatr_temp, dev);
-		reg_addr[1] = BME680_GAS_WAIT0_ADDR;
-		reg_data[1] = calc_heater_dur(dev->gas_sett.heatr_dur);
-		dev->gas_sett.nb_conv = 0;
-	} else {
-		rslt = BME680_W_DEFINE_PWR_MODE;
-	}
-	if (rslt == BME680_OK) {
-		rslt = bme680_set_regs(p, reg_addr, reg_data, 2);
+/* Add the heater profile 0 registers to the pairs of a bme680_set_regs
+ * burst, count is advanced past them */
+static int8_t set_gas_config(bme680_dev_t* dev, unsigned char* reg_addr, unsigned char* reg_data, unsigned char* count) {
+	if (dev->power_mode != BME680_FORCED_MODE) {
+		return BME680_W_DEFINE_PWR_MODE;
 	}
-    return rslt;
+	reg_addr[*count] = BME680_RES_HEAT0_ADDR;
+	reg_data[*count] = calc_heater_res(dev->gas_sett.heatr_temp, dev);
+	(*count)++;
+	reg_addr[*count] = BME680_GAS_WAIT0_ADDR;
+	reg_data[*count] = calc_heater_dur(dev->gas_sett.heatr_dur);
+	(*count)++;
+	dev->gas_sett.nb_conv = 0;
+    return BME680_OK;
 }
 
 static int8_t bme680_set_sensor_mode(grove_envsensor p, bme680_dev_t* dev) {
@@ -421,15 +458,16 @@ static int8_t boundary_check(uint8_t* value, uint8_t min, uint8_t max,  bme680_d
 }
 
 static int8_t bme680_set_sensor_settings(grove_envsensor p, uint16_t desired_settings,  bme680_dev_t* dev) {
-    int8_t rslt;
+    int8_t rslt = BME680_OK;
     unsigned char reg_addr;
     unsigned char data = 0;
     unsigned char count = 0;
-    unsigned char reg_array[BME680_REG_BUFFER_LENGTH] = { 0 };
-    unsigned char data_array[BME680_REG_BUFFER_LENGTH] = { 0 };
+    unsigned char reg_array[SET_REGS_MAX] = { 0 };
+    unsigned char data_array[SET_REGS_MAX] = { 0 };
     uint8_t intended_power_mode = dev->power_mode; 
+	// The heater profile goes out in the same burst as the other settings
 	if (desired_settings & BME680_GAS_MEAS_SEL) {
-		rslt = set_gas_config(p,dev);
+		rslt = set_gas_config(dev, reg_array, data_array, &count);
         if(rslt)
             return rslt;
 	}
@@ -764,42 +802,30 @@ static int8_t read_field_data(grove_envsensor p, bme680_field_data_t* data,  bme
     uint32_t adc_pres;
     uint16_t adc_hum;
     uint16_t adc_gas_res;
-    uint8_t tries = 100;
-
-    do {
-        if (rslt == BME680_OK) {
-            rslt = bme680_get_regs(p,((uint8_t)(BME680_FIELD0_ADDR)), buff, (uint16_t) BME680_FIELD_LENGTH);
-
-            data->status = buff[0] & BME680_NEW_DATA_MSK;
-            data->gas_index = buff[0] & BME680_GAS_INDEX_MSK;
-            data->meas_index = buff[1];
-
-            adc_pres = (uint32_t)(((uint32_t) buff[2] * 4096) | ((uint32_t) buff[3] * 16)
-                                  | ((uint32_t) buff[4] / 16));
-            adc_temp = (uint32_t)(((uint32_t) buff[5] * 4096) | ((uint32_t) buff[6] * 16)
-                                  | ((uint32_t) buff[7] / 16));
-            adc_hum = (uint16_t)(((uint32_t) buff[8] * 256) | (uint32_t) buff[9]);
-            adc_gas_res = (uint16_t)((uint32_t) buff[13] * 4 | (((uint32_t) buff[14]) / 64));
-            gas_range = buff[14] & BME680_GAS_RANGE_MSK;
-
-            data->status |= buff[14] & BME680_GASM_VALID_MSK;
-            data->status |= buff[14] & BME680_HEAT_STAB_MSK;
-
-            if (data->status & BME680_NEW_DATA_MSK) {
-                data->temperature = calc_temperature(adc_temp, dev);
-                data->pressure = calc_pressure(adc_pres, dev);
-                data->humidity = calc_humidity(adc_hum, dev);
-                data->gas_resistance = calc_gas_resistance(adc_gas_res, gas_range, dev);
-
-                break;
-            }
-            delay_ms(BME680_POLL_PERIOD_MS);
-        }
-        tries--;
-    } while (tries);
 
-    if (!tries) {
-        rslt = BME680_W_NO_NEW_DATA;
+    rslt = bme680_get_regs(p,((uint8_t)(BME680_FIELD0_ADDR)), buff, (uint16_t) BME680_FIELD_LENGTH);
+    if (rslt == BME680_OK) {
+        data->status = buff[0] & BME680_NEW_DATA_MSK;
+        data->gas_index = buff[0] & BME680_GAS_INDEX_MSK;
+        data->meas_index = buff[1];
+
+        adc_pres = (uint32_t)(((uint32_t) buff[2] * 4096) | ((uint32_t) buff[3] * 16)
+                              | ((uint32_t) buff[4] / 16));
+        adc_temp = (uint32_t)(((uint32_t) buff[5] * 4096) | ((uint32_t) buff[6] * 16)
+                              | ((uint32_t) buff[7] / 16));
+        adc_hum = (uint16_t)(((uint32_t) buff[8] * 256) | (uint32_t) buff[9]);
+        adc_gas_res = (uint16_t)((uint32_t) buff[13] * 4 | (((uint32_t) buff[14]) / 64));
+        gas_range = buff[14] & BME680_GAS_RANGE_MSK;
+
+        data->status |= buff[14] & BME680_GASM_VALID_MSK;
+        data->status |= buff[14] & BME680_HEAT_STAB_MSK;
+
+        if (data->status & BME680_NEW_DATA_MSK) {
+            data->temperature = calc_temperature(adc_temp, dev);
+            data->pressure = calc_pressure(adc_pres, dev);
+            data->humidity = calc_humidity(adc_hum, dev);
+            data->gas_resistance = calc_gas_resistance(adc_gas_res, gas_range, dev);
+        }
     }
 
     return rslt;
@@ -819,49 +845,181 @@ static int8_t bme680_get_sensor_data(grove_envsensor p, bme680_field_data_t* dat
     return rslt;
 }
 
-bme680_dev_t sensor_param;
-sensor_result_t sensor_result_value;
+/* Collect the data of the measurement in flight once new_data is set
+ *
+ * The task first runs when the measurement profile should be over, then
+ * polls the status byte every READY_POLL_US until the deadline, so a
+ * sensor that runs slow costs at most one poll period of extra latency.
+ *
+ * Parameters
+ * ----------
+ * arg: void*
+ *     grove_envsensor_info of the device
+ * now: unsigned long long
+ *     Current time in microseconds
+ *
+ * Returns
+ * -------
+ *     Time of the next try, GROVE_SCHED_DONE once the measurement is over
+ *
+ */
+static unsigned long long measure_step(void *arg, unsigned long long now) {
+    struct grove_envsensor_info *sensor = (struct grove_envsensor_info *)arg;
+    grove_envsensor p = sensor - info;
+    struct bme680_field_data data = {0};
+    unsigned char status;
+    int8_t rslt = bme680_get_regs(p, BME680_FIELD0_ADDR, &status, 1);
+
+    if (rslt == BME680_OK && !(status & BME680_NEW_DATA_MSK)) {
+        if (now < sensor->deadline) return now + READY_POLL_US;
+        rslt = BME680_W_NO_NEW_DATA;
+    }
+    if (rslt == BME680_OK) {
+        rslt = bme680_get_sensor_data(p, &data, &sensor->dev);
+    }
+    // The values are only converted when the field read shows new data
+    if (rslt == BME680_OK && !(data.status & BME680_NEW_DATA_MSK)) {
+        rslt = BME680_W_NO_NEW_DATA;
+    }
+    if (rslt == BME680_OK) {
+        sensor_result_t *result = &sensor->result;
+        result->temperature = data.temperature / 100.0;
+        result->humidity = data.humidity / 1000.0;
+        result->pressure = data.pressure;
+        if (data.status & BME680_HEAT_STAB_MSK) {
+            result->gas = data.gas_resistance;
+        } else {
+            result->gas = 0;
+        }
+    }
+    sensor->status = rslt;
+    sensor->task = -1;
+    return GROVE_SCHED_DONE;
+}
 
-py_int grove_envsensor_read_data(grove_envsensor p) {
+/* Program oversampling and heater settings and remember them for triggers
+ *
+ * Returns
+ * -------
+ *     0 = Settings programmed
+ *     1 = Failed to setup sensor
+ *
+ */
+static int envsensor_configure(grove_envsensor p, uint8_t os_t, uint8_t os_p,
+                               uint8_t os_h, uint16_t heater_temp,
+                               uint16_t heater_ms) {
+    uint16_t settings_sel = BME680_OST_SEL | BME680_OSH_SEL | BME680_OSP_SEL |
+        BME680_FILTER_SEL | BME680_GAS_SENSOR_SEL;
+    bme680_dev_t *dev = &info[p].dev;
+    unsigned char ctrl_meas;
+
+    info[p].configured = 0;
+    dev->power_mode = BME680_FORCED_MODE;
+    dev->tph_sett.os_temp = os_t;
+    dev->tph_sett.os_pres = os_p;
+    dev->tph_sett.os_hum = os_h;
+    dev->gas_sett.run_gas =
+        heater_ms ? BME680_ENABLE_GAS_MEAS : BME680_DISABLE_GAS_MEAS;
+    dev->gas_sett.heatr_temp = heater_temp;
+    dev->gas_sett.heatr_dur = heater_ms;
+    if (bme680_set_sensor_settings(p, settings_sel, dev)) return 1;
+    if (bme680_get_regs(p, BME680_CONF_T_P_MODE_ADDR, &ctrl_meas, 1)) return 1;
+
+    info[p].ctrl_meas = ctrl_meas & ~BME680_MODE_MSK;
+    info[p].configured = 1;
+    return BME680_OK;
+}
 
-    struct bme680_field_data data;
-    int ret;
-    sensor_param.power_mode = BME680_FORCED_MODE;
-    uint16_t settings_sel;
-    sensor_param.tph_sett.os_hum = BME680_OS_1X;
-    sensor_param.tph_sett.os_pres = BME680_OS_16X;
-    sensor_param.tph_sett.os_temp = BME680_OS_2X;
-    sensor_param.gas_sett.run_gas = BME680_ENABLE_GAS_MEAS;
-    // sensor_param.gas_sett.heatr_dur = 150;
-    // sensor_param.gas_sett.heatr_temp = 320;
-    sensor_param.gas_sett.heatr_dur = 100;
-    sensor_param.gas_sett.heatr_temp = 300;
-    settings_sel = BME680_OST_SEL | BME680_OSH_SEL | BME680_OSP_SEL | BME680_FILTER_SEL | BME680_GAS_SENSOR_SEL;
-
-    if ((ret = bme680_set_sensor_settings(p, settings_sel, &sensor_param))) {
+/* Trigger a forced mode measurement with the programmed settings
+ *
+ * The chip returns to sleep after each forced conversion, so once the
+ * device is configured a trigger is a single write of the mode register.
+ * Devices that were never configured get the driver defaults first.
+ *
+ * Returns
+ * -------
+ *     0 = Measurement started
+ *     1 = Failed to setup sensor
+ *     2 = Failed to set sensor mode
+ *     -ENOMEM = No free scheduler task
+ *
+ */
+static int measure_start(grove_envsensor p) {
+    if (!info[p].configured &&
+        envsensor_configure(p, BME680_OS_2X, BME680_OS_16X, BME680_OS_1X,
+                            300, 100)) {
         return 1;
     }
-    
-    if ((ret = bme680_set_sensor_mode(p, &sensor_param))) {
+    if (envsensor_write(p, BME680_CONF_T_P_MODE_ADDR,
+                        info[p].ctrl_meas | BME680_FORCED_MODE)) {
         return 2;
     }
 
     uint16_t meas_period;
-    bme680_get_profile_dur(&meas_period, &sensor_param);
-
-    delay_us(meas_period); 
+    bme680_get_profile_dur(&meas_period, &info[p].dev);
+
+    // The profile duration is in milliseconds
+    unsigned long long now = grove_time_us();
+    unsigned long long profile_us = meas_period * 1000ULL;
+    int task = grove_sched_add(measure_step, &info[p], now + profile_us);
+    if (task < 0) return task;
+    info[p].task = task;
+    info[p].deadline = now + 2 * profile_us + READY_SLACK_US;
+    return BME680_OK;
+}
 
-    if ((ret = bme680_get_sensor_data(p, &data, &sensor_param))) {
-        return 3;
+static int oversampling_code(int factor) {
+    switch (factor) {
+    case 0: return BME680_OS_NONE;
+    case 1: return BME680_OS_1X;
+    case 2: return BME680_OS_2X;
+    case 4: return BME680_OS_4X;
+    case 8: return BME680_OS_8X;
+    case 16: return BME680_OS_16X;
+    default: return -EINVAL;
     }
+}
 
-    sensor_result_value.temperature = data.temperature / 100.0;
-    sensor_result_value.humidity = data.humidity / 1000.0;
-    sensor_result_value.pressure = data.pressure;
-    if (data.status & BME680_HEAT_STAB_MSK) {
-        sensor_result_value.gas = data.gas_resistance;
-    } else {
-        sensor_result_value.gas = 0;
+py_int grove_envsensor_configure(grove_envsensor p, int os_t, int os_p,
+                                 int os_h, int heater_temp, int heater_ms) {
+    int code_t = oversampling_code(os_t);
+    int code_p = oversampling_code(os_p);
+    int code_h = oversampling_code(os_h);
+    if (code_t < 0 || code_p < 0 || code_h < 0) return -EINVAL;
+    if (heater_temp < 200 || heater_temp > 400) return -EINVAL;
+    if (heater_ms < 0 || heater_ms >= 0xfc0) return -EINVAL;
+    if (info[p].task >= 0) return -EBUSY;
+    if (envsensor_configure(p, code_t, code_p, code_h, heater_temp, heater_ms))
+        return -EIO;
+    return PY_SUCCESS;
+}
+
+py_int grove_envsensor_start(grove_envsensor p) {
+    if (info[p].task >= 0) return -EBUSY;
+    int ret = measure_start(p);
+    if (ret > 0) return -EIO;
+    return ret;
+}
+
+py_int grove_envsensor_poll(grove_envsensor p) {
+    grove_sched_run();
+    if (info[p].task >= 0) return GROVE_PENDING;
+    if (info[p].status == BME680_W_NO_NEW_DATA) return -ENODATA;
+    if (info[p].status != BME680_OK) return -EIO;
+    return PY_SUCCESS;
+}
+
+py_int grove_envsensor_read_data(grove_envsensor p) {
+    int ret;
+
+    // Let a measurement started with grove_envsensor_start finish first
+    while (info[p].task >= 0) grove_sched_yield();
+    if ((ret = measure_start(p))) {
+        return ret > 0 ? ret : 1;
+    }
+    while (info[p].task >= 0) grove_sched_yield();
+    if (info[p].status != BME680_OK) {
+        return 3;
     }
     return BME680_OK;
 }
@@ -871,7 +1029,7 @@ py_float grove_envsensor_read_temperature(grove_envsensor p) {
     if (ret = grove_envsensor_read_data(p)) {
         return ret;
     }
-    return sensor_result_value.temperature;
+    return info[p].result.temperature;
 }
 
 py_float grove_envsensor_read_pressure(grove_envsensor p) {
@@ -879,7 +1037,7 @@ py_float grove_envsensor_read_pressure(grove_envsensor p) {
     if (ret = grove_envsensor_read_data(p)) {
         return ret;
     }
-    return sensor_result_value.pressure;
+    return info[p].result.pressure;
 }
 
 py_float grove_envsensor_read_humidity(grove_envsensor p) {
@@ -887,7 +1045,7 @@ py_float grove_envsensor_read_humidity(grove_envsensor p) {
     if (ret = grove_envsensor_read_data(p)) {
         return ret;
     }
-    return sensor_result_value.humidity;
+    return info[p].result.humidity;
 }
 
 py_float grove_envsensor_read_gas(grove_envsensor p) {
@@ -895,14 +1053,43 @@ py_float grove_envsensor_read_gas(grove_envsensor p) {
     if (ret = grove_envsensor_read_data(p)) {
         return ret;
     }
-    return sensor_result_value.gas;
+    return info[p].result.gas;
+}
+
+py_int grove_envsensor_read_all(grove_envsensor p, float *values) {
+    int ret;
+    if ((ret = grove_envsensor_read_data(p))) {
+        return ret;
+    }
+    values[GROVE_ENVSENSOR_TEMPERATURE] = info[p].result.temperature;
+    values[GROVE_ENVSENSOR_PRESSURE] = info[p].result.pressure;
+    values[GROVE_ENVSENSOR_HUMIDITY] = info[p].result.humidity;
+    values[GROVE_ENVSENSOR_GAS] = info[p].result.gas;
+    return BME680_OK;
+}
+
+py_float grove_envsensor_measured_temperature(grove_envsensor p) {
+    return info[p].result.temperature;
+}
+
+py_float grove_envsensor_measured_pressure(grove_envsensor p) {
+    return info[p].result.pressure;
+}
+
+py_float grove_envsensor_measured_humidity(grove_envsensor p) {
+    return info[p].result.humidity;
+}
+
+py_float grove_envsensor_measured_gas(grove_envsensor p) {
+    return info[p].result.gas;
 }
 
 py_int grove_envsensor_init(grove_envsensor p) {
 	unsigned char result = 0;
-	sensor_param.amb_temp = 25;
+	info[p].dev.amb_temp = 25;
+    info[p].configured = 0; // bme680_init resets the chip
     int ret;
-    if ((ret = bme680_init(p, &sensor_param))) {
+    if ((ret = bme680_init(p, &info[p].dev))) {
         return false;
     }
     return true;
@@ -131,3 +131,53 @@ void grove_gesture_close(grove_gesture gesture);
  *
  */
 py_int grove_gesture_gesture(grove_gesture gesture);
+
+/* Start reading a gesture without waiting for it to complete
+ *
+ * Forward and backward movements begin like the other directions, so
+ * telling them apart takes up to 1.8 s of waiting for the hand to come
+ * closer and leave. That waiting runs from the scheduler whenever this or
+ * another driver polls, so other sensors can convert in the meantime.
+ *
+ * Parameters
+ * ----------
+ *     None
+ *
+ * Returns
+ * -------
+ *     0 if the read was started
+ *     -EBUSY if a read is already in flight
+ *     -ENOMEM if the scheduler has no free task
+ *     -EIO IO error (raises exception)
+ *
+ */
+py_int grove_gesture_start(grove_gesture gesture);
+
+/* Check whether a read started with start has completed
+ *
+ * Parameters
+ * ----------
+ *     None
+ *
+ * Returns
+ * -------
+ *     GROVE_PENDING while the read is in flight
+ *     0 once the gesture code can be read with result
+ *     -EIO IO error during the read (raises exception)
+ *
+ */
+py_int grove_gesture_poll(grove_gesture gesture);
+
+/* Gesture code of the last completed read
+ *
+ * Parameters
+ * ----------
+ *     None
+ *
+ * Returns
+ * -------
+ *   int:
+ *      A code as returned by gesture
+ *
+ */
+py_int grove_gesture_result(grove_gesture gesture);
@@ -31,6 +31,8 @@
  *****************************************************************************/
 
 #include <grove_interfaces.h>
+#include <grove_pool.h>
+#include <grove_sched.h>
 #include <grove_gesture.h>
 #include <grove_gesture_hw.h>
 #include <xparameters.h>
@@ -38,9 +40,12 @@
 #include <timer.h>
 #include <i2c.h>
 
-#define DEVICE_MAX 4
+#ifndef GROVE_GESTURE_INSTANCES
+#define GROVE_GESTURE_INSTANCES 4
+#endif
 
 #define I2C_ADDRESS 0x73
+#define I2C_MAX_HZ GROVE_I2C_FAST_HZ // PAJ7620U2 fast mode
 
 
 #define INIT_REG_ARRAY_SIZE \
@@ -91,19 +96,27 @@ const unsigned char initRegisterArray[][2] = {	// Initial Gesture
 	{0x7C,0x84},{0x7D,0x03},{0x7E,0x01},
 };
 
+/* What a gesture read in flight waits for */
+enum gesture_stage {
+    GESTURE_IDLE,
+    GESTURE_ENTRY,      // a direction that may turn into forward or backward
+    GESTURE_QUIT,       // the hand leaving after forward or backward
+};
+
 struct info {
     i2c i2c_dev;
     unsigned char address;
     int count;
+    int task;           // scheduler task of a read in flight, -1 if none
+    enum gesture_stage stage;
+    py_int result;      // gesture code of the last read, or -EIO
 };
 
-static struct info info[DEVICE_MAX];
+static struct info info[GROVE_GESTURE_INSTANCES];
+GROVE_POOL(pool, GROVE_GESTURE_INSTANCES);
 
 static int next_index() {
-    for (int i = 0; i < DEVICE_MAX; ++i) {
-        if (info[i].count == 0) return i;
-    }
-    return -1;
+    return grove_pool_alloc(&pool);
 }
 
 static int paj7620WriteReg(grove_gesture p, uint8_t addr, uint8_t cmd) {
@@ -139,8 +152,7 @@ static int paj7620ReadReg(grove_gesture p, uint8_t addr, uint8_t qty, uint8_t da
     
     */
     i2c i2c_dev = info[p].i2c_dev;
-    if (i2c_write(i2c_dev, PAJ7620_ID, &addr, 1) != 1) return -EIO;
-    if (i2c_read(i2c_dev, PAJ7620_ID, data, qty) != qty) return -EIO;
+    if (i2c_read_reg(i2c_dev, PAJ7620_ID, addr, data, qty) != qty) return -EIO;
     return 0;
 }
 
@@ -153,13 +165,12 @@ static int paj7620SelectBank(grove_gesture p, bank_e bank) {
         bank number
 
     */
-    i2c i2c_dev = info[p].i2c_dev;
     switch(bank){
         case BANK0:
-            if (paj7620WriteReg(i2c_dev, PAJ7620_REGITER_BANK_SEL, PAJ7620_BANK0) == -EIO) return -EIO;
+            if (paj7620WriteReg(p, PAJ7620_REGITER_BANK_SEL, PAJ7620_BANK0) == -EIO) return -EIO;
             break;
         case BANK1:
-            if (paj7620WriteReg(i2c_dev, PAJ7620_REGITER_BANK_SEL, PAJ7620_BANK1) == -EIO) return -EIO;
+            if (paj7620WriteReg(p, PAJ7620_REGITER_BANK_SEL, PAJ7620_BANK1) == -EIO) return -EIO;
             break;
         default:
             break;
@@ -171,40 +182,36 @@ static int set_default_config(grove_gesture p) {
     /* Default configuration for the device
 
     */
-    i2c i2c_dev = info[p].i2c_dev;
-    int i = 0;
     uint8_t data0 = 0, data1 = 0;
     uint8_t error;
 
     delay_us(700);
 
 
-    if (paj7620SelectBank(i2c_dev, BANK0) == -EIO) return -EIO;
+    if (paj7620SelectBank(p, BANK0) == -EIO) return -EIO;
 
-    error = paj7620ReadReg(i2c_dev, 0, 1, &data0);
+    error = paj7620ReadReg(p, 0, 1, &data0);
     if (error != 0)
     {
-        return -1;
+        return -EIO;
     }
-    error = paj7620ReadReg(i2c_dev, 1, 1, &data1);
+    error = paj7620ReadReg(p, 1, 1, &data1);
     if (error != 0)
     {
-        return -1;
+        return -EIO;
     }
     if ( (data0 != 0x20 ) || (data1 != 0x76) )
     {
-        return -1;
+        return -EIO;
     }
 
-    for (i = 0; i < INIT_REG_ARRAY_SIZE; i++)
-    {
-        if (paj7620WriteReg(i2c_dev, initRegisterArray[i][0], initRegisterArray[i][1]) == -EIO) return -EIO;
-    }
+    if (i2c_write_table(info[p].i2c_dev, PAJ7620_ID, initRegisterArray[0],
+                        INIT_REG_ARRAY_SIZE) != INIT_REG_ARRAY_SIZE) return -EIO;
 
-    if (paj7620SelectBank(i2c_dev, BANK1) == -EIO) return -EIO;  //gesture flag reg in Bank1
-    if (paj7620WriteReg(i2c_dev, 0x65, 0x12) == -EIO) return -EIO;  // near mode 240 fps
+    if (paj7620SelectBank(p, BANK1) == -EIO) return -EIO;  //gesture flag reg in Bank1
+    if (paj7620WriteReg(p, 0x65, 0x12) == -EIO) return -EIO;  // near mode 240 fps
 
-    if (paj7620SelectBank(i2c_dev, BANK0) == -EIO) return -1;  //gesture flag reg in Bank0
+    if (paj7620SelectBank(p, BANK0) == -EIO) return -EIO;  //gesture flag reg in Bank0
 
     return 0;
 }
@@ -217,10 +224,14 @@ grove_gesture grove_gesture_open_at_address(int grove_id, int address) {
     grove_gesture dev_id = next_index();
     if (dev_id >= 0) {
         info[dev_id].count++;
-        info[dev_id].i2c_dev = i2c_open_grove(grove_id);
+        info[dev_id].i2c_dev = i2c_open_grove_speed(grove_id, I2C_MAX_HZ);
         info[dev_id].address = address;
+        info[dev_id].task = -1;
+        info[dev_id].stage = GESTURE_IDLE;
+        info[dev_id].result = NONE;
         if (set_default_config(dev_id) == -EIO) {
             info[dev_id].count--;
+            grove_pool_free(&pool, dev_id);
             i2c_close(info[dev_id].i2c_dev);
             return -EIO;
         }
@@ -230,106 +241,124 @@ grove_gesture grove_gesture_open_at_address(int grove_id, int address) {
 
 void grove_gesture_close(grove_gesture p) {
     if (--info[p].count != 0) return;
+    grove_sched_cancel(info[p].task);
+    info[p].task = -1;
+    info[p].stage = GESTURE_IDLE;
     i2c i2c_dev = info[p].i2c_dev;
     i2c_close(i2c_dev);
+    grove_pool_free(&pool, p);
 }
 
-py_int grove_gesture_gesture(grove_gesture p) {
-    i2c i2c_dev = info[p].i2c_dev;
-    uint8_t data = 0, data1 = 0, error;
+static unsigned long long gesture_step(void *arg, unsigned long long now) {
+    /* Finish a gesture read once the wait it started is over
+
+    Parameters
+    ----------
+    arg: void*
+        Entry of the device in info
+    now: unsigned long long
+        Current time in microseconds
+
+    */
+    struct info *dev = (struct info *)arg;
+    grove_gesture p = dev - info;
+    uint8_t data = 0;
+
+    if (dev->stage == GESTURE_ENTRY) {
+        if (paj7620ReadReg(p, 0x43, 1, &data) == -EIO) {
+            dev->result = -EIO;
+        } else if (data == GES_FORWARD_FLAG || data == GES_BACKWARD_FLAG) {
+            dev->result = data == GES_FORWARD_FLAG ? FORWORD : BACKWORD;
+            dev->stage = GESTURE_QUIT;
+            return now + GES_QUIT_TIME * 1000ULL;
+        }
+    }
+    dev->stage = GESTURE_IDLE;
+    dev->task = -1;
+    return GROVE_SCHED_DONE;
+}
+
+py_int grove_gesture_start(grove_gesture p) {
+    uint8_t data = 0, data1 = 0;
+    unsigned int wait_ms = 0;
+
+    if (info[p].stage != GESTURE_IDLE) return -EBUSY;
+    info[p].result = NONE;
 
     // Read Bank_0_Reg_0x43/0x44 for gesture result.
-    error = paj7620ReadReg(i2c_dev, 0x43, 1, &data);
-    if (!error)
+    if (paj7620ReadReg(p, 0x43, 1, &data)) {
+        info[p].result = -EIO;
+        return -EIO;
+    }
+    switch (data)
     {
-        switch (data)
-        {
-            case GES_RIGHT_FLAG:
-                delay_ms(GES_ENTRY_TIME);
-                if (paj7620ReadReg(i2c_dev, 0x43, 1, &data) == -EIO) return -EIO;
-                if(data == GES_FORWARD_FLAG)
-                {
-                    delay_ms(GES_QUIT_TIME);
-                    return FORWORD;
-                }
-                else if(data == GES_BACKWARD_FLAG)
-                {
-                    delay_ms(GES_QUIT_TIME);
-                    return BACKWORD;
-                }
-                else
-                {
-                    return RIGHT;
-                }
-            case GES_LEFT_FLAG:
-                delay_ms(GES_ENTRY_TIME);
-                if (paj7620ReadReg(i2c_dev, 0x43, 1, &data) == -EIO) return -EIO;
-                if(data == GES_FORWARD_FLAG)
-                {
-                    delay_ms(GES_QUIT_TIME);
-                    return FORWORD;
-                }
-                else if(data == GES_BACKWARD_FLAG)
-                {
-                    delay_ms(GES_QUIT_TIME);
-                    return BACKWORD;
-                }
-                else
-                {
-                    return LEFT;
-                }
-            case GES_UP_FLAG:
-                delay_ms(GES_ENTRY_TIME);
-                if (paj7620ReadReg(i2c_dev, 0x43, 1, &data) == -EIO) return -EIO;
-                if(data == GES_FORWARD_FLAG)
-                {
-                    delay_ms(GES_QUIT_TIME);
-                    return FORWORD;
-                }
-                else if(data == GES_BACKWARD_FLAG)
-                {
-                    delay_ms(GES_QUIT_TIME);
-                    return BACKWORD;
-                }
-                else
-                {
-                    return UP;
-                }
-            case GES_DOWN_FLAG:
-                delay_ms(GES_ENTRY_TIME);
-                if (paj7620ReadReg(i2c_dev, 0x43, 1, &data) == -EIO) return -EIO;
-                if(data == GES_FORWARD_FLAG)
-                {
-                    delay_ms(GES_QUIT_TIME);
-                    return FORWORD;
-                }
-                else if(data == GES_BACKWARD_FLAG)
-                {
-                    delay_ms(GES_QUIT_TIME);
-                    return BACKWORD;
-                }
-                else
-                {
-                    return DOWN;
-                }
-            case GES_FORWARD_FLAG:
-                delay_ms(GES_QUIT_TIME);
-                return FORWORD;
-            case GES_BACKWARD_FLAG:
-                delay_ms(GES_QUIT_TIME);
-                return BACKWORD;
-            case GES_CLOCKWISE_FLAG:
-                return CLK_WISE;
-            case GES_COUNT_CLOCKWISE_FLAG:
-                return AN_CLK_WISE;
-            default:
-                if (paj7620ReadReg(i2c_dev, 0x44, 1, &data1) == -EIO) return -EIO;
-                if (data1 == GES_WAVE_FLAG)
-                {
-                    return WAVE;
-                }
-        }
+        case GES_RIGHT_FLAG:
+            info[p].result = RIGHT;
+            break;
+        case GES_LEFT_FLAG:
+            info[p].result = LEFT;
+            break;
+        case GES_UP_FLAG:
+            info[p].result = UP;
+            break;
+        case GES_DOWN_FLAG:
+            info[p].result = DOWN;
+            break;
+        case GES_FORWARD_FLAG:
+            info[p].result = FORWORD;
+            wait_ms = GES_QUIT_TIME;
+            info[p].stage = GESTURE_QUIT;
+            break;
+        case GES_BACKWARD_FLAG:
+            info[p].result = BACKWORD;
+            wait_ms = GES_QUIT_TIME;
+            info[p].stage = GESTURE_QUIT;
+            break;
+        case GES_CLOCKWISE_FLAG:
+            info[p].result = CLK_WISE;
+            break;
+        case GES_COUNT_CLOCKWISE_FLAG:
+            info[p].result = AN_CLK_WISE;
+            break;
+        default:
+            if (paj7620ReadReg(p, 0x44, 1, &data1)) {
+                info[p].result = -EIO;
+                return -EIO;
+            }
+            if (data1 == GES_WAVE_FLAG) info[p].result = WAVE;
+            break;
     }
+    if (info[p].result >= RIGHT && info[p].result <= DOWN) {
+        wait_ms = GES_ENTRY_TIME;
+        info[p].stage = GESTURE_ENTRY;
+    }
+    if (info[p].stage == GESTURE_IDLE) return PY_SUCCESS;
+
+    int task = grove_sched_add(gesture_step, &info[p],
+                               grove_time_us() + wait_ms * 1000ULL);
+    if (task < 0) {
+        info[p].stage = GESTURE_IDLE;
+        return task;
+    }
+    info[p].task = task;
+    return PY_SUCCESS;
+}
+
+py_int grove_gesture_poll(grove_gesture p) {
+    grove_sched_run();
+    if (info[p].stage != GESTURE_IDLE) return GROVE_PENDING;
+    return info[p].result < 0 ? info[p].result : PY_SUCCESS;
+}
+
+py_int grove_gesture_result(grove_gesture p) {
+    return info[p].result;
+}
 
-   return 0;
-}
\ No newline at end of file
+py_int grove_gesture_gesture(grove_gesture p) {
+    py_int ret = grove_gesture_start(p);
+    if (ret < 0) return ret;
+    while ((ret = grove_gesture_poll(p)) == GROVE_PENDING)
+        grove_sched_yield();
+    if (ret < 0) return ret;
+    return info[p].result;
+}
@@ -49,7 +49,7 @@
  *      set_full_scale_accel_range
  *      reset
  *      set_sleep_mode
- *      fetch_motion9
+ *      fetch_motion9, start_motion9, poll_motion9
  *      get_accel_ax, get_accel_y, get_accel_z
  *      get_gyro_x, get_gyro_y, get_gyro_z
  *      get_magneto_x, get_magneto_y, get_magneto_z
@@ -209,6 +209,39 @@ py_void grove_imu_set_sleep_mode(grove_imu imu, uint8_t mode);
  */
 py_void grove_imu_fetch_motion9(grove_imu imu);
 
+/* Start fetching the IMU values without waiting for the magnetometer
+ *
+ * The accelerometer and gyroscope are read at once. The magnetometer
+ * takes about 140 ms more; its steps run from the scheduler whenever this
+ * or another driver polls, so other sensors can convert in the meantime.
+ *
+ * Parameters
+ * ----------
+ *      None
+ *
+ * Returns
+ * -------
+ *      0 if the fetch was started
+ *      -EBUSY if a fetch is already in flight
+ *      -ENOMEM if the scheduler has no free task
+ *      -EIO device not present or IO error (raises exception)
+ */
+py_int grove_imu_start_motion9(grove_imu imu);
+
+/* Check whether a fetch started with start_motion9 has completed
+ *
+ * Parameters
+ * ----------
+ *      None
+ *
+ * Returns
+ * -------
+ *      GROVE_PENDING while the fetch is in flight
+ *      0 once the values can be read with the get_ methods
+ *      -EIO IO error during the fetch (raises exception)
+ */
+py_int grove_imu_poll_motion9(grove_imu imu);
+
 /* Acceleration in direction X
  *
  * Parameters
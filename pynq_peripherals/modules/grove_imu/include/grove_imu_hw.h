@@ -433,5 +433,4 @@
 #define BMP280_REG_PRESSUREDATA    0xF7
 #define BMP280_REG_TEMPDATA        0xFA
 #define I2C_ADDRESS 0x69
-#define DEVICE_MAX 4
 
@@ -31,6 +31,9 @@
  *****************************************************************************/
 
 #include <grove_interfaces.h>
+#include <grove_pool.h>
+#include <grove_regcache.h>
+#include <grove_sched.h>
 #include <grove_imu.h>
 #include "circular_buffer.h"
 #include "timer.h"
@@ -39,9 +42,29 @@
 
 #include "grove_imu_hw.h"
 
+#define I2C_MAX_HZ GROVE_I2C_FAST_HZ // MPU-9250, AK8963 and BMP280 fast mode
+
+#ifndef GROVE_IMU_INSTANCES
+#define GROVE_IMU_INSTANCES 4
+#endif
+
+/* Steps of fetch_motion9, each run by the scheduler after the delay the
+ * previous one asked for */
+enum imu_stage {
+    IMU_IDLE,
+    IMU_BYPASS,         // route the auxiliary bus to the magnetometer
+    IMU_MAG_START,      // trigger a single magnetometer measurement
+    IMU_MAG_READ,
+    IMU_SETTLE,
+};
+
 struct grove_imu_info {
     i2c i2c_dev;
     int count;
+    int task;           // scheduler task of a fetch in flight, -1 if none
+    enum imu_stage stage;
+    int status;         // result of the last fetch
+    struct grove_regcache mpu_regs;
     int16_t ax, ay, az, gx, gy, gz, mx, my, mz;
     int t_fine;
     uint16_t dig_T1, dig_P1;
@@ -51,13 +74,21 @@ struct grove_imu_info {
 static uint8_t mpuAddr, bmpAddr;
 static uint8_t buffer[14];
 
-static struct grove_imu_info info[DEVICE_MAX];
+/* MPU-9250 registers changed by the device itself: status, sample data,
+ * self-clearing reset bits and the DMP/FIFO ports */
+static const struct grove_regrange mpu_uncached[] = {
+    {MPU9250_RA_I2C_MST_STATUS, MPU9250_RA_I2C_MST_STATUS},
+    {MPU9250_RA_DMP_INT_STATUS, MPU9250_RA_MOT_DETECT_STATUS},
+    {MPU9250_RA_SIGNAL_PATH_RESET, MPU9250_RA_SIGNAL_PATH_RESET},
+    {MPU9250_RA_USER_CTRL, MPU9250_RA_USER_CTRL},
+    {MPU9250_RA_MEM_R_W, MPU9250_RA_FIFO_R_W},
+};
+
+static struct grove_imu_info info[GROVE_IMU_INSTANCES];
+GROVE_POOL(pool, GROVE_IMU_INSTANCES);
 
 static int next_index() {
-    for (int i = 0; i < DEVICE_MAX; ++i) {
-        if (info[i].count == 0) return i;
-    }
-    return -ENOMEM;
+    return grove_pool_alloc(&pool);
 }
 
 static int set_default_mpu_config(grove_imu imu);
@@ -76,15 +107,20 @@ grove_imu grove_imu_open(int grove_id) {
         return -ENOMEM;
     grove_imu lcl_err;
     info[dev_id].count++;
-    info[dev_id].i2c_dev = i2c_open_grove(grove_id);
+    info[dev_id].i2c_dev = i2c_open_grove_speed(grove_id, I2C_MAX_HZ);
+    info[dev_id].task = -1;
+    info[dev_id].stage = IMU_IDLE;
+    info[dev_id].status = PY_SUCCESS;
     
     if ((lcl_err = set_default_mpu_config(dev_id)) < PY_SUCCESS) {
         info[dev_id].count--;
+        grove_pool_free(&pool, dev_id);
         i2c_close(info[dev_id].i2c_dev);
         return lcl_err;
     }
     if ((lcl_err = set_default_bmp_config(dev_id)) < PY_SUCCESS) {
         info[dev_id].count--;
+        grove_pool_free(&pool, dev_id);
         i2c_close(info[dev_id].i2c_dev);
         return lcl_err;
     }
@@ -92,10 +128,16 @@ grove_imu grove_imu_open(int grove_id) {
 }
 
 void grove_imu_close(grove_imu imu) {
+    if (info[imu].count == 1) {
+        grove_sched_cancel(info[imu].task);
+        info[imu].task = -1;
+        info[imu].stage = IMU_IDLE;
+    }
     grove_imu_reset(imu);
     if (--info[imu].count != 0) return;
     i2c i2c_dev = info[imu].i2c_dev;
     i2c_close(i2c_dev);
+    grove_pool_free(&pool, imu);
 }
 
 /* Read data in bytes form register
@@ -119,8 +161,7 @@ void grove_imu_close(grove_imu imu) {
  */
 static int i2c_readBytes(grove_imu imu, uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data){
     i2c i2c_dev = info[imu].i2c_dev;
-    if (i2c_write(i2c_dev, devAddr, &regAddr, 1) != 1) return -EIO;
-    if (i2c_read(i2c_dev, devAddr, data, length) != length) return -EIO;
+    if (i2c_read_reg(i2c_dev, devAddr, regAddr, data, length) != length) return -EIO;
     return length;
 }
 
@@ -143,8 +184,11 @@ static int i2c_readBytes(grove_imu imu, uint8_t devAddr, uint8_t regAddr, uint8_
  */
 static int i2c_readByte(grove_imu imu, uint8_t devAddr, uint8_t regAddr, uint8_t *data){
     i2c i2c_dev = info[imu].i2c_dev;
-    if (i2c_write(i2c_dev, devAddr, &regAddr, 1) != 1) return -EIO;
-    if (i2c_read(i2c_dev, devAddr, data, 1) != 1) return -EIO;
+    if (devAddr == mpuAddr) {
+        if (grove_regcache_read(&info[imu].mpu_regs, regAddr, data)) return -EIO;
+        return 1;
+    }
+    if (i2c_read_reg(i2c_dev, devAddr, regAddr, data, 1) != 1) return -EIO;
     return 1;
 }
 
@@ -189,6 +233,9 @@ static int i2c_writeBytes(grove_imu imu, uint8_t devAddr, uint8_t regAddr, uint8
  */
 static int i2c_writeByte(grove_imu imu, uint8_t devAddr, uint8_t regAddr, uint8_t *data){
     i2c i2c_dev = info[imu].i2c_dev;
+    if (devAddr == mpuAddr) {
+        return grove_regcache_write(&info[imu].mpu_regs, regAddr, *data);
+    }
     uint8_t temp[2];
     temp[0] = regAddr;
     temp[1] = *data;
@@ -220,11 +267,10 @@ static int i2c_writeByte(grove_imu imu, uint8_t devAddr, uint8_t regAddr, uint8_
  * 
  */
 static int i2c_readBits(grove_imu imu, uint8_t devAddr, uint8_t regAddr, uint8_t bitStart, uint8_t width, uint8_t *data) {
-    i2c i2c_dev = info[imu].i2c_dev;
     uint8_t b;
     uint8_t mask;
-    int count = i2c_readBytes(imu, devAddr, regAddr, 1, &b);
-    if (count == -1) {
+    int count = i2c_readByte(imu, devAddr, regAddr, &b);
+    if (count < 0) {
         return -EIO;
     }
     if (count != 0) {
@@ -282,8 +328,8 @@ static int i2c_writeBits(grove_imu imu, uint8_t devAddr, uint8_t regAddr,
                      uint8_t bitStart, uint8_t width, uint8_t *data) {
     uint8_t b, temp;
     temp = *data;
-    int count = i2c_readBytes(imu, devAddr, regAddr, 1, &b);
-    if (count == -1) {
+    int count = i2c_readByte(imu, devAddr, regAddr, &b);
+    if (count < 0) {
         return -EIO;
     }
     if (count != 0) {
@@ -296,7 +342,7 @@ static int i2c_writeBits(grove_imu imu, uint8_t devAddr, uint8_t regAddr,
         b &= ~(mask);
         // combine data with existing byte
         b |= temp;
-        if (i2c_writeByte(imu, devAddr, regAddr, &b) == -1) return -EIO;
+        if (i2c_writeByte(imu, devAddr, regAddr, &b) < 0) return -EIO;
     }
     return PY_SUCCESS;
 }
@@ -338,6 +384,8 @@ static int i2c_writeBit(grove_imu imu, uint8_t devAddr, uint8_t regAddr, uint8_t
 static int set_default_mpu_config(grove_imu imu) {
     mpuAddr = MPU9250_DEFAULT_ADDRESS;
     bmpAddr = BMP280_ADDRESS;
+    grove_regcache_init(&info[imu].mpu_regs, info[imu].i2c_dev, mpuAddr,
+                        mpu_uncached, sizeof(mpu_uncached) / sizeof(mpu_uncached[0]));
     if (grove_imu_set_clock_source(imu, MPU9250_CLOCK_PLL_XGYRO) == -EIO) return -EIO;
     if (grove_imu_set_full_scale_gyro_range(imu, MPU9250_GYRO_FS_250) == -EIO) return -EIO;
     if (grove_imu_set_full_scale_accel_range(imu, MPU9250_ACCEL_FS_2) == -EIO) return -EIO;
@@ -363,8 +411,11 @@ py_void grove_imu_set_full_scale_accel_range(grove_imu imu, uint8_t range) {
 
 py_void grove_imu_reset(grove_imu imu) {
     uint8_t data = 0x01;
-    return i2c_writeBit(imu, mpuAddr, MPU9250_RA_PWR_MGMT_1, 
+    int ret = i2c_writeBit(imu, mpuAddr, MPU9250_RA_PWR_MGMT_1, 
                     MPU9250_PWR1_DEVICE_RESET_BIT, &data);
+    // All registers return to their power-on values
+    grove_regcache_invalidate(&info[imu].mpu_regs);
+    return ret;
 }
 
 py_void grove_imu_set_sleep_mode(grove_imu imu, uint8_t enabled) {
@@ -372,35 +423,89 @@ py_void grove_imu_set_sleep_mode(grove_imu imu, uint8_t enabled) {
                     MPU9250_PWR1_SLEEP_BIT, &enabled);
 }
 
-py_void grove_imu_fetch_motion9(grove_imu imu) {
+/* Run the next step of a fetch_motion9 in flight
+ *
+ * Parameters
+ * ----------
+ * arg: void*
+ *     Entry of the device in info
+ * now: unsigned long long
+ *     Current time in microseconds
+ *
+ * Returns
+ * -------
+ *     Time of the next step, GROVE_SCHED_DONE once the fetch is over
+ *
+ */
+static unsigned long long fetch_step(void *arg, unsigned long long now) {
+    struct grove_imu_info *dev = (struct grove_imu_info *)arg;
+    grove_imu imu = dev - info;
+    uint8_t data;
+    switch (dev->stage) {
+    case IMU_BYPASS:
+        data = 0x02;
+        //set i2c bypass enable pin to access magnetometer
+        if (i2c_writeByte(imu, mpuAddr, MPU9250_RA_INT_PIN_CFG, &data) == -EIO) break;
+        dev->stage = IMU_MAG_START;
+        return now + 10000;
+    case IMU_MAG_START:
+        data = 0x01;
+        //enable the magnetometer
+        if (i2c_writeByte(imu, MPU9150_RA_MAG_ADDRESS, 0x0A, &data) == -EIO) break;
+        dev->stage = IMU_MAG_READ;
+        return now + 10000;
+    case IMU_MAG_READ:
+        if (i2c_readBytes(imu, MPU9150_RA_MAG_ADDRESS, MPU9150_RA_MAG_XOUT_L, 6, buffer) == -EIO) break;
+        dev->mx = (((int16_t)buffer[1]) << 8) | buffer[0];
+        dev->my = (((int16_t)buffer[3]) << 8) | buffer[2];
+        dev->mz = (((int16_t)buffer[5]) << 8) | buffer[4];
+        dev->stage = IMU_SETTLE;
+        return now + 60000;
+    default:
+        dev->status = PY_SUCCESS;
+        dev->stage = IMU_IDLE;
+        dev->task = -1;
+        return GROVE_SCHED_DONE;
+    }
+    dev->status = -EIO;
+    dev->stage = IMU_IDLE;
+    dev->task = -1;
+    return GROVE_SCHED_DONE;
+}
+
+py_int grove_imu_start_motion9(grove_imu imu) {
+    if (info[imu].stage != IMU_IDLE) return -EBUSY;
     //get accel and gyro
     if (i2c_readBytes(imu, mpuAddr, MPU9250_RA_ACCEL_XOUT_H, 14, buffer) == -EIO) return -EIO;
-    delay_ms(60);
     info[imu].ax = (((int16_t)buffer[0]) << 8) | buffer[1];
     info[imu].ay = (((int16_t)buffer[2]) << 8) | buffer[3];
     info[imu].az = (((int16_t)buffer[4]) << 8) | buffer[5];
     info[imu].gx = (((int16_t)buffer[8]) << 8) | buffer[9];
     info[imu].gy = (((int16_t)buffer[10]) << 8) | buffer[11];
     info[imu].gz = (((int16_t)buffer[12]) << 8) | buffer[13];
-    
-    //read mag
-    uint8_t data;
-    data = 0x02;
-    //set i2c bypass enable pin to access magnetometer
-    if (i2c_writeByte(imu, mpuAddr, MPU9250_RA_INT_PIN_CFG, &data) == -EIO) return -EIO;
-    delay_ms(10);
-    data = 0x01;
-    //enable the magnetometer
-    if (i2c_writeByte(imu, MPU9150_RA_MAG_ADDRESS, 0x0A, &data) == -EIO) return -EIO;
-    delay_ms(10);
-    if (i2c_readBytes(imu, MPU9150_RA_MAG_ADDRESS, MPU9150_RA_MAG_XOUT_L, 6, buffer) == -EIO) return -EIO;
-    delay_ms(60);
-    info[imu].mx = (((int16_t)buffer[1]) << 8) | buffer[0];
-    info[imu].my = (((int16_t)buffer[3]) << 8) | buffer[2];
-    info[imu].mz = (((int16_t)buffer[5]) << 8) | buffer[4];
+
+    //read mag once the accelerometer and gyroscope have settled
+    int task = grove_sched_add(fetch_step, &info[imu], grove_time_us() + 60000);
+    if (task < 0) return task;
+    info[imu].task = task;
+    info[imu].stage = IMU_BYPASS;
     return PY_SUCCESS;
 }
 
+py_int grove_imu_poll_motion9(grove_imu imu) {
+    grove_sched_run();
+    if (info[imu].stage != IMU_IDLE) return GROVE_PENDING;
+    return info[imu].status;
+}
+
+py_void grove_imu_fetch_motion9(grove_imu imu) {
+    int ret = grove_imu_start_motion9(imu);
+    if (ret < 0) return ret;
+    while ((ret = grove_imu_poll_motion9(imu)) == GROVE_PENDING)
+        grove_sched_yield();
+    return ret;
+}
+
 py_float grove_imu_get_accel_x(grove_imu imu) {
     float v = (float)info[imu].ax/16384;
     return v;
@@ -462,10 +567,9 @@ py_float grove_imu_get_magneto_z(grove_imu imu) {
  * 
  */
 static int bmp_read_u16(grove_imu imu, uint8_t regAddr) {
-    uint8_t lsb, msb;
-    if (i2c_readByte(imu, BMP280_ADDRESS, regAddr, &lsb) == -EIO) return -EIO;
-    if (i2c_readByte(imu, BMP280_ADDRESS, regAddr + 1, &msb) == -EIO) return -EIO;
-    return (int)(((uint16_t)msb << 8) | (uint16_t)lsb);
+    uint8_t data[2];
+    if (i2c_readBytes(imu, BMP280_ADDRESS, regAddr, 2, data) == -EIO) return -EIO;
+    return (int)(((uint16_t)data[1] << 8) | (uint16_t)data[0]);
 }
 
 /* Read a 16-bit signed value from BMP280
@@ -482,10 +586,9 @@ static int bmp_read_u16(grove_imu imu, uint8_t regAddr) {
  * 
  */
 static int bmp_read_s16(grove_imu imu, uint8_t regAddr) {
-    uint8_t lsb, msb;
-    if (i2c_readByte(imu, BMP280_ADDRESS, regAddr, &lsb) == -EIO) return -EIO;
-    if (i2c_readByte(imu, BMP280_ADDRESS, regAddr + 1, &msb) == -EIO) return -EIO;
-    return (int)((int16_t)(((uint16_t)msb << 8) | (uint16_t)lsb));
+    uint8_t data[2];
+    if (i2c_readBytes(imu, BMP280_ADDRESS, regAddr, 2, data) == -EIO) return -EIO;
+    return (int)((int16_t)(((uint16_t)data[1] << 8) | (uint16_t)data[0]));
 }
 
 /* Set defalut configuration of IMU BMP
@@ -532,11 +635,9 @@ static int set_default_bmp_config(grove_imu imu) {
 py_float grove_imu_get_temperature(grove_imu imu) {
     int var1, var2;
     int adc_T;
-    uint8_t msb, lsb, xlsb;
-    if (i2c_readByte(imu, BMP280_ADDRESS, BMP280_REG_TEMPDATA, &msb) == -EIO) return PY_FLOAT_ERROR;
-    if (i2c_readByte(imu, BMP280_ADDRESS, BMP280_REG_TEMPDATA + 1, &lsb) == -EIO) return PY_FLOAT_ERROR;
-    if (i2c_readByte(imu, BMP280_ADDRESS, BMP280_REG_TEMPDATA + 2, &xlsb) == -EIO) return -PY_FLOAT_ERROR;
-    adc_T = (int)(((uint32_t)msb << 16) | ((uint32_t)lsb << 8) | (uint32_t)xlsb);
+    uint8_t data[3];
+    if (i2c_readBytes(imu, BMP280_ADDRESS, BMP280_REG_TEMPDATA, 3, data) == -EIO) return PY_FLOAT_ERROR;
+    adc_T = (int)(((uint32_t)data[0] << 16) | ((uint32_t)data[1] << 8) | (uint32_t)data[2]);
     adc_T >>= 4;
     var1 = (((adc_T >> 3) - ((int)(info[imu].dig_T1 << 1))) * ((int)info[imu].dig_T2)) >> 11;
     var2 = (((((adc_T >> 4) - ((int)info[imu].dig_T1)) * ((adc_T >> 4) - ((int)info[imu].dig_T1))) >> 12) * ((int)info[imu].dig_T3)) >> 14;
@@ -551,11 +652,9 @@ py_int grove_imu_get_pressure(grove_imu imu) {
     grove_imu_get_temperature(imu);
 
     int adc_P;
-    uint8_t msb, lsb, xlsb;
-    if (i2c_readByte(imu, BMP280_ADDRESS, BMP280_REG_PRESSUREDATA, &msb) == -EIO) return -EIO;
-    if (i2c_readByte(imu, BMP280_ADDRESS, BMP280_REG_PRESSUREDATA + 1, &lsb) == -EIO) return -EIO;
-    if (i2c_readByte(imu, BMP280_ADDRESS, BMP280_REG_PRESSUREDATA + 2, &xlsb) == -EIO) return -EIO;
-    adc_P = (int)(((uint32_t)msb << 16) | ((uint32_t)lsb << 8) | (uint32_t)xlsb);
+    uint8_t data[3];
+    if (i2c_readBytes(imu, BMP280_ADDRESS, BMP280_REG_PRESSUREDATA, 3, data) == -EIO) return -EIO;
+    adc_P = (int)(((uint32_t)data[0] << 16) | ((uint32_t)data[1] << 8) | (uint32_t)data[2]);
     adc_P >>= 4;
     var1 = ((int64_t)info[imu].t_fine) - 128000;
     var2 = var1 * var1 * (int64_t)info[imu].dig_P6;
@@ -0,0 +1,120 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* Driver calls executed from a command buffer
+ *
+ * Every driver call from Python is a separate RPC with a full mailbox
+ * round trip. A driver can instead let a sequence of its calls be sent in
+ * one buffer and run by grove_batch_run, declared in grove_interfaces.h.
+ * It registers a table of operations when it is first opened, each named
+ * after the public function it stands for and run through a small adapter
+ * that unpacks the arguments.
+ *
+ * A command in the buffer is the FNV-1a hash of the function name, the
+ * device handle, a word with the number of arguments in the low byte and
+ * a mask of the arguments holding float bits above it, then one word per
+ * argument.
+ */
+
+#pragma once
+
+/* Largest number of operations registered by all drivers together */
+#ifndef GROVE_BATCH_OPS
+#define GROVE_BATCH_OPS 32
+#endif
+
+/* Largest number of arguments of one operation */
+#define GROVE_BATCH_ARGS_MAX 8
+
+struct grove_batch_args {
+    const unsigned int *words;
+    unsigned int count;
+    unsigned int floats;        /* bit i set if word i holds float bits */
+};
+
+/* Adapter running one operation */
+typedef int (*grove_batch_fn)(int device, const struct grove_batch_args *args);
+
+struct grove_batch_op {
+    const char *name;           /* public function, e.g. grove_relay_on */
+    grove_batch_fn fn;
+};
+
+/* Register the operations of a driver, later calls with the same table
+ * are ignored
+ *
+ * Parameters
+ * ----------
+ * ops: const struct grove_batch_op*
+ *     Static table of operations
+ * count: int
+ *     Number of entries in the table
+ *
+ * Returns
+ * -------
+ *     PY_SUCCESS if the table is registered
+ *     -ENOMEM if GROVE_BATCH_OPS operations would be exceeded
+ *
+ */
+int grove_batch_register(const struct grove_batch_op *ops, int count);
+
+/* Argument of an operation as an integer, converted if sent as a float
+ *
+ * Parameters
+ * ----------
+ * args: const struct grove_batch_args*
+ *     Arguments passed to the adapter
+ * index: unsigned int
+ *     Argument number, 0 if out of range
+ *
+ * Returns
+ * -------
+ *     Value of the argument
+ *
+ */
+int grove_batch_int(const struct grove_batch_args *args, unsigned int index);
+
+/* Argument of an operation as a float, converted if sent as an integer
+ *
+ * Parameters
+ * ----------
+ * args: const struct grove_batch_args*
+ *     Arguments passed to the adapter
+ * index: unsigned int
+ *     Argument number, 0 if out of range
+ *
+ * Returns
+ * -------
+ *     Value of the argument
+ *
+ */
+float grove_batch_float(const struct grove_batch_args *args, unsigned int index);
@@ -30,6 +30,8 @@
  *
  *****************************************************************************/
 
+#pragma once
+
 #define PYNQ_HAS_I2C
 #define PYNQ_HAS_GPIO
 
@@ -41,7 +43,135 @@
 #include <grove_constants.h>
 
 #ifdef PYNQ_HAS_I2C
+/* SCL frequencies of the I2C bus modes supported by the AXI IIC controller */
+#define GROVE_I2C_MIN_HZ          1000
+#define GROVE_I2C_STANDARD_HZ     100000
+#define GROVE_I2C_FAST_HZ         400000
+#define GROVE_I2C_FAST_PLUS_HZ    1000000
+
+/* Open the I2C bus of a Grove port for a device of the given speed
+ *
+ * Devices on the same port share one controller handle. The controller is
+ * only initialised and routed by the first open, later opens of the port
+ * take another reference to it. The bus runs at the highest speed that all
+ * devices opened on it support: opening a slower device lowers the clock,
+ * and it is only raised again once every device has been closed.
+ *
+ * Parameters
+ * ----------
+ * grove_id: int
+ *     Grove port the device is attached to
+ * hz: unsigned int
+ *     Fastest SCL frequency the device supports, limited to
+ *     GROVE_I2C_FAST_PLUS_HZ
+ *
+ * Returns
+ * -------
+ *     I2C controller handle, negative if the port has no I2C bus
+ *     -EINVAL if hz is below GROVE_I2C_MIN_HZ
+ *
+ */
+i2c i2c_open_grove_speed(int grove_id, unsigned int hz);
+
+/* Open the I2C bus of a Grove port for a standard mode (100 kHz) device
+ *
+ * See i2c_open_grove_speed.
+ *
+ */
 i2c i2c_open_grove(int grove_id);
+
+/* SCL frequency an open I2C controller currently runs at
+ *
+ * Parameters
+ * ----------
+ * dev_id: i2c
+ *     I2C controller returned by i2c_open_grove
+ *
+ * Returns
+ * -------
+ *     Frequency in Hz, 0 if the handle is not open
+ *
+ */
+unsigned int i2c_get_speed(i2c dev_id);
+
+/* Release a handle returned by i2c_open_grove
+ *
+ * The controller is closed when the last device using it is released.
+ * Drivers reach this through i2c_close.
+ *
+ * Parameters
+ * ----------
+ * dev_id: i2c
+ *     I2C controller returned by i2c_open_grove
+ *
+ * Returns
+ * -------
+ *     None
+ *
+ */
+void grove_i2c_close(i2c dev_id);
+
+/* Read consecutive registers of an I2C target in a single transaction
+ *
+ * The register address is written and the data read back with a repeated
+ * start in between, so the bus is not released between the two phases.
+ *
+ * Parameters
+ * ----------
+ * dev_id: i2c
+ *     I2C controller returned by i2c_open_grove
+ * slave_address: unsigned int
+ *     7-bit target address
+ * reg: unsigned char
+ *     Address of the first register
+ * buffer: unsigned char*
+ *     Destination of the register contents
+ * length: unsigned int
+ *     Number of bytes to read
+ *
+ * Returns
+ * -------
+ *     Number of bytes read, less than length if the target did not respond
+ *
+ */
+unsigned int i2c_read_reg(i2c dev_id, unsigned int slave_address,
+                          unsigned char reg, unsigned char* buffer,
+                          unsigned int length);
+
+/* Longest auto-increment burst sent by i2c_write_table */
+#define GROVE_I2C_BURST_MAX 16
+
+/* Write a table of register/value pairs to an I2C target
+ *
+ * Runs of pairs with consecutive register addresses are sent as a single
+ * auto-increment write of up to GROVE_I2C_BURST_MAX registers. The bursts
+ * follow each other with repeated starts, so the whole table is written
+ * in one bus transaction. Pairs are written in table order.
+ *
+ * Only for targets that auto-increment the register address on writes.
+ * The BME680 does not: it takes an address before every data byte, so a
+ * burst would land its values in the wrong registers. Write such targets
+ * with grove_regcache_write_pairs or one register at a time.
+ *
+ * Parameters
+ * ----------
+ * dev_id: i2c
+ *     I2C controller returned by i2c_open_grove
+ * slave_address: unsigned int
+ *     7-bit target address
+ * pairs: const unsigned char*
+ *     count pairs of register address followed by value
+ * count: unsigned int
+ *     Number of pairs
+ *
+ * Returns
+ * -------
+ *     Number of pairs written, less than count if the target did not
+ *     respond
+ *
+ */
+unsigned int i2c_write_table(i2c dev_id, unsigned int slave_address,
+                             const unsigned char* pairs, unsigned int count);
 #endif
 #ifdef PYNQ_HAS_UART
 uart uart_open_grove(int grove_id);
@@ -50,10 +180,581 @@ uart uart_open_grove(int grove_id);
 gpio gpio_open_grove(int grove_id);
 gpio gpio_open_grove_a(int grove_id);
 gpio gpio_open_grove_b(int grove_id);
+
+/* Open both pins of a Grove port as one gpio handle
+ *
+ * Masked writes to the handle update the two pins with a single register
+ * write. The handle spans every pin between the two, so set directions
+ * through gpio_open_grove_a and gpio_open_grove_b rather than this handle.
+ *
+ * Parameters
+ * ----------
+ * grove_id : int
+ *     Grove port with two digital pins
+ *
+ * Returns
+ * -------
+ *     gpio handle, negative on failure
+ *
+ */
+gpio gpio_open_grove_pair(int grove_id);
+
+/* Bit of one pin of a Grove port in the values of a pair handle
+ *
+ * Parameters
+ * ----------
+ * grove_id : int
+ *     Grove port the pair was opened on
+ * pin_id : int
+ *     0 for the first pin, 1 for the second
+ *
+ * Returns
+ * -------
+ *     Mask with the bit of the pin set
+ *
+ */
+unsigned int gpio_grove_pair_mask(int grove_id, int pin_id);
+
+/* Drive the masked pins of a gpio handle with one register write
+ *
+ * Bits of mask and value count from the lowest pin of the handle; pins
+ * outside the mask keep their level.
+ *
+ * Parameters
+ * ----------
+ * mask : unsigned int
+ *     Pins to update
+ * value : unsigned int
+ *     New levels of the masked pins
+ *
+ * Returns
+ * -------
+ *     None
+ *
+ */
+void gpio_write_mask(gpio device, unsigned int mask, unsigned int value);
+
+/* Drive the masked pins of a gpio handle through a series of levels
+ *
+ * The data register is read once and then written once per value, so a
+ * bit-banged protocol costs one AXI write per edge. No other driver may
+ * change pins sharing the register until the sequence completes.
+ *
+ * Parameters
+ * ----------
+ * mask : unsigned int
+ *     Pins to update
+ * values : const unsigned int*
+ *     Levels of the masked pins, one register write each
+ * count : unsigned int
+ *     Number of values
+ *
+ * Returns
+ * -------
+ *     None
+ *
+ */
+void gpio_write_sequence(gpio device, unsigned int mask,
+                         const unsigned int *values, unsigned int count);
+
+/* Number of pins whose edges can be watched at the same time */
+#define GROVE_GPIO_WATCHES 8
+
+/* Edge events buffered until they are read, must be a power of two. Each
+ * takes 12 bytes of BSS, 3 KB at the default depth. */
+#ifndef GROVE_GPIO_EVENT_DEPTH
+#define GROVE_GPIO_EVENT_DEPTH 256
+#endif
+
+/* Words taken by one edge event in the buffer of gpio_event_read */
+#define GROVE_GPIO_EVENT_WORDS 3
+
+#define GROVE_GPIO_RISING  1
+#define GROVE_GPIO_FALLING 2
+#define GROVE_GPIO_BOTH    3
+
+/* Fields of an edge event, given a pointer to its first word */
+#define GROVE_GPIO_EVENT_WATCH(event) ((event)[0] >> 1)
+#define GROVE_GPIO_EVENT_LEVEL(event) ((event)[0] & 1)
+#define GROVE_GPIO_EVENT_TIME_US(event) \
+    (((unsigned long long)(event)[2] << 32) | (event)[1])
+
+/* Record the edges of an input pin as timestamped events
+ *
+ * The IOP has no interrupt from the GPIO block, so edges are found by
+ * comparing the levels of all watched pins each time gpio_event_poll
+ * runs, either directly, from gpio_event_wait and gpio_event_read, or
+ * from the scheduler while a driver waits for a conversion. A pulse
+ * shorter than the time between two polls is missed; while gpio_event_wait
+ * runs, that is a few AXI accesses.
+ *
+ * Parameters
+ * ----------
+ * edges : int
+ *     GROVE_GPIO_RISING, GROVE_GPIO_FALLING or GROVE_GPIO_BOTH
+ *
+ * Returns
+ * -------
+ *     Watch id carried by the events of the pin
+ *     -EINVAL if the handle or the edges are invalid
+ *     -ENOMEM if GROVE_GPIO_WATCHES pins are already watched or the
+ *     scheduler has no free task for the polling
+ *
+ */
+py_int gpio_event_watch(gpio device, int edges);
+
+/* Stop recording the edges of a pin, events already buffered are kept
+ *
+ * Parameters
+ * ----------
+ * watch : int
+ *     Watch id returned by gpio_event_watch
+ *
+ * Returns
+ * -------
+ *     None
+ *
+ */
+py_void gpio_event_unwatch(int watch);
+
+/* Sample all watched pins once and buffer the edges found
+ *
+ * Parameters
+ * ----------
+ *     None
+ *
+ * Returns
+ * -------
+ *     Number of events buffered by this call
+ *
+ */
+py_int gpio_event_poll(void);
+
+/* Poll the watched pins until events are buffered or a timeout expires
+ *
+ * Parameters
+ * ----------
+ * count : int
+ *     Number of buffered events to wait for
+ * timeout_us : unsigned int
+ *     Longest wait in microseconds
+ *
+ * Returns
+ * -------
+ *     Number of buffered events
+ *
+ */
+py_int gpio_event_wait(int count, unsigned int timeout_us);
+
+/* Move buffered edge events out of the ring buffer, oldest first
+ *
+ * Every event takes GROVE_GPIO_EVENT_WORDS words: the watch id and the new
+ * level of the pin, read with GROVE_GPIO_EVENT_WATCH and
+ * GROVE_GPIO_EVENT_LEVEL, then the low and high words of the grove_time_us
+ * time at which the edge was seen, read with GROVE_GPIO_EVENT_TIME_US.
+ *
+ * Parameters
+ * ----------
+ * events : unsigned int*
+ *     Buffer of GROVE_GPIO_EVENT_WORDS * count words
+ * count : int
+ *     Largest number of events to read
+ *
+ * Returns
+ * -------
+ *     Number of events read
+ *
+ */
+py_int gpio_event_read(unsigned int *events, int count);
+
+/* Number of events lost because the ring buffer was full
+ *
+ * Parameters
+ * ----------
+ *     None
+ *
+ * Returns
+ * -------
+ *     Events dropped since the IOP started
+ *
+ */
+py_int gpio_event_dropped(void);
 #endif
 analog analog_open_grove(int grove_id);
 analog analog_open_grove_a(int grove_id);
 analog analog_open_grove_b(int grove_id);
+
+/* Open a pin of a Grove port as a PWM output
+ *
+ * Every AXI timer of the IOP can drive one IO switch PWM channel. Each pin
+ * gets a free timer of its own, so several servos and motors can run at
+ * once; opening a pin that already has one shares it. Timer 0 is kept for
+ * the time base, except on an IOP with a single timer, such as the PMOD
+ * IOP, where PWM takes it and the time base counts its periods instead; see
+ * grove_time_us.
+ *
+ * Parameters
+ * ----------
+ * grove_id : int
+ *     Grove port of the pin
+ *
+ * Returns
+ * -------
+ *     timer handle
+ *     -EBUSY if every PWM channel is in use or the IOP has none
+ *     -ENODEV if the timer of the channel cannot be opened
+ *
+ */
 timer timer_open_grove(int grove_id);
 timer timer_open_grove_a(int grove_id);
 timer timer_open_grove_b(int grove_id);
+
+/* Release a handle returned by timer_open_grove
+ *
+ * The PWM channel is freed and its pin returned to GPIO when the last
+ * user releases it. Drivers reach this through timer_close.
+ *
+ * Parameters
+ * ----------
+ * dev_id: timer
+ *     Timer returned by timer_open_grove
+ *
+ * Returns
+ * -------
+ *     None
+ *
+ */
+void grove_timer_close(timer dev_id);
+
+/* Start or stop the PWM output of a timer
+ *
+ * Drivers reach these through timer_pwm_generate and timer_pwm_stop. They
+ * bring the time base up to date before timer 0 is reprogrammed when PWM
+ * shares it.
+ *
+ */
+void grove_timer_pwm_generate(timer dev_id, unsigned int period,
+                              unsigned int pulse);
+void grove_timer_pwm_stop(timer dev_id);
+
+/* Read the low half of the IOP time base in timer cycles
+ *
+ * The two counters of AXI timer 0 are cascaded into a 64-bit up-counter at
+ * XPAR_TMRCTR_0_CLOCK_FREQ_HZ that drivers never reprogram. The low half
+ * wraps around, so intervals are measured as the unsigned difference of
+ * two reads. It costs a single register read, or four on an IOP with a
+ * single timer, see grove_time_us.
+ *
+ * Parameters
+ * ----------
+ *     None
+ *
+ * Returns
+ * -------
+ *     Current count in timer cycles
+ *
+ */
+unsigned int grove_timer_cycles(void);
+
+/* Read the IOP time base in microseconds
+ *
+ * The 64-bit count does not wrap in the lifetime of the IOP, so readings
+ * can be timestamped and compared directly. It costs three register reads
+ * and a division.
+ *
+ * The time base depends on AXI timer 0. On an IOP with a single timer, such
+ * as the PMOD IOP, a PWM output opened with timer_open_grove takes that
+ * timer, and while it runs time advances by counting PWM periods. Reads
+ * further apart than one period, 20 ms for a servo, lose the whole periods
+ * between them, so time runs slow while the IOP is idle; waits and
+ * timeouts that poll the time base are unaffected. The cascaded counter
+ * takes over again when the output stops.
+ *
+ * Parameters
+ * ----------
+ *     None
+ *
+ * Returns
+ * -------
+ *     Microseconds since the time base started
+ *
+ */
+unsigned long long grove_time_us(void);
+
+/* Wait until the time base reaches a deadline
+ *
+ * Unlike delay_us, a series of deadlines does not drift by the time spent
+ * between the waits.
+ *
+ * Parameters
+ * ----------
+ * deadline : unsigned long long
+ *     Time in microseconds as returned by grove_time_us
+ *
+ * Returns
+ * -------
+ *     None
+ *
+ */
+void grove_wait_until_us(unsigned long long deadline);
+
+/* Returned by the poll function of a driver while a conversion it started
+ * is still in flight. Every poll also runs the tasks of the cooperative
+ * scheduler in grove_sched.h, so conversions of other devices advance too.
+ */
+#define GROVE_PENDING 1
+
+// Periodic sampling
+/* Drivers start sampling one of their readings with a <driver>_sample
+ * function, which returns the source id carried by its samples. Readings
+ * are taken while the scheduler runs: during grove_sampler_drain and while
+ * any driver waits for a conversion.
+ */
+
+/* Samples buffered until they are drained, must be a power of two. Each
+ * takes 16 bytes of BSS, 4 KB at the default depth. */
+#ifndef GROVE_SAMPLER_DEPTH
+#define GROVE_SAMPLER_DEPTH 256
+#endif
+
+/* Words per sample returned by grove_sampler_drain: the source id, the
+ * reading as the bits of a float, then the low and high halves of the
+ * grove_time_us time it was taken at */
+#define GROVE_SAMPLE_WORDS 4
+
+/* Sample until a number of samples is buffered, then move them out
+ *
+ * Samples are returned oldest first.
+ *
+ * Parameters
+ * ----------
+ * out : unsigned int*
+ *     Destination of GROVE_SAMPLE_WORDS words per sample
+ * count : int
+ *     Largest number of samples to return, limited to GROVE_SAMPLER_DEPTH
+ * timeout_us : unsigned int
+ *     Longest time to sample for before returning fewer samples, 0 to
+ *     return the samples already buffered
+ *
+ * Returns
+ * -------
+ *     Number of samples returned
+ *
+ */
+py_int grove_sampler_drain(unsigned int *out, int count, unsigned int timeout_us);
+
+/* Stop sampling a source and drop its samples that are still buffered
+ *
+ * Its id can be handed to the next source added, so drain the readings
+ * of a source before removing it to keep them.
+ *
+ * Parameters
+ * ----------
+ * source : int
+ *     Source id returned by the <driver>_sample function
+ *
+ * Returns
+ * -------
+ *     None
+ *
+ */
+py_void grove_sampler_remove(int source);
+
+/* Number of samples lost because the ring buffer was full
+ *
+ * Parameters
+ * ----------
+ *     None
+ *
+ * Returns
+ * -------
+ *     Samples dropped since the IOP started
+ *
+ */
+py_int grove_sampler_dropped(void);
+
+// Batched calls
+/* Calls of the drivers that register batch operations, see grove_batch.h,
+ * can be sent together in one command buffer. The adapter builds the
+ * buffer in its batch context.
+ */
+
+/* Check whether a driver function can be batched
+ *
+ * Parameters
+ * ----------
+ * hash : unsigned int
+ *     FNV-1a hash of the name of the function
+ *
+ * Returns
+ * -------
+ *     1 if a driver opened so far registered the function, 0 otherwise
+ *
+ */
+py_int grove_batch_supported(unsigned int hash);
+
+/* Run the calls of a command buffer in order
+ *
+ * Parameters
+ * ----------
+ * commands : const unsigned int*
+ *     Commands in the format described in grove_batch.h
+ * words : int
+ *     Number of words in the buffer
+ * results : int*
+ *     Destination of the return value of each call
+ *
+ * Returns
+ * -------
+ *     Number of calls run, fewer than sent if a command is not supported
+ *     or truncated
+ *
+ */
+py_int grove_batch_run(const unsigned int *commands, int words, int *results);
+
+// Bus usage statistics
+/* Every i2c, gpio and analog access a driver makes through this header is
+ * attributed to a statistics slot: one per target address on an I2C bus and
+ * one per handle returned by gpio_open_grove* and analog_open_grove*. The
+ * cycle counts are taken from the AXI timer used as the IOP timebase.
+ */
+#define GROVE_STATS_MAX 16
+
+enum GROVE_STATS_TYPE {
+    GROVE_STATS_UNUSED,
+    GROVE_STATS_I2C,
+    GROVE_STATS_GPIO,
+    GROVE_STATS_ANALOG
+};
+
+enum GROVE_STATS_COUNTER {
+    GROVE_STATS_TRANSACTIONS,
+    GROVE_STATS_BYTES_READ,
+    GROVE_STATS_BYTES_WRITTEN,
+    GROVE_STATS_NAKS,
+    GROVE_STATS_CYCLES,
+    GROVE_STATS_CYCLES_HI
+};
+
+/* Get the number of statistics slots in use
+ *
+ * Parameters
+ * ----------
+ *     None
+ *
+ * Returns
+ * -------
+ *     Number of slots, valid handles are 0 to count - 1
+ *
+ */
+py_int grove_stats_count(void);
+
+/* Get the kind of interface a statistics slot is attached to
+ *
+ * Parameters
+ * ----------
+ * handle: int
+ *     Statistics slot
+ *
+ * Returns
+ * -------
+ *     GROVE_STATS_I2C, GROVE_STATS_GPIO or GROVE_STATS_ANALOG
+ *     -EINVAL if the slot is not in use (raises exception)
+ *
+ */
+py_int grove_stats_type(int handle);
+
+/* Get the Grove port the interface of a statistics slot was opened on
+ *
+ * Parameters
+ * ----------
+ * handle: int
+ *     Statistics slot
+ *
+ * Returns
+ * -------
+ *     Port id as in enum GROVE_INTERFACE
+ *     -EINVAL if the slot is not in use (raises exception)
+ *
+ */
+py_int grove_stats_port(int handle);
+
+/* Get the 7-bit target address of an I2C statistics slot
+ *
+ * Parameters
+ * ----------
+ * handle: int
+ *     Statistics slot
+ *
+ * Returns
+ * -------
+ *     I2C address, 0 for gpio and analog slots
+ *     -EINVAL if the slot is not in use (raises exception)
+ *
+ */
+py_int grove_stats_address(int handle);
+
+/* Read one counter of a statistics slot
+ *
+ * Parameters
+ * ----------
+ * handle: int
+ *     Statistics slot
+ * counter: int
+ *     One of enum GROVE_STATS_COUNTER. The cycle count is 64-bit and is
+ *     returned as GROVE_STATS_CYCLES (low word) and GROVE_STATS_CYCLES_HI.
+ *
+ * Returns
+ * -------
+ *     Unsigned counter value, 0 if the slot is not in use or the counter
+ *     is invalid
+ *
+ */
+unsigned int grove_stats_get(int handle, int counter);
+
+/* Clear the counters of all statistics slots
+ *
+ * Parameters
+ * ----------
+ *     None
+ *
+ * Returns
+ * -------
+ *     None
+ *
+ */
+py_void grove_stats_reset(void);
+
+#ifdef PYNQ_HAS_I2C
+unsigned int grove_i2c_read(i2c dev_id, unsigned int slave_address,
+                            unsigned char* buffer, unsigned int length);
+unsigned int grove_i2c_write(i2c dev_id, unsigned int slave_address,
+                             unsigned char* buffer, unsigned int length);
+#endif
+#ifdef PYNQ_HAS_GPIO
+int grove_gpio_read(gpio device);
+void grove_gpio_write(gpio device, unsigned int data);
+#endif
+py_int grove_analog_get_raw(analog dev_id);
+py_int grove_analog_get_raw_multi(const analog *devs, int n, py_int *out);
+py_float grove_analog_get_voltage(analog dev_id);
+py_int grove_analog_get_millivolts(analog dev_id);
+
+#ifndef GROVE_INTERFACES_INTERNAL
+#ifdef PYNQ_HAS_I2C
+#define i2c_read grove_i2c_read
+#define i2c_write grove_i2c_write
+#define i2c_close grove_i2c_close
+#endif
+#ifdef PYNQ_HAS_GPIO
+#define gpio_read grove_gpio_read
+#define gpio_write grove_gpio_write
+#endif
+#define analog_get_raw grove_analog_get_raw
+#define analog_get_raw_multi grove_analog_get_raw_multi
+#define analog_get_voltage grove_analog_get_voltage
+#define analog_get_millivolts grove_analog_get_millivolts
+#define timer_close grove_timer_close
+#define timer_pwm_generate grove_timer_pwm_generate
+#define timer_pwm_stop grove_timer_pwm_stop
+#endif
@@ -0,0 +1,91 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* Fixed-capacity instance pools for the Grove drivers
+ *
+ * A driver keeps the state of its open devices in a static array sized at
+ * compile time and hands out indices into it as device handles. The pool
+ * tracks which indices are in use: released indices are kept on a free
+ * list and indices that were never handed out are taken in order, so both
+ * grove_pool_alloc and grove_pool_free are O(1).
+ *
+ * Each driver sizes its table with a <MODULE>_INSTANCES macro, 4 unless
+ * defined on the compiler command line, e.g. -DGROVE_PIR_INSTANCES=8.
+ */
+
+#pragma once
+
+/* Largest supported capacity of a pool */
+#define GROVE_POOL_CAPACITY_MAX 255
+
+struct grove_pool {
+    unsigned char capacity;
+    unsigned char used;         /* indices handed out at least once */
+    unsigned char free;         /* first released index plus one, 0 if none */
+    unsigned char *next;        /* per index: next released index plus one */
+};
+
+/* Define a static pool of the given capacity */
+#define GROVE_POOL(name, capacity) \
+    static unsigned char name##_next[capacity]; \
+    static struct grove_pool name = {capacity, 0, 0, name##_next}
+
+/* Take an unused index from a pool
+ *
+ * Parameters
+ * ----------
+ * pool: struct grove_pool*
+ *     Pool defined with GROVE_POOL
+ *
+ * Returns
+ * -------
+ *     Index between 0 and the capacity of the pool - 1
+ *     -ENOMEM if all indices are in use
+ *
+ */
+int grove_pool_alloc(struct grove_pool *pool);
+
+/* Return an index to its pool
+ *
+ * Parameters
+ * ----------
+ * pool: struct grove_pool*
+ *     Pool the index was taken from
+ * index: int
+ *     Index returned by grove_pool_alloc, must not be released twice
+ *
+ * Returns
+ * -------
+ *     None
+ *
+ */
+void grove_pool_free(struct grove_pool *pool, int index);
@@ -0,0 +1,223 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* Write-through shadow cache of I2C target registers
+ *
+ * Drivers that read a configuration register only to change a few of its
+ * bits keep a grove_regcache per device. A register enters the cache the
+ * first time it is read or written through it; later reads are answered
+ * from the copy, so a read-modify-write of a cached register costs a single
+ * write on the bus. Writes always go to the device.
+ *
+ * Registers the device changes by itself (status, measurement data,
+ * self-clearing command bits) are given to grove_regcache_init as
+ * uncacheable ranges and always go to the bus. Anything that resets the
+ * device must be followed by grove_regcache_invalidate.
+ *
+ * All accesses of a driver to a cached register have to go through the
+ * cache, otherwise the copy becomes stale.
+ */
+
+#pragma once
+
+#include <i2c.h>
+
+#define GROVE_REGCACHE_ENTRIES 8
+
+struct grove_regrange {
+    unsigned char first;
+    unsigned char last;
+};
+
+struct grove_regcache {
+    i2c dev_id;
+    unsigned char address;
+    unsigned char used;
+    unsigned char next;
+    unsigned char uncached_count;
+    const struct grove_regrange *uncached;
+    unsigned char reg[GROVE_REGCACHE_ENTRIES];
+    unsigned char value[GROVE_REGCACHE_ENTRIES];
+};
+
+/* Set up an empty cache for one I2C target
+ *
+ * Parameters
+ * ----------
+ * cache: struct grove_regcache*
+ *     Cache to initialise
+ * dev_id: i2c
+ *     I2C controller returned by i2c_open_grove
+ * slave_address: unsigned int
+ *     7-bit target address
+ * uncached: const struct grove_regrange*
+ *     Inclusive register ranges that must never be cached, may be NULL
+ * count: unsigned int
+ *     Number of entries in uncached
+ *
+ * Returns
+ * -------
+ *     None
+ *
+ */
+void grove_regcache_init(struct grove_regcache *cache, i2c dev_id,
+                         unsigned int slave_address,
+                         const struct grove_regrange *uncached,
+                         unsigned int count);
+
+/* Drop every cached register, e.g. after a device reset
+ *
+ * Parameters
+ * ----------
+ * cache: struct grove_regcache*
+ *     Cache to invalidate
+ *
+ * Returns
+ * -------
+ *     None
+ *
+ */
+void grove_regcache_invalidate(struct grove_regcache *cache);
+
+/* Read a register, from the cache if it holds a copy
+ *
+ * Parameters
+ * ----------
+ * cache: struct grove_regcache*
+ *     Cache of the target
+ * reg: unsigned char
+ *     Register address
+ * value: unsigned char*
+ *     Destination of the register value
+ *
+ * Returns
+ * -------
+ *     PY_SUCCESS
+ *     -EIO if the bus access failed
+ *
+ */
+int grove_regcache_read(struct grove_regcache *cache, unsigned char reg,
+                        unsigned char *value);
+
+/* Write a register to the device and update the cached copy
+ *
+ * Parameters
+ * ----------
+ * cache: struct grove_regcache*
+ *     Cache of the target
+ * reg: unsigned char
+ *     Register address
+ * value: unsigned char
+ *     Value to write
+ *
+ * Returns
+ * -------
+ *     PY_SUCCESS
+ *     -EIO if the bus access failed, the cached copy is dropped
+ *
+ */
+int grove_regcache_write(struct grove_regcache *cache, unsigned char reg,
+                         unsigned char value);
+
+/* Write a table of register/value pairs with i2c_write_table and update
+ * the cached copies
+ *
+ * The target must auto-increment on writes, see i2c_write_table; use
+ * grove_regcache_write_pairs for targets such as the BME680.
+ *
+ * Parameters
+ * ----------
+ * cache: struct grove_regcache*
+ *     Cache of the target
+ * pairs: const unsigned char*
+ *     count pairs of register address followed by value
+ * count: unsigned int
+ *     Number of pairs
+ *
+ * Returns
+ * -------
+ *     PY_SUCCESS
+ *     -EIO if the bus access failed, copies of unwritten registers are
+ *     dropped
+ *
+ */
+int grove_regcache_write_table(struct grove_regcache *cache,
+                               const unsigned char *pairs,
+                               unsigned int count);
+
+/* Write register/value pairs as one interleaved write and update the
+ * cached copies
+ *
+ * For targets such as the BME680 that take a register address before
+ * every data byte of a write instead of auto-incrementing. The pairs are
+ * sent as they are, in a single write with one address phase.
+ *
+ * Parameters
+ * ----------
+ * cache: struct grove_regcache*
+ *     Cache of the target
+ * pairs: const unsigned char*
+ *     count pairs of register address followed by value
+ * count: unsigned int
+ *     Number of pairs
+ *
+ * Returns
+ * -------
+ *     PY_SUCCESS
+ *     -EIO if the bus access failed, the cached copies are dropped
+ *
+ */
+int grove_regcache_write_pairs(struct grove_regcache *cache,
+                               const unsigned char *pairs,
+                               unsigned int count);
+
+/* Replace the bits selected by mask in a register
+ *
+ * Parameters
+ * ----------
+ * cache: struct grove_regcache*
+ *     Cache of the target
+ * reg: unsigned char
+ *     Register address
+ * mask: unsigned char
+ *     Bits to change
+ * value: unsigned char
+ *     New value of the bits in mask, other bits are ignored
+ *
+ * Returns
+ * -------
+ *     PY_SUCCESS
+ *     -EIO if the bus access failed
+ *
+ */
+int grove_regcache_update(struct grove_regcache *cache, unsigned char reg,
+                          unsigned char mask, unsigned char value);
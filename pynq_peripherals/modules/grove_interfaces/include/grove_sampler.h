@@ -0,0 +1,88 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* Periodic sampling of driver readings into a timestamped ring buffer
+ *
+ * A driver offers one of its readings to the sampler by passing the
+ * function that takes it, together with the device handle and a period.
+ * Each source runs as a task of the scheduler in grove_sched.h, and every
+ * reading is stored with the grove_time_us time it was taken at. Python
+ * collects the readings of all sources with grove_sampler_drain, declared
+ * in grove_interfaces.h, in one call.
+ */
+
+#pragma once
+
+/* Largest number of sources sampled at the same time */
+#ifndef GROVE_SAMPLER_SOURCES
+#define GROVE_SAMPLER_SOURCES 8
+#endif
+
+/* Function that takes one reading of a device */
+typedef float (*grove_sample_fn)(int device);
+
+/* Start sampling a reading of a device
+ *
+ * Parameters
+ * ----------
+ * fn: grove_sample_fn
+ *     Function that takes the reading
+ * device: int
+ *     Device handle passed to fn
+ * period_us: unsigned int
+ *     Time between two readings in microseconds
+ *
+ * Returns
+ * -------
+ *     Source id carried by the samples of this reading
+ *     -EINVAL if the period is 0
+ *     -ENOMEM if GROVE_SAMPLER_SOURCES readings are already sampled or
+ *     the scheduler has no free task
+ *
+ */
+int grove_sampler_add(grove_sample_fn fn, int device, unsigned int period_us);
+
+/* Stop sampling every reading of a device, for drivers to call on close
+ *
+ * Parameters
+ * ----------
+ * fn: grove_sample_fn
+ *     Function given to grove_sampler_add
+ * device: int
+ *     Device handle given to grove_sampler_add
+ *
+ * Returns
+ * -------
+ *     None
+ *
+ */
+void grove_sampler_forget(grove_sample_fn fn, int device);
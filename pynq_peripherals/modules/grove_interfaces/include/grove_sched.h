@@ -0,0 +1,155 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* Cooperative scheduler for the Grove drivers
+ *
+ * Slow sensors spend most of a measurement waiting for a conversion. A
+ * driver that would block in delay_ms instead starts the conversion and
+ * registers a task: a function that does a short, bounded piece of work
+ * and returns the time it next wants to run. Tasks run to completion, one
+ * after the other, from grove_sched_run. Several drivers can therefore
+ * have conversions in flight at once, each finishing while the IOP waits
+ * for the others.
+ *
+ * The IOP is single threaded and only serves one RPC call at a time, so
+ * tasks make progress only while something calls grove_sched_run: the
+ * poll functions of the drivers, their blocking calls while they wait,
+ * and the waits of the GPIO event and analog stream buffers. Tasks must
+ * not call blocking driver functions themselves.
+ */
+
+#pragma once
+
+/* Largest number of tasks registered at the same time */
+#ifndef GROVE_SCHED_TASKS
+#define GROVE_SCHED_TASKS 16
+#endif
+
+/* Task return value that removes it from the scheduler */
+#define GROVE_SCHED_DONE 0ULL
+
+/* A task
+ *
+ * Parameters
+ * ----------
+ * arg: void*
+ *     Argument given to grove_sched_add
+ * now: unsigned long long
+ *     Time of the pass in microseconds, as returned by grove_time_us
+ *
+ * Returns
+ * -------
+ *     Time in microseconds at which to run the task again, now to run it
+ *     on every pass, or GROVE_SCHED_DONE to remove it
+ *
+ */
+typedef unsigned long long (*grove_task)(void *arg, unsigned long long now);
+
+/* Register a task
+ *
+ * Parameters
+ * ----------
+ * fn: grove_task
+ *     Function to run
+ * arg: void*
+ *     Argument passed to every run of the task
+ * wake_us: unsigned long long
+ *     Time of the first run in microseconds, 0 to run on the next pass
+ *
+ * Returns
+ * -------
+ *     Task handle
+ *     -ENOMEM if GROVE_SCHED_TASKS tasks are already registered
+ *
+ */
+int grove_sched_add(grove_task fn, void *arg, unsigned long long wake_us);
+
+/* Remove a task before it returns GROVE_SCHED_DONE
+ *
+ * A task may cancel itself; its return value is then ignored.
+ *
+ * Parameters
+ * ----------
+ * task: int
+ *     Handle returned by grove_sched_add, ignored if negative
+ *
+ * Returns
+ * -------
+ *     None
+ *
+ */
+void grove_sched_cancel(int task);
+
+/* Run every task that is due once
+ *
+ * Calls made from inside a task return at once without running anything.
+ *
+ * Parameters
+ * ----------
+ *     None
+ *
+ * Returns
+ * -------
+ *     Number of tasks run
+ *
+ */
+int grove_sched_run(void);
+
+/* Earliest wakeup of the registered tasks
+ *
+ * Parameters
+ * ----------
+ *     None
+ *
+ * Returns
+ * -------
+ *     Time in microseconds, 0 if no task is registered
+ *
+ */
+unsigned long long grove_sched_next(void);
+
+/* Run the due tasks, or wait for the next one if none was due
+ *
+ * The building block of blocking calls: a driver loops on its own poll
+ * function and yields in between, so the IOP sleeps until the earliest
+ * wakeup of any task rather than for a fixed delay.
+ *
+ * Parameters
+ * ----------
+ *     None
+ *
+ * Returns
+ * -------
+ *     None
+ *
+ */
+void grove_sched_yield(void);
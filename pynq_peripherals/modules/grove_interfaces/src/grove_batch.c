@@ -0,0 +1,108 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+#include <string.h>
+#include "grove_interfaces.h"
+#include "grove_batch.h"
+
+static struct {
+	unsigned int hash;
+	grove_batch_fn fn;
+	const struct grove_batch_op *table;
+} ops[GROVE_BATCH_OPS];
+
+static int op_count;
+
+static unsigned int name_hash(const char *name) {
+	unsigned int hash = 2166136261u;
+	while (*name) {
+		hash ^= (unsigned char)*name++;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static grove_batch_fn find(unsigned int hash) {
+	for (int i = 0; i < op_count; i++) {
+		if (ops[i].hash == hash) return ops[i].fn;
+	}
+	return 0;
+}
+
+int grove_batch_register(const struct grove_batch_op *table, int count) {
+	for (int i = 0; i < op_count; i++) {
+		if (ops[i].table == table) return PY_SUCCESS;
+	}
+	if (op_count + count > GROVE_BATCH_OPS) return -ENOMEM;
+	for (int i = 0; i < count; i++) {
+		ops[op_count].hash = name_hash(table[i].name);
+		ops[op_count].fn = table[i].fn;
+		ops[op_count].table = table;
+		op_count++;
+	}
+	return PY_SUCCESS;
+}
+
+int grove_batch_int(const struct grove_batch_args *args, unsigned int index) {
+	if (index >= args->count) return 0;
+	if (args->floats & (1u << index)) return grove_batch_float(args, index);
+	return args->words[index];
+}
+
+float grove_batch_float(const struct grove_batch_args *args,
+		unsigned int index) {
+	if (index >= args->count) return 0;
+	if (!(args->floats & (1u << index))) return (int)args->words[index];
+	float value;
+	memcpy(&value, &args->words[index], sizeof(value));
+	return value;
+}
+
+py_int grove_batch_supported(unsigned int hash) {
+	return find(hash) != 0;
+}
+
+py_int grove_batch_run(const unsigned int *commands, int words, int *results) {
+	int done = 0;
+	int i = 0;
+	while (i + 3 <= words) {
+		grove_batch_fn fn = find(commands[i]);
+		struct grove_batch_args args = {
+			&commands[i + 3], commands[i + 2] & 0xFF, commands[i + 2] >> 8
+		};
+		if (!fn || args.count > GROVE_BATCH_ARGS_MAX ||
+				i + 3 + (int)args.count > words) break;
+		results[done++] = fn(commands[i + 1], &args);
+		i += 3 + args.count;
+	}
+	return done;
+}
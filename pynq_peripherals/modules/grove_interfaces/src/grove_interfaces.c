@@ -30,9 +30,16 @@
  *
  *****************************************************************************/
 
+#define GROVE_INTERFACES_INTERNAL
 #include "grove_interfaces.h"
 #include "grove_constants.h"
+#include "grove_sched.h"
 #include <xio_switch.h>
+#include <xtmrctr.h>
+#include <xiic.h>
+#ifdef PYNQ_HAS_GPIO
+#include <xgpio.h>
+#endif
 
 enum GROVE_MAX {
 GROVE_GENERAL_MAX = ARDUINO_SEEED_D8,
@@ -76,8 +83,220 @@ unsigned char analog_pins[][2] = {
     {6, 15},
     {15, 5}
 };
+struct grove_stats {
+	int type;
+	int handle;
+	int address;
+	int port;
+	unsigned int transactions;
+	unsigned int bytes_read;
+	unsigned int bytes_written;
+	unsigned int naks;
+	unsigned long long cycles;
+};
+
+static struct grove_stats stats[GROVE_STATS_MAX];
+static int stats_used;
+
 #ifdef PYNQ_HAS_I2C
-i2c i2c_open_grove(int grove_id) {
+/* Devices sharing each I2C controller and the port it was last opened on,
+ * which also labels the per-address slots created when a new target is
+ * first accessed */
+static struct {
+	int count;
+	int port;
+	unsigned int hz;
+} i2c_bus[XPAR_XIIC_NUM_INSTANCES];
+#endif
+
+static struct grove_stats *stats_slot(int type, int handle, int address,
+		int port) {
+	for (int i = 0; i < stats_used; i++) {
+		if (stats[i].type == type && stats[i].handle == handle &&
+				stats[i].address == address) {
+			return &stats[i];
+		}
+	}
+	if (stats_used == GROVE_STATS_MAX) return 0;
+	struct grove_stats *slot = &stats[stats_used++];
+	slot->type = type;
+	slot->handle = handle;
+	slot->address = address;
+	slot->port = port;
+	return slot;
+}
+
+static struct grove_stats *stats_valid(int handle) {
+	if (handle < 0 || handle >= stats_used) return 0;
+	return &stats[handle];
+}
+
+/* AXI timer 0 is the time base of the IOP: both of its counters are
+ * cascaded into one free-running 64-bit up-counter, started on first use.
+ * Where the IOP has more timers PWM never takes it, see pwm[] below.
+ *
+ * An IOP with a single timer, such as the PMOD IOP, needs it for PWM as
+ * well. There the time base follows what timer 0 is doing: while a PWM
+ * output runs, time advances by the periods of counter 0, which counts down
+ * from TLR0 and takes two cycles to reload. A gap between two reads longer
+ * than one period loses the whole periods in it. Once PWM stops, the
+ * cascade starts again from the time reached. */
+#define GROVE_TIMEBASE_SHARED (XPAR_XTMRCTR_NUM_INSTANCES == 1)
+
+#if GROVE_TIMEBASE_SHARED
+static unsigned long long timebase_offset, timebase_last;
+static u32 timebase_phase;
+static int timebase_pwm;
+#else
+static int timebase_started;
+#endif
+
+static void timebase_cascade(void) {
+	XTmrCtr_WriteReg(XPAR_TMRCTR_0_BASEADDR, 0, TCSR0, 0);
+	XTmrCtr_WriteReg(XPAR_TMRCTR_0_BASEADDR, 0, TLR0, 0);
+	XTmrCtr_WriteReg(XPAR_TMRCTR_0_BASEADDR, 1, TLR0, 0);
+	XTmrCtr_WriteReg(XPAR_TMRCTR_0_BASEADDR, 1, TCSR0, XTC_CSR_LOAD_MASK);
+	XTmrCtr_WriteReg(XPAR_TMRCTR_0_BASEADDR, 0, TCSR0, XTC_CSR_LOAD_MASK);
+	// Counter 1 keeps reloading while LOAD is set, which pins the high half
+	XTmrCtr_WriteReg(XPAR_TMRCTR_0_BASEADDR, 1, TCSR0, 0);
+	XTmrCtr_WriteReg(XPAR_TMRCTR_0_BASEADDR, 0, TCSR0,
+			XTC_CSR_ENABLE_TMR_MASK | XTC_CSR_CASC_MASK);
+}
+
+static unsigned long long cascade_cycles(void) {
+	u32 high = XTmrCtr_ReadReg(XPAR_TMRCTR_0_BASEADDR, 1, TCR0);
+	u32 low = XTmrCtr_ReadReg(XPAR_TMRCTR_0_BASEADDR, 0, TCR0);
+	u32 check = XTmrCtr_ReadReg(XPAR_TMRCTR_0_BASEADDR, 1, TCR0);
+	// The low half wrapped between the reads, take it again
+	if (check != high) {
+		high = check;
+		low = XTmrCtr_ReadReg(XPAR_TMRCTR_0_BASEADDR, 0, TCR0);
+	}
+	return ((unsigned long long)high << 32) | low;
+}
+
+#if GROVE_TIMEBASE_SHARED
+static unsigned long long timebase_cycles(void) {
+	u32 csr = XTmrCtr_ReadReg(XPAR_TMRCTR_0_BASEADDR, 0, TCSR0);
+	const u32 running = XTC_CSR_ENABLE_PWM_MASK | XTC_CSR_ENABLE_TMR_MASK;
+	if ((csr & running) == running) {
+		u32 load = XTmrCtr_ReadReg(XPAR_TMRCTR_0_BASEADDR, 0, TLR0);
+		u32 phase = load - XTmrCtr_ReadReg(XPAR_TMRCTR_0_BASEADDR, 0, TCR0);
+		if (!timebase_pwm) {
+			timebase_pwm = 1;
+			timebase_offset = timebase_last;
+		} else if (phase < timebase_phase) {
+			timebase_offset += load + 2ULL;
+		}
+		timebase_phase = phase;
+		timebase_last = timebase_offset + phase;
+		return timebase_last;
+	}
+	if (!(csr & XTC_CSR_CASC_MASK)) {
+		// First use, or PWM has stopped
+		timebase_cascade();
+		timebase_offset = timebase_last;
+		timebase_pwm = 0;
+	}
+	timebase_last = timebase_offset + cascade_cycles();
+	return timebase_last;
+}
+
+unsigned int grove_timer_cycles(void) {
+	return (unsigned int)timebase_cycles();
+}
+
+unsigned long long grove_time_us(void) {
+	return timebase_cycles() / (XPAR_TMRCTR_0_CLOCK_FREQ_HZ / 1000000);
+}
+#else
+static void timebase_start(void) {
+	if (timebase_started) return;
+	timebase_cascade();
+	timebase_started = 1;
+}
+
+unsigned int grove_timer_cycles(void) {
+	timebase_start();
+	return XTmrCtr_ReadReg(XPAR_TMRCTR_0_BASEADDR, 0, TCR0);
+}
+
+unsigned long long grove_time_us(void) {
+	timebase_start();
+	return cascade_cycles() / (XPAR_TMRCTR_0_CLOCK_FREQ_HZ / 1000000);
+}
+#endif
+
+void grove_wait_until_us(unsigned long long deadline) {
+	while (grove_time_us() < deadline);
+}
+
+static void stats_add(struct grove_stats *slot, unsigned int start,
+		unsigned int read, unsigned int written, int nak) {
+	if (!slot) return;
+	slot->transactions++;
+	slot->bytes_read += read;
+	slot->bytes_written += written;
+	slot->naks += nak;
+	slot->cycles += grove_timer_cycles() - start;
+}
+
+py_int grove_stats_count(void) {
+	return stats_used;
+}
+
+py_int grove_stats_type(int handle) {
+	struct grove_stats *slot = stats_valid(handle);
+	if (!slot) return -EINVAL;
+	return slot->type;
+}
+
+py_int grove_stats_port(int handle) {
+	struct grove_stats *slot = stats_valid(handle);
+	if (!slot) return -EINVAL;
+	return slot->port;
+}
+
+py_int grove_stats_address(int handle) {
+	struct grove_stats *slot = stats_valid(handle);
+	if (!slot) return -EINVAL;
+	return slot->address;
+}
+
+unsigned int grove_stats_get(int handle, int counter) {
+	struct grove_stats *slot = stats_valid(handle);
+	if (!slot) return 0;
+	switch (counter) {
+	case GROVE_STATS_TRANSACTIONS:
+		return slot->transactions;
+	case GROVE_STATS_BYTES_READ:
+		return slot->bytes_read;
+	case GROVE_STATS_BYTES_WRITTEN:
+		return slot->bytes_written;
+	case GROVE_STATS_NAKS:
+		return slot->naks;
+	case GROVE_STATS_CYCLES:
+		return (unsigned int)slot->cycles;
+	case GROVE_STATS_CYCLES_HI:
+		return (unsigned int)(slot->cycles >> 32);
+	default:
+		return 0;
+	}
+}
+
+py_void grove_stats_reset(void) {
+	for (int i = 0; i < stats_used; i++) {
+		stats[i].transactions = 0;
+		stats[i].bytes_read = 0;
+		stats[i].bytes_written = 0;
+		stats[i].naks = 0;
+		stats[i].cycles = 0;
+	}
+	return PY_SUCCESS;
+}
+
+#ifdef PYNQ_HAS_I2C
+static i2c i2c_open_grove_internal(int grove_id) {
 	if (grove_id == ARDUINO_SEEED_I2C || grove_id == ARDUINO_DIGILENT_I2C) {
 		return i2c_open_device(0);
 #ifdef XPAR_IO_SWITCH_NUM_INSTANCES
@@ -91,11 +310,175 @@ i2c i2c_open_grove(int grove_id) {
 		return -1;
 	}
 }
+
+/* Base address of an I2C controller for the low-level XIic calls, 0 if
+ * the handle is invalid */
+static UINTPTR i2c_base(i2c dev_id) {
+	static UINTPTR base[XPAR_XIIC_NUM_INSTANCES];
+	if (dev_id < 0 || dev_id >= XPAR_XIIC_NUM_INSTANCES) return 0;
+	if (!base[dev_id]) {
+		XIic_Config *config = XIic_LookupConfig(dev_id);
+		if (!config) return 0;
+		base[dev_id] = config->BaseAddress;
+	}
+	return base[dev_id];
+}
+
+#ifndef GROVE_I2C_AXI_CLOCK_HZ
+#define GROVE_I2C_AXI_CLOCK_HZ XPAR_CPU_CORE_CLOCK_FREQ_HZ
+#endif
+
+/* Minimum bus timings in ns of the I2C specification for each mode */
+static const struct i2c_timing {
+	unsigned int hz;
+	unsigned short su_sta, hd_sta, su_sto, buf, su_dat, hd_dat;
+} i2c_timings[] = {
+	{GROVE_I2C_STANDARD_HZ, 4700, 4000, 4000, 4700, 250, 300},
+	{GROVE_I2C_FAST_HZ, 600, 600, 600, 1300, 100, 300},
+	{GROVE_I2C_FAST_PLUS_HZ, 260, 260, 260, 500, 50, 150},
+};
+
+static u32 i2c_cycles(unsigned int ns) {
+	return ((unsigned long long)ns * GROVE_I2C_AXI_CLOCK_HZ + 999999999) /
+			1000000000;
+}
+
+/* Program the SCL period and the START/STOP/data timings of a controller,
+ * hz must not exceed GROVE_I2C_FAST_PLUS_HZ */
+static void i2c_set_speed(i2c dev_id, unsigned int hz) {
+	UINTPTR base = i2c_base(dev_id);
+	const struct i2c_timing *t = i2c_timings;
+	u32 half = GROVE_I2C_AXI_CLOCK_HZ / hz / 2;
+	if (!base) return;
+	while (t->hz < hz) t++;
+	XIic_WriteReg(base, XIIC_TSUSTA_REG_OFFSET, i2c_cycles(t->su_sta));
+	XIic_WriteReg(base, XIIC_THDSTA_REG_OFFSET, i2c_cycles(t->hd_sta));
+	XIic_WriteReg(base, XIIC_TSUSTO_REG_OFFSET, i2c_cycles(t->su_sto));
+	XIic_WriteReg(base, XIIC_TBUF_REG_OFFSET, i2c_cycles(t->buf));
+	XIic_WriteReg(base, XIIC_TSUDAT_REG_OFFSET, i2c_cycles(t->su_dat));
+	XIic_WriteReg(base, XIIC_THDDAT_REG_OFFSET, i2c_cycles(t->hd_dat));
+	// The controller adds 7 cycles to the high and 1 to the low phase
+	XIic_WriteReg(base, XIIC_THIGH_REG_OFFSET, half - 7);
+	XIic_WriteReg(base, XIIC_TLOW_REG_OFFSET, half - 1);
+	i2c_bus[dev_id].hz = hz;
+}
+
+i2c i2c_open_grove_speed(int grove_id, unsigned int hz) {
+	i2c device = -1;
+	if (hz < GROVE_I2C_MIN_HZ) return -EINVAL;
+	if (hz > GROVE_I2C_FAST_PLUS_HZ) hz = GROVE_I2C_FAST_PLUS_HZ;
+	for (i2c dev_id = 0; dev_id < XPAR_XIIC_NUM_INSTANCES; dev_id++) {
+		if (i2c_bus[dev_id].count && i2c_bus[dev_id].port == grove_id) {
+			device = dev_id;
+			break;
+		}
+	}
+	if (device < 0) {
+		device = i2c_open_grove_internal(grove_id);
+		if (device < 0 || device >= XPAR_XIIC_NUM_INSTANCES) return device;
+		i2c_bus[device].port = grove_id;
+	}
+	// The bus runs at the speed of its slowest device
+	if (i2c_bus[device].count++ == 0 || hz < i2c_bus[device].hz) {
+		i2c_set_speed(device, hz);
+	}
+	return device;
+}
+
+i2c i2c_open_grove(int grove_id) {
+	return i2c_open_grove_speed(grove_id, GROVE_I2C_STANDARD_HZ);
+}
+
+unsigned int i2c_get_speed(i2c dev_id) {
+	if (dev_id < 0 || dev_id >= XPAR_XIIC_NUM_INSTANCES) return 0;
+	if (i2c_bus[dev_id].count == 0) return 0;
+	return i2c_bus[dev_id].hz;
+}
+
+void grove_i2c_close(i2c dev_id) {
+	if (dev_id < 0 || dev_id >= XPAR_XIIC_NUM_INSTANCES) return;
+	if (i2c_bus[dev_id].count == 0) return;
+	if (--i2c_bus[dev_id].count == 0) i2c_close(dev_id);
+}
+
+static struct grove_stats *i2c_stats(i2c dev_id, unsigned int slave_address) {
+	int port = -1;
+	if (dev_id >= 0 && dev_id < XPAR_XIIC_NUM_INSTANCES) {
+		port = i2c_bus[dev_id].port;
+	}
+	return stats_slot(GROVE_STATS_I2C, dev_id, slave_address, port);
+}
+
+unsigned int grove_i2c_read(i2c dev_id, unsigned int slave_address,
+		unsigned char* buffer, unsigned int length) {
+	unsigned int start = grove_timer_cycles();
+	unsigned int count = i2c_read(dev_id, slave_address, buffer, length);
+	stats_add(i2c_stats(dev_id, slave_address), start, count, 0,
+			count != length);
+	return count;
+}
+
+unsigned int grove_i2c_write(i2c dev_id, unsigned int slave_address,
+		unsigned char* buffer, unsigned int length) {
+	unsigned int start = grove_timer_cycles();
+	unsigned int count = i2c_write(dev_id, slave_address, buffer, length);
+	stats_add(i2c_stats(dev_id, slave_address), start, 0, count,
+			count != length);
+	return count;
+}
+
+unsigned int i2c_read_reg(i2c dev_id, unsigned int slave_address,
+		unsigned char reg, unsigned char* buffer, unsigned int length) {
+	UINTPTR base = i2c_base(dev_id);
+	unsigned int start = grove_timer_cycles();
+	unsigned int sent, count = 0;
+	if (!base) return 0;
+	sent = XIic_Send(base, slave_address, &reg, 1, XIIC_REPEATED_START);
+	if (sent == 1) {
+		count = XIic_Recv(base, slave_address, buffer, length, XIIC_STOP);
+	}
+	stats_add(i2c_stats(dev_id, slave_address), start, count, sent,
+			count != length);
+	return count;
+}
+
+unsigned int i2c_write_table(i2c dev_id, unsigned int slave_address,
+		const unsigned char* pairs, unsigned int count) {
+	unsigned char burst[GROVE_I2C_BURST_MAX + 1];
+	UINTPTR base = i2c_base(dev_id);
+	unsigned int start = grove_timer_cycles();
+	unsigned int done = 0, written = 0;
+	if (!base) return 0;
+	while (done < count) {
+		const unsigned char *run = pairs + 2 * done;
+		unsigned int length = 1;
+		while (done + length < count && length < GROVE_I2C_BURST_MAX &&
+				run[2 * length] == run[0] + length) {
+			length++;
+		}
+		burst[0] = run[0];
+		for (unsigned int i = 0; i < length; i++) {
+			burst[i + 1] = run[2 * i + 1];
+		}
+		// Keep the bus between bursts, release it after the last one
+		unsigned int sent = XIic_Send(base, slave_address, burst,
+				length + 1, done + length == count ?
+				XIIC_STOP : XIIC_REPEATED_START);
+		written += sent;
+		if (sent != length + 1) break;
+		done += length;
+	}
+	stats_add(i2c_stats(dev_id, slave_address), start, 0, written,
+			done != count);
+	return done;
+}
 #endif
 
 #ifdef PYNQ_HAS_GPIO
 static gpio gpio_open_grove_internal(int grove_id, int pin_id) {
-	return gpio_open(digital_pins[grove_id][pin_id]);
+	gpio device = gpio_open(digital_pins[grove_id][pin_id]);
+	if (device >= 0) stats_slot(GROVE_STATS_GPIO, device, 0, grove_id);
+	return device;
 };
 
 gpio gpio_open_grove(int grove_id) {
@@ -107,6 +490,169 @@ gpio gpio_open_grove_a(int grove_id) {
 gpio gpio_open_grove_b(int grove_id) {
 	return gpio_open_grove_internal(grove_id, 1);
 }
+
+/* gpio handles carry the device, the pin range and the channel in the
+ * same bytes as the BSP encodes them */
+#define GPIO_LOW(g)     (((g) >> 8) & 0xFF)
+#define GPIO_CHANNEL(g) (((g) >> 24) & 0xFF)
+
+gpio gpio_open_grove_pair(int grove_id) {
+	unsigned int a = digital_pins[grove_id][0];
+	unsigned int b = digital_pins[grove_id][1];
+	// Route both pins to the GPIO block, then span them with one handle
+	if (gpio_open(a) < 0 || gpio_open(b) < 0) return -1;
+	gpio device = a < b ? gpio_configure(gpio_open_device(0), a, b, 1) :
+			gpio_configure(gpio_open_device(0), b, a, 1);
+	if (device >= 0) stats_slot(GROVE_STATS_GPIO, device, 0, grove_id);
+	return device;
+}
+
+unsigned int gpio_grove_pair_mask(int grove_id, int pin_id) {
+	unsigned int a = digital_pins[grove_id][0];
+	unsigned int b = digital_pins[grove_id][1];
+	return 1u << (digital_pins[grove_id][pin_id] - (a < b ? a : b));
+}
+
+void gpio_write_sequence(gpio device, unsigned int mask,
+		const unsigned int *values, unsigned int count) {
+	unsigned int start = grove_timer_cycles();
+	u32 offset = GPIO_CHANNEL(device) == 2 ? XGPIO_DATA2_OFFSET :
+			XGPIO_DATA_OFFSET;
+	unsigned int shift = GPIO_LOW(device);
+	// Only masked pins change, so the other pins are read once
+	u32 other = XGpio_ReadReg(XPAR_GPIO_0_BASEADDR, offset) & ~(mask << shift);
+	for (unsigned int i = 0; i < count; i++) {
+		XGpio_WriteReg(XPAR_GPIO_0_BASEADDR, offset,
+				other | ((values[i] & mask) << shift));
+	}
+	stats_add(stats_slot(GROVE_STATS_GPIO, device, 0, -1), start, 1, count,
+			0);
+}
+
+void gpio_write_mask(gpio device, unsigned int mask, unsigned int value) {
+	gpio_write_sequence(device, mask, &value, 1);
+}
+
+static struct {
+	gpio device;
+	unsigned char edges;	// 0 if the slot is free
+	unsigned char level;
+} watches[GROVE_GPIO_WATCHES];
+
+static unsigned int events[GROVE_GPIO_EVENT_DEPTH][GROVE_GPIO_EVENT_WORDS];
+static unsigned int event_head, event_count, events_dropped;
+static int event_task = -1;
+
+// Samples the watched pins on every pass of the scheduler
+static unsigned long long event_run(void *arg, unsigned long long now) {
+	for (int i = 0; i < GROVE_GPIO_WATCHES; i++) {
+		if (watches[i].edges) {
+			gpio_event_poll();
+			return now;
+		}
+	}
+	event_task = -1;
+	return GROVE_SCHED_DONE;
+}
+
+py_int gpio_event_watch(gpio device, int edges) {
+	if (device < 0 || !(edges & GROVE_GPIO_BOTH)) return -EINVAL;
+	for (int i = 0; i < GROVE_GPIO_WATCHES; i++) {
+		if (watches[i].edges) continue;
+		if (event_task < 0) {
+			int task = grove_sched_add(event_run, 0, 0);
+			if (task < 0) return task;
+			event_task = task;
+		}
+		watches[i].device = device;
+		watches[i].edges = edges & GROVE_GPIO_BOTH;
+		watches[i].level = gpio_read(device) & 1;
+		return i;
+	}
+	return -ENOMEM;
+}
+
+py_void gpio_event_unwatch(int watch) {
+	if (watch >= 0 && watch < GROVE_GPIO_WATCHES) watches[watch].edges = 0;
+	return PY_SUCCESS;
+}
+
+py_int gpio_event_poll(void) {
+	// One read of each data register covers every watched pin
+	u32 data[2];
+	int sampled[2] = {0, 0};
+	unsigned long long now = 0;
+	int captured = 0;
+	for (int i = 0; i < GROVE_GPIO_WATCHES; i++) {
+		if (!watches[i].edges) continue;
+		int channel = GPIO_CHANNEL(watches[i].device) == 2;
+		if (!sampled[channel]) {
+			data[channel] = XGpio_ReadReg(XPAR_GPIO_0_BASEADDR,
+					channel ? XGPIO_DATA2_OFFSET : XGPIO_DATA_OFFSET);
+			now = grove_time_us();
+			sampled[channel] = 1;
+		}
+		unsigned int level = (data[channel] >>
+				GPIO_LOW(watches[i].device)) & 1;
+		if (level == watches[i].level) continue;
+		watches[i].level = level;
+		if (!(watches[i].edges &
+				(level ? GROVE_GPIO_RISING : GROVE_GPIO_FALLING))) continue;
+		if (event_count == GROVE_GPIO_EVENT_DEPTH) {
+			events_dropped++;
+			continue;
+		}
+		unsigned int *event = events[(event_head + event_count) &
+				(GROVE_GPIO_EVENT_DEPTH - 1)];
+		event[0] = (i << 1) | level;
+		event[1] = (unsigned int)now;
+		event[2] = (unsigned int)(now >> 32);
+		event_count++;
+		captured++;
+	}
+	return captured;
+}
+
+py_int gpio_event_wait(int count, unsigned int timeout_us) {
+	unsigned long long deadline = grove_time_us() + timeout_us;
+	if (count > GROVE_GPIO_EVENT_DEPTH) count = GROVE_GPIO_EVENT_DEPTH;
+	gpio_event_poll();
+	while ((int)event_count < count && grove_time_us() < deadline) {
+		gpio_event_poll();
+		grove_sched_run();
+	}
+	return event_count;
+}
+
+py_int gpio_event_read(unsigned int *out, int count) {
+	gpio_event_poll();
+	if (count < 0) count = 0;
+	if ((unsigned int)count > event_count) count = event_count;
+	for (int i = 0; i < count; i++) {
+		for (int w = 0; w < GROVE_GPIO_EVENT_WORDS; w++)
+			out[GROVE_GPIO_EVENT_WORDS * i + w] = events[event_head][w];
+		event_head = (event_head + 1) & (GROVE_GPIO_EVENT_DEPTH - 1);
+	}
+	event_count -= count;
+	return count;
+}
+
+py_int gpio_event_dropped(void) {
+	return events_dropped;
+}
+
+int grove_gpio_read(gpio device) {
+	unsigned int start = grove_timer_cycles();
+	int value = gpio_read(device);
+	stats_add(stats_slot(GROVE_STATS_GPIO, device, 0, -1), start, 1, 0, 0);
+	return value;
+}
+
+void grove_gpio_write(gpio device, unsigned int data) {
+	unsigned int start = grove_timer_cycles();
+	gpio_write(device, data);
+	stats_add(stats_slot(GROVE_STATS_GPIO, device, 0, -1), start, 0, 1, 0);
+}
 #endif
 
 #ifdef PYNQ_HAS_UART
@@ -122,7 +668,10 @@ uart uart_open_grove(int grove_id) {
 
 static analog analog_open_grove_internal(int grove_id, int pin) {
 	if (grove_id >= ARDUINO_DIGILENT_A1 && grove_id <= ARDUINO_SEEED_A3) {
-		return analog_open_xadc(analog_pins[grove_id - ARDUINO_DIGILENT_A1][pin]);
+		analog device = analog_open_xadc(
+				analog_pins[grove_id - ARDUINO_DIGILENT_A1][pin]);
+		if (device >= 0) stats_slot(GROVE_STATS_ANALOG, device, 0, grove_id);
+		return device;
 	} else {
 		return -1;
 	}
@@ -138,13 +687,112 @@ analog analog_open_grove_b(int grove_id) {
 	return analog_open_grove_internal(grove_id, 1);
 }
 
+py_int grove_analog_get_raw(analog dev_id) {
+	unsigned int start = grove_timer_cycles();
+	py_int value = analog_get_raw(dev_id);
+	stats_add(stats_slot(GROVE_STATS_ANALOG, dev_id, 0, -1), start, 2, 0,
+			value < 0);
+	return value;
+}
+
+py_int grove_analog_get_raw_multi(const analog *devs, int n, py_int *out) {
+	unsigned int start = grove_timer_cycles();
+	py_int ret = analog_get_raw_multi(devs, n, out);
+	if (n <= 0) return ret;
+	// The conversion cycle is shared, so is the time spent waiting for it
+	unsigned int share = (grove_timer_cycles() - start) / n;
+	for (int i = 0; i < n; i++) {
+		stats_add(stats_slot(GROVE_STATS_ANALOG, devs[i], 0, -1),
+				grove_timer_cycles() - share, 2, 0, out[i] < 0);
+	}
+	return ret;
+}
+
+py_int grove_analog_get_millivolts(analog dev_id) {
+	unsigned int start = grove_timer_cycles();
+	py_int value = analog_get_millivolts(dev_id);
+	stats_add(stats_slot(GROVE_STATS_ANALOG, dev_id, 0, -1), start, 2, 0,
+			value < 0);
+	return value;
+}
+
+py_float grove_analog_get_voltage(analog dev_id) {
+	unsigned int start = grove_timer_cycles();
+	py_float value = analog_get_voltage(dev_id);
+	stats_add(stats_slot(GROVE_STATS_ANALOG, dev_id, 0, -1), start, 2, 0, 0);
+	return value;
+}
+
+/* The IO switch routes a pin to PWM channel n, driven by AXI timer n.
+ * Channel 0 belongs to the time base unless the IOP has a single timer,
+ * such as the PMOD IOP, where the two share it. */
+#ifndef GROVE_PWM_CHANNELS
+#define GROVE_PWM_CHANNELS (XPAR_XTMRCTR_NUM_INSTANCES < 6 ? \
+		XPAR_XTMRCTR_NUM_INSTANCES : 6)
+#endif
+#define GROVE_PWM_FIRST (GROVE_TIMEBASE_SHARED ? 0 : 1)
+
+static struct {
+	int count;
+	unsigned int pin;
+} pwm[GROVE_PWM_CHANNELS];
+
 static timer timer_open_grove_internal(int grove_id, int pin_id) {
-   timer device = timer_open_device(0);
-   init_io_switch();
-   set_pin(digital_pins[grove_id][pin_id], PWM0);
+	unsigned int pin = digital_pins[grove_id][pin_id];
+	int channel = -1;
+	for (int i = GROVE_PWM_FIRST; i < GROVE_PWM_CHANNELS; i++) {
+		if (pwm[i].count && pwm[i].pin == pin) {
+			pwm[i].count++;
+			return i;
+		}
+	}
+	for (int i = GROVE_PWM_FIRST; i < GROVE_PWM_CHANNELS; i++) {
+		if (!pwm[i].count) {
+			channel = i;
+			break;
+		}
+	}
+	if (channel < 0) return -EBUSY;
+	timer device = timer_open_device(channel);
+	if (device < 0) return -ENODEV;
+	// Only this pin is routed, the rest of the switch keeps its routes
+	set_pin(pin, PWM0 + channel);
+	pwm[channel].count = 1;
+	pwm[channel].pin = pin;
 	return device;
 };
 
+void grove_timer_close(timer dev_id) {
+	if (dev_id < GROVE_PWM_FIRST || dev_id >= GROVE_PWM_CHANNELS ||
+			!pwm[dev_id].count)
+		return;
+	if (--pwm[dev_id].count) return;
+#if GROVE_TIMEBASE_SHARED
+	timebase_cycles();
+#endif
+	timer_close(dev_id);
+	set_pin(pwm[dev_id].pin, GPIO);
+}
+
+void grove_timer_pwm_generate(timer dev_id, unsigned int period,
+		unsigned int pulse) {
+#if GROVE_TIMEBASE_SHARED
+	// Bring the time base up to date before the period restarts
+	if (dev_id == 0) {
+		timebase_cycles();
+		timebase_pwm = 0;
+	}
+#endif
+	timer_pwm_generate(dev_id, period, pulse);
+}
+
+void grove_timer_pwm_stop(timer dev_id) {
+#if GROVE_TIMEBASE_SHARED
+	if (dev_id == 0) timebase_cycles();
+#endif
+	timer_pwm_stop(dev_id);
+}
+
 timer timer_open_grove(int grove_id) {
 	return timer_open_grove_internal(grove_id, 0);
 }
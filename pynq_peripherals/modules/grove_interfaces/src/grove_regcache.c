@@ -0,0 +1,153 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+#include "grove_interfaces.h"
+#include "grove_regcache.h"
+
+static int regcache_find(struct grove_regcache *cache, unsigned char reg) {
+	for (int i = 0; i < cache->used; i++) {
+		if (cache->reg[i] == reg) return i;
+	}
+	return -1;
+}
+
+static int regcache_cacheable(struct grove_regcache *cache,
+		unsigned char reg) {
+	for (int i = 0; i < cache->uncached_count; i++) {
+		if (reg >= cache->uncached[i].first &&
+				reg <= cache->uncached[i].last) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/* Store a copy of a register, replacing entries round-robin once full */
+static void regcache_store(struct grove_regcache *cache, unsigned char reg,
+		unsigned char value) {
+	int i = regcache_find(cache, reg);
+	if (i < 0) {
+		if (!regcache_cacheable(cache, reg)) return;
+		if (cache->used < GROVE_REGCACHE_ENTRIES) {
+			i = cache->used++;
+		} else {
+			i = cache->next;
+			cache->next = (cache->next + 1) % GROVE_REGCACHE_ENTRIES;
+		}
+		cache->reg[i] = reg;
+	}
+	cache->value[i] = value;
+}
+
+/* Forget a register whose content is unknown after a failed write */
+static void regcache_drop(struct grove_regcache *cache, unsigned char reg) {
+	int i = regcache_find(cache, reg);
+	if (i < 0) return;
+	cache->used--;
+	cache->reg[i] = cache->reg[cache->used];
+	cache->value[i] = cache->value[cache->used];
+}
+
+void grove_regcache_init(struct grove_regcache *cache, i2c dev_id,
+		unsigned int slave_address, const struct grove_regrange *uncached,
+		unsigned int count) {
+	cache->dev_id = dev_id;
+	cache->address = slave_address;
+	cache->uncached = uncached;
+	cache->uncached_count = uncached ? count : 0;
+	grove_regcache_invalidate(cache);
+}
+
+void grove_regcache_invalidate(struct grove_regcache *cache) {
+	cache->used = 0;
+	cache->next = 0;
+}
+
+int grove_regcache_read(struct grove_regcache *cache, unsigned char reg,
+		unsigned char *value) {
+	int i = regcache_find(cache, reg);
+	if (i >= 0) {
+		*value = cache->value[i];
+		return PY_SUCCESS;
+	}
+	if (i2c_read_reg(cache->dev_id, cache->address, reg, value, 1) != 1) {
+		return -EIO;
+	}
+	regcache_store(cache, reg, *value);
+	return PY_SUCCESS;
+}
+
+int grove_regcache_write(struct grove_regcache *cache, unsigned char reg,
+		unsigned char value) {
+	unsigned char buffer[2] = {reg, value};
+	if (i2c_write(cache->dev_id, cache->address, buffer, 2) != 2) {
+		regcache_drop(cache, reg);
+		return -EIO;
+	}
+	regcache_store(cache, reg, value);
+	return PY_SUCCESS;
+}
+
+int grove_regcache_write_table(struct grove_regcache *cache,
+		const unsigned char *pairs, unsigned int count) {
+	unsigned int written = i2c_write_table(cache->dev_id, cache->address,
+			pairs, count);
+	for (unsigned int i = 0; i < count; i++) {
+		if (i < written) {
+			regcache_store(cache, pairs[2 * i], pairs[2 * i + 1]);
+		} else {
+			regcache_drop(cache, pairs[2 * i]);
+		}
+	}
+	return written == count ? PY_SUCCESS : -EIO;
+}
+
+int grove_regcache_write_pairs(struct grove_regcache *cache,
+		const unsigned char *pairs, unsigned int count) {
+	int ok = i2c_write(cache->dev_id, cache->address,
+			(unsigned char *)pairs, 2 * count) == 2 * count;
+	for (unsigned int i = 0; i < count; i++) {
+		if (ok) {
+			regcache_store(cache, pairs[2 * i], pairs[2 * i + 1]);
+		} else {
+			regcache_drop(cache, pairs[2 * i]);
+		}
+	}
+	return ok ? PY_SUCCESS : -EIO;
+}
+
+int grove_regcache_update(struct grove_regcache *cache, unsigned char reg,
+		unsigned char mask, unsigned char value) {
+	unsigned char old;
+	if (grove_regcache_read(cache, reg, &old) != PY_SUCCESS) return -EIO;
+	return grove_regcache_write(cache, reg, (old & ~mask) | (value & mask));
+}
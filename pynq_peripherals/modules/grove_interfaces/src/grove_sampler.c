@@ -0,0 +1,151 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+#include <string.h>
+#include "grove_interfaces.h"
+#include "grove_sched.h"
+#include "grove_sampler.h"
+
+struct sampler_source {
+	grove_sample_fn fn;	// 0 if the slot is free
+	int device;
+	int task;
+	unsigned int period;
+	unsigned long long next;
+};
+
+struct sample {
+	unsigned int source;
+	float value;
+	unsigned long long time;
+};
+
+static struct sampler_source sources[GROVE_SAMPLER_SOURCES];
+static struct sample samples[GROVE_SAMPLER_DEPTH];
+static unsigned int sample_head, sample_count, samples_dropped;
+
+// Takes one reading of a source and asks to run again a period later
+static unsigned long long sample_run(void *arg, unsigned long long now) {
+	struct sampler_source *s = (struct sampler_source *)arg;
+	float value = s->fn(s->device);
+	if (sample_count == GROVE_SAMPLER_DEPTH) {
+		samples_dropped++;
+	} else {
+		struct sample *sample = &samples[(sample_head + sample_count) &
+				(GROVE_SAMPLER_DEPTH - 1)];
+		sample->source = s - sources;
+		sample->value = value;
+		sample->time = now;
+		sample_count++;
+	}
+	s->next += s->period;
+	// Readings missed while the scheduler did not run are not made up for
+	if (s->next <= now) s->next = now + s->period;
+	return s->next;
+}
+
+int grove_sampler_add(grove_sample_fn fn, int device, unsigned int period_us) {
+	if (!period_us) return -EINVAL;
+	for (int i = 0; i < GROVE_SAMPLER_SOURCES; i++) {
+		struct sampler_source *s = &sources[i];
+		if (s->fn) continue;
+		s->next = grove_time_us();
+		s->task = grove_sched_add(sample_run, s, s->next);
+		if (s->task < 0) return -ENOMEM;
+		s->fn = fn;
+		s->device = device;
+		s->period = period_us;
+		return i;
+	}
+	return -ENOMEM;
+}
+
+void grove_sampler_forget(grove_sample_fn fn, int device) {
+	for (int i = 0; i < GROVE_SAMPLER_SOURCES; i++) {
+		if (sources[i].fn == fn && sources[i].device == device)
+			grove_sampler_remove(i);
+	}
+}
+
+// Drops the buffered samples of a source, keeping the others in order
+static void samples_discard(unsigned int source) {
+	unsigned int kept = 0;
+	for (unsigned int i = 0; i < sample_count; i++) {
+		struct sample *sample = &samples[(sample_head + i) &
+				(GROVE_SAMPLER_DEPTH - 1)];
+		if (sample->source == source) continue;
+		samples[(sample_head + kept) & (GROVE_SAMPLER_DEPTH - 1)] = *sample;
+		kept++;
+	}
+	sample_count = kept;
+}
+
+py_void grove_sampler_remove(int source) {
+	if (source < 0 || source >= GROVE_SAMPLER_SOURCES || !sources[source].fn)
+		return PY_SUCCESS;
+	grove_sched_cancel(sources[source].task);
+	sources[source].fn = 0;
+	// The slot is reused at once, so its readings must not outlive it
+	samples_discard(source);
+	return PY_SUCCESS;
+}
+
+py_int grove_sampler_drain(unsigned int *out, int count,
+		unsigned int timeout_us) {
+	unsigned long long deadline = grove_time_us() + timeout_us;
+	if (count < 0) count = 0;
+	if (count > GROVE_SAMPLER_DEPTH) count = GROVE_SAMPLER_DEPTH;
+	grove_sched_run();
+	while ((int)sample_count < count) {
+		unsigned long long now = grove_time_us();
+		if (now >= deadline) break;
+		unsigned long long next = grove_sched_next();
+		grove_wait_until_us(next && next < deadline ? next : deadline);
+		grove_sched_run();
+	}
+	if ((unsigned int)count > sample_count) count = sample_count;
+	for (int i = 0; i < count; i++) {
+		struct sample *sample = &samples[sample_head];
+		out[GROVE_SAMPLE_WORDS * i] = sample->source;
+		memcpy(&out[GROVE_SAMPLE_WORDS * i + 1], &sample->value,
+				sizeof(sample->value));
+		out[GROVE_SAMPLE_WORDS * i + 2] = sample->time;
+		out[GROVE_SAMPLE_WORDS * i + 3] = sample->time >> 32;
+		sample_head = (sample_head + 1) & (GROVE_SAMPLER_DEPTH - 1);
+	}
+	sample_count -= count;
+	return count;
+}
+
+py_int grove_sampler_dropped(void) {
+	return samples_dropped;
+}
@@ -0,0 +1,95 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+#include "grove_interfaces.h"
+#include "grove_sched.h"
+
+static struct {
+	grove_task fn;		// 0 if the slot is free
+	void *arg;
+	unsigned long long wake;
+	unsigned int generation;	// bumped each time the slot is taken
+} tasks[GROVE_SCHED_TASKS];
+
+static int running;
+
+int grove_sched_add(grove_task fn, void *arg, unsigned long long wake_us) {
+	for (int i = 0; i < GROVE_SCHED_TASKS; i++) {
+		if (tasks[i].fn) continue;
+		tasks[i].fn = fn;
+		tasks[i].arg = arg;
+		tasks[i].wake = wake_us;
+		tasks[i].generation++;
+		return i;
+	}
+	return -ENOMEM;
+}
+
+void grove_sched_cancel(int task) {
+	if (task >= 0 && task < GROVE_SCHED_TASKS) tasks[task].fn = 0;
+}
+
+int grove_sched_run(void) {
+	if (running) return 0;
+	running = 1;
+	unsigned long long now = grove_time_us();
+	int ran = 0;
+	for (int i = 0; i < GROVE_SCHED_TASKS; i++) {
+		grove_task fn = tasks[i].fn;
+		if (!fn || tasks[i].wake > now) continue;
+		unsigned int generation = tasks[i].generation;
+		unsigned long long wake = fn(tasks[i].arg, now);
+		ran++;
+		// The task may have cancelled itself, or been replaced by another,
+		// even one added again with the same function
+		if (!tasks[i].fn || tasks[i].generation != generation) continue;
+		if (wake == GROVE_SCHED_DONE) tasks[i].fn = 0;
+		else tasks[i].wake = wake;
+	}
+	running = 0;
+	return ran;
+}
+
+unsigned long long grove_sched_next(void) {
+	unsigned long long next = 0;
+	for (int i = 0; i < GROVE_SCHED_TASKS; i++) {
+		if (tasks[i].fn && (!next || tasks[i].wake < next))
+			next = tasks[i].wake;
+	}
+	return next;
+}
+
+void grove_sched_yield(void) {
+	if (grove_sched_run() || running) return;
+	unsigned long long next = grove_sched_next();
+	if (next) grove_wait_until_us(next);
+}
@@ -40,7 +40,7 @@
 /* Joystick class
  *
  * Available Methods:
- *    open, close, x, y, is_clicked
+ *    open, close, x, y, is_clicked, fetch, get_x, get_y, get_clicked
  *    
  */
 typedef py_int grove_joystick;
@@ -120,3 +120,55 @@ py_float grove_joystick_y(grove_joystick joystick);
  *     A 1 value if joystick is clicked
  */
 py_int grove_joystick_is_clicked(grove_joystick joystick);
+
+/* Fetch the position of both axes of the Joystick
+ * 
+ * Reads X and Y from the same analog conversion cycle and stores them
+ * into this object. To get the stored position call get_x, get_y or
+ * get_clicked.
+ * 
+ * Parameters
+ * ----------
+ *     None
+ * 
+ * Returns
+ * -------
+ *     0 if successful
+ *     -EIO if an axis could not be read (raises exception)
+ */
+py_void grove_joystick_fetch(grove_joystick joystick);
+
+/* Returns the X-Coordinate stored by the last fetch
+ * 
+ * Parameters
+ * ----------
+ *     None
+ * 
+ * Returns
+ * -------
+ *     A float value if successful
+ */
+py_float grove_joystick_get_x(grove_joystick joystick);
+
+/* Returns the Y-Coordinate stored by the last fetch
+ * 
+ * Parameters
+ * ----------
+ *     None
+ * 
+ * Returns
+ * -------
+ *     A float value if successful
+ */
+py_float grove_joystick_get_y(grove_joystick joystick);
+
+/* Returns whether the Joystick was clicked at the last fetch
+ * 
+ * Parameters
+ * ----------
+ *     None
+ * Returns
+ * -------
+ *     A 1 value if joystick is clicked
+ */
+py_int grove_joystick_get_clicked(grove_joystick joystick);
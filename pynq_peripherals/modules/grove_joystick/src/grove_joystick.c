@@ -31,17 +31,23 @@
  *****************************************************************************/
 
 #include <grove_interfaces.h>
+#include <grove_pool.h>
 #include <grove_joystick.h>
 
-#define DEVICE_MAX 4
+#ifndef GROVE_JOYSTICK_INSTANCES
+#define GROVE_JOYSTICK_INSTANCES 4
+#endif
 
 struct info {
     analog X;
     analog Y;
     int count;
+    py_int x_raw;
+    py_int y_raw;
 };
 
-static struct info info[DEVICE_MAX];
+static struct info info[GROVE_JOYSTICK_INSTANCES];
+GROVE_POOL(pool, GROVE_JOYSTICK_INSTANCES);
 
 /*
  * Documentation for public functions is provided as part of the external 
@@ -63,10 +69,7 @@ static struct info info[DEVICE_MAX];
  * 
  */
 static int next_index() {
-    for (int i = 0; i < DEVICE_MAX; ++i) {
-        if (info[i].count == 0) return i;
-    }
-    return -ENOMEM;
+    return grove_pool_alloc(&pool);
 }
 grove_joystick grove_joystick_open(int grove_id) {
     grove_joystick dev_id = next_index();
@@ -84,20 +87,37 @@ void grove_joystick_close(grove_joystick joystick) {
     analog Y = info[joystick].Y;
     analog_close(X);
     analog_close(Y);
+    grove_pool_free(&pool, joystick);
+}
+
+/* Convert a raw reading of one axis to a position
+ * 
+ * Parameters
+ * ----------
+ * pin: analog
+ *     Analog input of the axis
+ * raw: int
+ *     Raw value read from the input
+ * 
+ * Return
+ * ------
+ * float
+ *     The position of the axis
+ * 
+ */
+static float position(analog pin, int raw) {
+    int max = analog_get_max(pin);
+    return (float)(max-raw)*10/raw;
 }
 
 py_float grove_joystick_x(grove_joystick joystick) {
     analog X = info[joystick].X;
-    int x_raw = analog_get_raw(X);
-    int x_max = analog_get_max(X);
-    return (float)(x_max-x_raw)*10/x_raw;
+    return position(X, analog_get_raw(X));
 }
 
 py_float grove_joystick_y(grove_joystick joystick) {
     analog Y = info[joystick].Y;
-    int y_raw = analog_get_raw(Y);
-    int y_max = analog_get_max(Y);
-    return (float)(y_max-y_raw)*10/y_raw;
+    return position(Y, analog_get_raw(Y));
 }
 
 py_int grove_joystick_is_clicked(grove_joystick joystick) {
@@ -107,4 +127,29 @@ py_int grove_joystick_is_clicked(grove_joystick joystick) {
     } else {
         return PY_SUCCESS;
     }
+}
+
+py_void grove_joystick_fetch(grove_joystick joystick) {
+    analog pins[2] = {info[joystick].X, info[joystick].Y};
+    py_int raw[2];
+    if (analog_get_raw_multi(pins, 2, raw) != PY_SUCCESS) return -EIO;
+    info[joystick].x_raw = raw[0];
+    info[joystick].y_raw = raw[1];
+    return PY_SUCCESS;
+}
+
+py_float grove_joystick_get_x(grove_joystick joystick) {
+    return position(info[joystick].X, info[joystick].x_raw);
+}
+
+py_float grove_joystick_get_y(grove_joystick joystick) {
+    return position(info[joystick].Y, info[joystick].y_raw);
+}
+
+py_int grove_joystick_get_clicked(grove_joystick joystick) {
+    if (grove_joystick_get_x(joystick) < 0.1) {
+        return 1;
+    } else {
+        return PY_SUCCESS;
+    }
 }
\ No newline at end of file
@@ -31,6 +31,8 @@
  *****************************************************************************/
 
 #include <grove_interfaces.h>
+#include <grove_pool.h>
+#include <grove_batch.h>
 #include <grove_led_stick.h>
 #include <gpio.h>
 #include <xgpio.h>
@@ -39,7 +41,9 @@
 #define TIMER_ADDR 0x41C00000
 #define PMOD_ADDR 0x40000000
 #define ARDUINO_ADDR 0x40020000
-#define DEVICE_MAX 4
+#ifndef GROVE_LED_STICK_INSTANCES
+#define GROVE_LED_STICK_INSTANCES 4
+#endif
 #define LED_MAX 10
 
 extern const unsigned char digital_pins[][2];
@@ -52,7 +56,8 @@ struct info {
     unsigned int addr;
 };
 
-static struct info info[DEVICE_MAX];
+static struct info info[GROVE_LED_STICK_INSTANCES];
+GROVE_POOL(pool, GROVE_LED_STICK_INSTANCES);
 
 /*
  * Documentation for public functions is provided as part of the external 
@@ -74,10 +79,7 @@ static struct info info[DEVICE_MAX];
  * 
  */
 static int next_index() {
-    for (int i = 0; i < DEVICE_MAX; ++i) {
-        if (info[i].count == 0) return i;
-    }
-    return -ENOMEM;
+    return grove_pool_alloc(&pool);
 }
 
 /* Create a zero signal to write to the LED
@@ -137,6 +139,25 @@ static void write_one(unsigned int gpio_addr, unsigned int high, unsigned int lo
     XGpio_WriteReg(gpio_addr, 0, low);
 }
 
+static int batch_show(int dev, const struct grove_batch_args *args) {
+    return grove_led_stick_show(dev);
+}
+
+static int batch_set_pixel(int dev, const struct grove_batch_args *args) {
+    return grove_led_stick_set_pixel(dev, grove_batch_int(args, 0),
+                                     grove_batch_int(args, 1));
+}
+
+static int batch_clear(int dev, const struct grove_batch_args *args) {
+    return grove_led_stick_clear(dev);
+}
+
+static const struct grove_batch_op batch_ops[] = {
+    {"grove_led_stick_show", batch_show},
+    {"grove_led_stick_set_pixel", batch_set_pixel},
+    {"grove_led_stick_clear", batch_clear},
+};
+
 grove_led_stick grove_led_stick_open(int grove_id) {
     grove_led_stick dev_id = next_index();
     if (dev_id >= 0) {
@@ -149,6 +170,7 @@ grove_led_stick grove_led_stick_open(int grove_id) {
             info[dev_id].addr = PMOD_ADDR;
         }
         gpio_set_direction(info[dev_id].pin, GPIO_OUT);
+        grove_batch_register(batch_ops, sizeof(batch_ops) / sizeof(batch_ops[0]));
     }
     return dev_id;
 }
@@ -159,6 +181,7 @@ void grove_led_stick_close(grove_led_stick led_stick) {
     grove_led_stick_show(led_stick);
     gpio pin = info[led_stick].pin;
     gpio_close(pin);
+    grove_pool_free(&pool, led_stick);
 }
 
 py_void grove_led_stick_show(grove_led_stick led_stick) {
@@ -31,12 +31,16 @@
  *****************************************************************************/
 
 #include <grove_interfaces.h>
+#include <grove_pool.h>
+#include <grove_batch.h>
 #include <grove_ledbar.h>
 #include <circular_buffer.h>
 #include <gpio.h>
 #include <timer.h>
 
-#define DEVICE_MAX 4
+#ifndef GROVE_LEDBAR_INSTANCES
+#define GROVE_LEDBAR_INSTANCES 4
+#endif
 #define GLB_CMDMODE                 0x00
 #define HIGH                        0xFF
 #define LOW                         0x01
@@ -47,12 +51,16 @@
 struct info {
     gpio data;
     gpio clk;
+    gpio pair;
+    unsigned int data_bit;
+    unsigned int clk_bit;
     int count;
     char ledbar_state[10] = {OFF, OFF, OFF, OFF, OFF, OFF, OFF, OFF, OFF, OFF};
     char current_state[10] = {OFF, OFF, OFF, OFF, OFF, OFF, OFF, OFF, OFF, OFF};
 };
 
-static struct info info[DEVICE_MAX];
+static struct info info[GROVE_LEDBAR_INSTANCES];
+GROVE_POOL(pool, GROVE_LEDBAR_INSTANCES);
 
 // Current Level
 static int level_holder = 0;
@@ -80,20 +88,44 @@ static int prev_inverse = 0;
  * 
  */
 static int next_index() {
-    for (int i = 0; i < DEVICE_MAX; ++i) {
-        if (info[i].count == 0) return i;
-    }
-    return -ENOMEM;
+    return grove_pool_alloc(&pool);
+}
+static int batch_set_pixel(int dev, const struct grove_batch_args *args) {
+    return grove_ledbar_set_pixel(dev, grove_batch_int(args, 0),
+                                  grove_batch_int(args, 1));
+}
+
+static int batch_set_level(int dev, const struct grove_batch_args *args) {
+    return grove_ledbar_set_level(dev, grove_batch_int(args, 0),
+                                  grove_batch_int(args, 1),
+                                  grove_batch_int(args, 2));
 }
+
+static int batch_clear(int dev, const struct grove_batch_args *args) {
+    return grove_ledbar_clear(dev);
+}
+
+static const struct grove_batch_op batch_ops[] = {
+    {"grove_ledbar_set_pixel", batch_set_pixel},
+    {"grove_ledbar_set_level", batch_set_level},
+    {"grove_ledbar_clear", batch_clear},
+};
+
 grove_ledbar grove_ledbar_open(int grove_id) {
     grove_ledbar dev_id = next_index();
+    if (dev_id == -ENOMEM)
+        return -ENOMEM;
     info[dev_id].count++;
     info[dev_id].data = gpio_open_grove_a(grove_id);
     info[dev_id].clk = gpio_open_grove_b(grove_id);
+    info[dev_id].pair = gpio_open_grove_pair(grove_id);
+    info[dev_id].data_bit = gpio_grove_pair_mask(grove_id, 0);
+    info[dev_id].clk_bit = gpio_grove_pair_mask(grove_id, 1);
     
     gpio_set_direction(info[dev_id].data, GPIO_OUT);
     gpio_set_direction(info[dev_id].clk, GPIO_OUT);
     grove_ledbar_set_level(dev_id, 0, 0, 0);
+    grove_batch_register(batch_ops, sizeof(batch_ops) / sizeof(batch_ops[0]));
     return dev_id;
 }
 
@@ -104,6 +136,8 @@ void grove_ledbar_close(grove_ledbar ledbar) {
     gpio clk = info[ledbar].clk;
     gpio_close(data);
     gpio_close(clk);
+    gpio_close(info[ledbar].pair);
+    grove_pool_free(&pool, ledbar);
 }
 
 /* Send 8-bit data to the LED Bar
@@ -119,35 +153,39 @@ void grove_ledbar_close(grove_ledbar ledbar) {
  *
  */
 static void send_data(grove_ledbar ledbar, u8 send_data){
-    gpio clk = info[ledbar].clk;
-    gpio data = info[ledbar].data;
+    unsigned int clk = info[ledbar].clk_bit;
+    unsigned int data = info[ledbar].data_bit;
+    // One data write, 8 clock edges, then a data and a clock write per bit
+    unsigned int levels[1 + 8 + 2 * 8];
+    unsigned int n = 0;
     int i;
     u32 data_state, clkval, data_internal;
 
     data_internal = send_data;
 
     clkval = 0;
-    gpio_write(data, 0);
+    levels[n++] = 0;
     // First toggle the clock 8 times
     for (i = 0; i < 8; ++i) {
-         clkval ^= 1;
-         gpio_write(clk, clkval);
+         clkval ^= clk;
+         levels[n++] = clkval;
     }
 
     // Working in 8-bit mode
     for (i = 0; i < 8; i++){
         /*
-         * Read each bit of the data to be sent LSB first
-         * Write it to the data_pin
+         * Read each bit of the data to be sent MSB first
+         * Set the data pin before the clock edge that latches it
          */
-        data_state = (data_internal & 0x80) ? 0x00000001 : 0x00000000;
-        gpio_write(data, data_state);
-        clkval ^= 1;
-        gpio_write(clk, clkval);
+        data_state = (data_internal & 0x80) ? data : 0;
+        levels[n++] = clkval | data_state;
+        clkval ^= clk;
+        levels[n++] = clkval | data_state;
 
         // Shift Incoming data to fetch next bit
         data_internal = data_internal << 1;
     }
+    gpio_write_sequence(info[ledbar].pair, data | clk, levels, n);
 }
 
 /* Send 4 pulses to latch data sent to the LED Bar
@@ -162,17 +200,18 @@ static void send_data(grove_ledbar ledbar, u8 send_data){
  *
  */
 static void latch_data(grove_ledbar ledbar){
-    gpio data = info[ledbar].data;
-    gpio clk = info[ledbar].clk;
+    unsigned int data = info[ledbar].data_bit;
+    unsigned int pulses[8];
     int i;
-    gpio_write(data, 0);
+    gpio_write_mask(info[ledbar].pair, data, 0);
     delay_ms(10);
 
     // Generate four pulses on the data pin as per data sheet
     for (i = 0; i < 4; i++){
-        gpio_write(data, 1);
-        gpio_write(data, 0);
+        pulses[2 * i] = data;
+        pulses[2 * i + 1] = 0;
     }
+    gpio_write_sequence(info[ledbar].pair, data, pulses, 8);
 }
 
 /* Function to reverse incoming data 
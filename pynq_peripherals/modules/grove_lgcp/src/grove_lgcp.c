@@ -31,13 +31,18 @@
  *****************************************************************************/
 
 #include <grove_interfaces.h>
+#include <grove_pool.h>
 #include <grove_lgcp.h>
 #include <timer.h>
 
 #include "grove_lgcp_hw.h"
+#include <grove_regcache.h>
 
 #define I2C_ADDRESS 0x39
-#define DEVICE_MAX 4
+#define I2C_MAX_HZ GROVE_I2C_FAST_HZ // APDS-9960 fast mode
+#ifndef GROVE_LGCP_INSTANCES
+#define GROVE_LGCP_INSTANCES 4
+#endif
 
 struct info {
     i2c i2c_dev;
@@ -46,9 +51,20 @@ struct info {
     unsigned int green_raw;
     unsigned int blue_raw;
     unsigned int clear_raw;
+    struct grove_regcache regs;
 };
 
-static struct info info[DEVICE_MAX];
+/* Status, result, interrupt clear and gesture FIFO registers are never
+ * cached */
+static const struct grove_regrange lgcp_uncached[] = {
+    {REG_STATUS, REG_PROX_DATA},
+    {REG_CONFIG_AE, REG_CONFIG_AF},
+    {REG_PBCLEAR, REG_AICLEAR},
+    {REG_GFIFO_N, REG_GFIFO_E},
+};
+
+static struct info info[GROVE_LGCP_INSTANCES];
+GROVE_POOL(pool, GROVE_LGCP_INSTANCES);
 
 /*
  * Documentation for public functions is provided as part of the external 
@@ -70,10 +86,7 @@ static struct info info[DEVICE_MAX];
  * 
  */
 static int next_index() {
-    for (int i = 0; i < DEVICE_MAX; ++i) {
-        if (info[i].count == 0) return i;
-    }
-    return -ENOMEM;
+    return grove_pool_alloc(&pool);
 }
 
 /* Get Device ID
@@ -92,8 +105,7 @@ static int get_device_id(grove_lgcp p) {
     i2c i2c_dev = info[p].i2c_dev;
     unsigned char buffer;
     buffer = REG_ID;
-    if (i2c_write(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -EIO;
-    if (i2c_read(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -EIO;
+    if (i2c_read_reg(i2c_dev, I2C_ADDRESS, buffer, &buffer, 1) != 1) return -EIO;
     return (buffer >> 2);
 }
 
@@ -112,8 +124,7 @@ static int get_device_id(grove_lgcp p) {
 static int get_control_reg(grove_lgcp p) {
     i2c i2c_dev = info[p].i2c_dev;
     unsigned char buffer = REG_CONTROL;
-    if (i2c_write(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -1;
-    if (i2c_read(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -1;
+    if (i2c_read_reg(i2c_dev, I2C_ADDRESS, buffer, &buffer, 1) != 1) return -1;
     return (int)buffer;
 }
 
@@ -155,8 +166,7 @@ static int get_control_reg(grove_lgcp p) {
  static int get_config2(grove_lgcp p) {
     i2c i2c_dev = info[p].i2c_dev;
     unsigned char buffer = REG_CONFIG2;
-    if (i2c_write(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -1;
-    if (i2c_read(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -1;
+    if (i2c_read_reg(i2c_dev, I2C_ADDRESS, buffer, &buffer, 1) != 1) return -1;
     return (int)buffer;
 }
 
@@ -198,8 +208,7 @@ static int get_control_reg(grove_lgcp p) {
 static int get_config3(grove_lgcp p) {
     i2c i2c_dev = info[p].i2c_dev;
     unsigned char buffer = REG_CONFIG3;
-    if (i2c_write(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -1;
-    if (i2c_read(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -1;
+    if (i2c_read_reg(i2c_dev, I2C_ADDRESS, buffer, &buffer, 1) != 1) return -1;
     return (int)buffer;
 }
 
@@ -241,8 +250,7 @@ static int get_config3(grove_lgcp p) {
  static int get_status(grove_lgcp p) {
     i2c i2c_dev = info[p].i2c_dev;
     unsigned char buffer = REG_STATUS;
-    if (i2c_write(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -1;
-    if (i2c_read(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -1;
+    if (i2c_read_reg(i2c_dev, I2C_ADDRESS, buffer, &buffer, 1) != 1) return -1;
     return (int)buffer;
 }
 
@@ -261,8 +269,7 @@ static int get_config3(grove_lgcp p) {
 /* static int clear_pattern_burst_interrupts(grove_lgcp p) {
     i2c i2c_dev = info[p].i2c_dev;
     unsigned char buffer = REG_PBCLEAR;
-    if (i2c_write(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -1;
-    if (i2c_read(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -1;
+    if (i2c_read_reg(i2c_dev, I2C_ADDRESS, buffer, &buffer, 1) != 1) return -1;
     return 0;
 } */
 
@@ -281,8 +288,7 @@ static int get_config3(grove_lgcp p) {
  /* static int force_assert_interrupt_pin(grove_lgcp p) {
     i2c i2c_dev = info[p].i2c_dev;
     unsigned char buffer = REG_IFORCE;
-    if (i2c_write(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -1;
-    if (i2c_read(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -1;
+    if (i2c_read_reg(i2c_dev, I2C_ADDRESS, buffer, &buffer, 1) != 1) return -1;
     return 0;
 } */
 
@@ -325,8 +331,7 @@ static int grove_lgcp_enable_wait_time_12x_factor(grove_lgcp p, int enable) {
 static int grove_lgcp_get_interrupt_persistance_reg(grove_lgcp p) {
     i2c i2c_dev = info[p].i2c_dev;
     unsigned char buffer = REG_IT_PERS;
-    if (i2c_write(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -1;
-    if (i2c_read(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -1;
+    if (i2c_read_reg(i2c_dev, I2C_ADDRESS, buffer, &buffer, 1) != 1) return -1;
     return (int)buffer;
 } */
 
@@ -413,16 +418,14 @@ static int is_device_ready(grove_lgcp p) {
 static int grove_lgcp_clear_als_interrupts(grove_lgcp p) {
     i2c i2c_dev = info[p].i2c_dev;
     unsigned char buffer = REG_CICLEAR;
-    if (i2c_write(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -1;
-    if (i2c_read(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -1;
+    if (i2c_read_reg(i2c_dev, I2C_ADDRESS, buffer, &buffer, 1) != 1) return -1;
     return 0;
 }
 S
 static int grove_lgcp_clear_all_interrupts(grove_lgcp p) {
     i2c i2c_dev = info[p].i2c_dev;
     unsigned char buffer = REG_AICLEAR;
-    if (i2c_write(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -1;
-    if (i2c_read(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -1;
+    if (i2c_read_reg(i2c_dev, I2C_ADDRESS, buffer, &buffer, 1) != 1) return -1;
     return 0;
 }
 */
@@ -439,12 +442,8 @@ static int grove_lgcp_clear_all_interrupts(grove_lgcp p) {
  * 		0 if succesful, -1 otherwise
  */
 static int lgcp_reset(grove_lgcp p) {
-    i2c i2c_dev = info[p].i2c_dev;
-    unsigned char buffer[2];
-	unsigned char enable_reg, enable_bits;
-    buffer[0] = REG_ENABLE;
-    buffer[1] = 0x0; // Turn-off all engines
-    if (i2c_write(i2c_dev, I2C_ADDRESS, buffer, 2) != 2) return -1;
+    // Turn-off all engines
+    if (grove_regcache_write(&info[p].regs, REG_ENABLE, 0x0)) return -1;
 	return 0;
 }
 
@@ -478,14 +477,18 @@ grove_lgcp grove_lgcp_open(int grove_id) {
     grove_lgcp dev_id = next_index();
     if (dev_id >= 0) {
         info[dev_id].count++;
-        info[dev_id].i2c_dev = i2c_open_grove(grove_id);
+        info[dev_id].i2c_dev = i2c_open_grove_speed(grove_id, I2C_MAX_HZ);
         info[dev_id].red_raw = 0;
         info[dev_id].green_raw = 0;
         info[dev_id].blue_raw = 0;
         info[dev_id].clear_raw = 0;
+        grove_regcache_init(&info[dev_id].regs, info[dev_id].i2c_dev,
+                            I2C_ADDRESS, lgcp_uncached,
+                            sizeof(lgcp_uncached) / sizeof(lgcp_uncached[0]));
         lgcp_reset(dev_id);
         if (is_device_ready(dev_id) != 0) {
             info[dev_id].count--;
+            grove_pool_free(&pool, dev_id);
             i2c_close(info[dev_id].i2c_dev);
             return -EIO;
         }
@@ -501,38 +504,33 @@ void grove_lgcp_close(grove_lgcp p) {
     if (--info[p].count != 0) return;
     i2c i2c_dev = info[p].i2c_dev;
     i2c_close(i2c_dev);
+    grove_pool_free(&pool, p);
 }
 
 py_int grove_lgcp_get_enable_reg(grove_lgcp p) {
-    i2c i2c_dev = info[p].i2c_dev;
-    unsigned char buffer = REG_ENABLE;
-    if (i2c_write(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -EIO;
-    if (i2c_read(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -EIO;
+    unsigned char buffer;
+    if (grove_regcache_read(&info[p].regs, REG_ENABLE, &buffer)) return -EIO;
     return (int)buffer;
 }
 
 py_void grove_lgcp_select_proximity(grove_lgcp p) {
-    i2c i2c_dev = info[p].i2c_dev;
     int pben = 0;
     unsigned char enable_reg;
 	int rst = lgcp_reset(p);
 	if (rst == -1) return -EIO;
     int ret = grove_lgcp_get_enable_reg(p);
-    if (ret == -1) {
+    if (ret < 0) {
         return -EIO;
     } else {
         enable_reg = (unsigned char)ret;
     }
     unsigned char enable_bits = enable_reg | ENABLE_PEN | ENABLE_PIEN;
 
-    unsigned char buffer[2];
-    buffer[0] = REG_ENABLE;
     if (enable_bits & ENABLE_PBEN) {
         enable_bits = ENABLE_PBEN;
         pben = 1;
     }
-    buffer[1] = ENABLE_PON | enable_bits;
-    if (i2c_write(i2c_dev, I2C_ADDRESS, buffer, 2) != 2) return -EIO;
+    if (grove_regcache_write(&info[p].regs, REG_ENABLE, ENABLE_PON | enable_bits)) return -EIO;
 
     if (!pben) {
         delay_ms(7);
@@ -551,7 +549,7 @@ py_void grove_lgcp_select_als(grove_lgcp p) {
 	int rst = lgcp_reset(p);
 	if (rst == -1) return -EIO;
     int ret = grove_lgcp_get_enable_reg(p);
-    if (ret == -1) {
+    if (ret < 0) {
         return -EIO;
     } else {
         enable_reg = (unsigned char)ret;
@@ -559,13 +557,11 @@ py_void grove_lgcp_select_als(grove_lgcp p) {
     unsigned char enable_bits = enable_reg | ENABLE_AEN | ENABLE_AIEN;
 
     unsigned char buffer[2];
-    buffer[0] = REG_ENABLE;
     if (enable_bits & ENABLE_PBEN) {
         enable_bits = ENABLE_PBEN;
         pben = 1;
     }
-    buffer[1] = ENABLE_PON | enable_bits;
-    if (i2c_write(i2c_dev, I2C_ADDRESS, buffer, 2) != 2) return -EIO;
+    if (grove_regcache_write(&info[p].regs, REG_ENABLE, ENABLE_PON | enable_bits)) return -EIO;
 
     if (!pben) {
         delay_ms(7);
@@ -585,23 +581,21 @@ py_void grove_lgcp_select_gesture(grove_lgcp p) {
     int rst = lgcp_reset(p);
     if (rst == -1) return -EIO;
     int ret = grove_lgcp_get_enable_reg(p);
-    if (ret == -1) {
+    if (ret < 0) {
         return -EIO;
     } else {
         enable_reg = (unsigned char)ret;
     }
     unsigned char enable_bits = enable_reg | ENABLE_GEN;
 
-    unsigned char buffer[2];
-    buffer[0] = REG_ENABLE;
     if (enable_bits & ENABLE_PBEN) {
         enable_bits = ENABLE_PBEN;
         pben = 1;
     }
-    buffer[1] = ENABLE_PON | enable_bits;
-    if (i2c_write(i2c_dev, I2C_ADDRESS, buffer, 2) != 2) return -EIO;
+    if (grove_regcache_write(&info[p].regs, REG_ENABLE, ENABLE_PON | enable_bits)) return -EIO;
 
     if (!pben) {
+        unsigned char buffer[2];
         delay_ms(7);
         buffer[0] = REG_CONFIG_AB;
         buffer[1] = 0x11;
@@ -626,32 +620,28 @@ py_int grove_lgcp_get_gesture_north(grove_lgcp p) {
     if (i2c_write(i2c_dev, I2C_ADDRESS, buffer1, 2) != 2) return -EIO;
 
     unsigned char buffer = REG_GFIFO_N;
-    if (i2c_write(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -EIO;
-    if (i2c_read(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -EIO;
+    if (i2c_read_reg(i2c_dev, I2C_ADDRESS, buffer, &buffer, 1) != 1) return -EIO;
     return (int)buffer;
 }
 
 py_int grove_lgcp_get_gesture_south(grove_lgcp p) {
     i2c i2c_dev = info[p].i2c_dev;
     unsigned char buffer = REG_GFIFO_S;
-    if (i2c_write(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -EIO;
-    if (i2c_read(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -EIO;
+    if (i2c_read_reg(i2c_dev, I2C_ADDRESS, buffer, &buffer, 1) != 1) return -EIO;
     return (int)buffer;
 }
 
 py_int grove_lgcp_get_gesture_west(grove_lgcp p) {
     i2c i2c_dev = info[p].i2c_dev;
     unsigned char buffer = REG_GFIFO_W;
-    if (i2c_write(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -EIO;
-    if (i2c_read(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -EIO;
+    if (i2c_read_reg(i2c_dev, I2C_ADDRESS, buffer, &buffer, 1) != 1) return -EIO;
     return (int)buffer;
 }
 
 py_int grove_lgcp_get_gesture_east(grove_lgcp p) {
     i2c i2c_dev = info[p].i2c_dev;
     unsigned char buffer = REG_GFIFO_E;
-    if (i2c_write(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -EIO;
-    if (i2c_read(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -EIO;
+    if (i2c_read_reg(i2c_dev, I2C_ADDRESS, buffer, &buffer, 1) != 1) return -EIO;
     return (int)buffer;
 }
 
@@ -709,8 +699,7 @@ py_void grove_lgcp_set_proximity_range(grove_lgcp p, unsigned char low, unsigned
 py_int grove_lgcp_get_proximity_raw(grove_lgcp p) {
     i2c i2c_dev = info[p].i2c_dev;
     unsigned char buffer = REG_PROX_DATA;
-    if (i2c_write(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -EIO;
-    if (i2c_read(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -EIO;
+    if (i2c_read_reg(i2c_dev, I2C_ADDRESS, buffer, &buffer, 1) != 1) return -EIO;
     return (int)buffer;
 }
 
@@ -728,8 +717,7 @@ py_int grove_lgcp_get_rgbc_raw(grove_lgcp p) {
     i2c i2c_dev = info[p].i2c_dev;
 	unsigned char buffer[8];
     buffer[0] = REG_RGBC_DATA;
-    if (i2c_write(i2c_dev, I2C_ADDRESS, buffer, 1) != 1) return -EIO;
-    if (i2c_read(i2c_dev, I2C_ADDRESS, buffer, 8) != 8) return -EIO;
+    if (i2c_read_reg(i2c_dev, I2C_ADDRESS, buffer[0], buffer, 8) != 8) return -EIO;
     info[p].clear_raw = (buffer[1] << 8) | buffer[0];
     info[p].red_raw = (buffer[3] << 8) | buffer[2];
     info[p].green_raw = (buffer[5] << 8) | buffer[4];
@@ -761,8 +749,7 @@ py_int grove_lgcp_get_lux(grove_lgcp p) {
     unsigned int B = info[p].blue_raw;
     unsigned int C = info[p].clear_raw;
     unsigned char buffer = REG_ATIME;
-    if (i2c_write(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -EIO;
-    if (i2c_read(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -EIO;
+    if (i2c_read_reg(i2c_dev, I2C_ADDRESS, buffer, &buffer, 1) != 1) return -EIO;
     float ms = (256 - buffer) * 2.78;
 
     int ret = get_control_reg(p);
@@ -803,7 +790,6 @@ py_int grove_lgcp_get_lux(grove_lgcp p) {
 }
 
 py_int grove_lgcp_get_cct(grove_lgcp p) {
-    i2c i2c_dev = info[p].i2c_dev;
     if (grove_lgcp_get_rgbc_raw(p) == -1) return -EIO;
     unsigned int R = info[p].red_raw;
     unsigned int G = info[p].green_raw;
@@ -832,8 +818,7 @@ py_int grove_lgcp_get_cct(grove_lgcp p) {
 py_void grove_lgcp_clear_proximity_interrupts(grove_lgcp p) {
     i2c i2c_dev = info[p].i2c_dev;
     unsigned char buffer = REG_PICLEAR;
-    if (i2c_write(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -EIO;
-    if (i2c_read(i2c_dev, I2C_ADDRESS, &buffer, 1) != 1) return -EIO;
+    if (i2c_read_reg(i2c_dev, I2C_ADDRESS, buffer, &buffer, 1) != 1) return -EIO;
     return PY_SUCCESS;
 }
 
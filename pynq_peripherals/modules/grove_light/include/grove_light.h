@@ -117,3 +117,23 @@ void grove_light_close(grove_light light);
  *
  */
 py_float grove_light_get_intensity(grove_light light);
+
+/* Take readings of the light intensity periodically on the IOP
+ *
+ * The readings are collected from all sampled devices at once with
+ * grove_sampler_drain, or the drain method of the adapter.
+ *
+ * Parameters
+ * ----------
+ * period_us : unsigned int
+ *     Time between two readings in microseconds
+ *
+ * Returns
+ * -------
+ *   int:
+ *     Source id carried by the samples of this device
+ *     -EINVAL if the period is 0 (raises exception)
+ *     -ENOMEM if too many readings are sampled (raises exception)
+ *
+ */
+py_int grove_light_sample(grove_light light, unsigned int period_us);
@@ -31,18 +31,23 @@
  *****************************************************************************/
 
 #include <grove_interfaces.h>
+#include <grove_pool.h>
+#include <grove_sampler.h>
 #include "grove_constants.h"
 #include <grove_light.h>
 #include <grove_adc.h>
 
-#define DEVICE_MAX 4
+#ifndef GROVE_LIGHT_INSTANCES
+#define GROVE_LIGHT_INSTANCES 4
+#endif
 
 struct info {
     analog pin;
     int count;
 };
 
-static struct info info[DEVICE_MAX];
+static struct info info[GROVE_LIGHT_INSTANCES];
+GROVE_POOL(pool, GROVE_LIGHT_INSTANCES);
 
 /*
  * Documentation for public functions is provided as part of the external 
@@ -64,10 +69,7 @@ static struct info info[DEVICE_MAX];
  * 
  */
 static int next_index() {
-    for (int i = 0; i < DEVICE_MAX; ++i) {
-        if (info[i].count == 0) return i;
-    }
-    return -ENOMEM;
+    return grove_pool_alloc(&pool);
 }
 
 static grove_light grove_light_open_analog(analog pin) {
@@ -92,11 +94,20 @@ grove_light grove_light_open_at_address(int grove_id, int address) {
 
 void grove_light_close(grove_light light) {
     if (--info[light].count != 0) return;
+    grove_sampler_forget(grove_light_get_intensity, light);
     analog pin = info[light].pin;
     analog_close(pin);
+    grove_pool_free(&pool, light);
 }
 
 py_float grove_light_get_intensity(grove_light light) {
     analog pin = info[light].pin;
-    return (float)analog_get_voltage(pin) * 100.0 / (float)analog_get_reference(pin);
+    // Percentage of the reference voltage in hundredths
+    int intensity = analog_get_millivolts(pin) * 10000 /
+                    analog_get_reference_millivolts(pin);
+    return intensity * 0.01f;
+}
+
+py_int grove_light_sample(grove_light light, unsigned int period_us) {
+    return grove_sampler_add(grove_light_get_intensity, light, period_us);
 }
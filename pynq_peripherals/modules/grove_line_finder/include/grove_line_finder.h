@@ -91,3 +91,21 @@ void grove_line_finder_close(grove_line_finder line_finder);
  *
  */
 py_bool grove_line_finder_line_found(grove_line_finder line_finder);
+
+/* Record when a line is found and lost as gpio edge events
+ *
+ * The events are drained for all watched sensors at once with
+ * gpio_event_wait and gpio_event_read. The level of an event is
+ * 1 when a line is found.
+ *
+ * Parameters
+ * ----------
+ *     None
+ *
+ * Returns
+ * -------
+ *     Watch id carried by the events of this sensor
+ *     -ENOMEM if too many pins are watched (raises exception)
+ *
+ */
+py_int grove_line_finder_watch(grove_line_finder line_finder);
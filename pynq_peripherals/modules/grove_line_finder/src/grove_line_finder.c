@@ -31,16 +31,21 @@
  *****************************************************************************/
 
 #include <grove_interfaces.h>
+#include <grove_pool.h>
 #include <grove_line_finder.h>
 
-#define DEVICE_MAX 4
+#ifndef GROVE_LINE_FINDER_INSTANCES
+#define GROVE_LINE_FINDER_INSTANCES 4
+#endif
 
 struct info {
     gpio pin;
+    int watch;
     int count;
 };
 
-static struct info info[DEVICE_MAX];
+static struct info info[GROVE_LINE_FINDER_INSTANCES];
+GROVE_POOL(pool, GROVE_LINE_FINDER_INSTANCES);
 
 /*
  * Documentation for public functions is provided as part of the external 
@@ -62,16 +67,14 @@ static struct info info[DEVICE_MAX];
  * 
  */
 static int next_index() {
-    for (int i = 0; i < DEVICE_MAX; ++i) {
-        if (info[i].count == 0) return i;
-    }
-    return -ENOMEM;
+    return grove_pool_alloc(&pool);
 }
 grove_line_finder grove_line_finder_open(int grove_id) {
     grove_line_finder dev_id = next_index();
     if (dev_id >= 0) {
         info[dev_id].count++;
         info[dev_id].pin = gpio_open_grove(grove_id);
+        info[dev_id].watch = -1;
         gpio_set_direction(info[dev_id].pin, GPIO_IN);
     }
     return dev_id;
@@ -79,11 +82,19 @@ grove_line_finder grove_line_finder_open(int grove_id) {
 
 void grove_line_finder_close(grove_line_finder line_finder) {
     if (--info[line_finder].count != 0) return;
+    if (info[line_finder].watch >= 0) gpio_event_unwatch(info[line_finder].watch);
     gpio pin = info[line_finder].pin;
     gpio_close(pin);
+    grove_pool_free(&pool, line_finder);
 }
 
 py_bool grove_line_finder_line_found(grove_line_finder line_finder) {
     gpio pin = info[line_finder].pin;
     return gpio_read(pin);
 }
+
+py_int grove_line_finder_watch(grove_line_finder line_finder) {
+    if (info[line_finder].watch < 0)
+        info[line_finder].watch = gpio_event_watch(info[line_finder].pin, GROVE_GPIO_BOTH);
+    return info[line_finder].watch;
+}
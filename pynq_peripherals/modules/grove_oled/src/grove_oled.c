@@ -31,6 +31,7 @@
  *****************************************************************************/
 
 #include <grove_interfaces.h>
+#include <grove_pool.h>
 #include <grove_oled.h>
 #include <xil_types.h>
 #include <cstring>
@@ -38,14 +39,18 @@
 #include <grove_oled_hw.h>
 
 #define I2C_ADDRESS 0x3c
-#define DEVICE_MAX 4
+#define I2C_MAX_HZ GROVE_I2C_FAST_HZ // SSD1327 fast mode
+#ifndef GROVE_OLED_INSTANCES
+#define GROVE_OLED_INSTANCES 4
+#endif
 
 struct info {
     i2c i2c_dev;
     int count;
 };
 
-static struct info info[DEVICE_MAX];
+static struct info info[GROVE_OLED_INSTANCES];
+GROVE_POOL(pool, GROVE_OLED_INSTANCES);
 static int oleds_used, num_oleds;
 static unsigned char grayH;
 static unsigned char grayL;
@@ -70,10 +75,7 @@ static unsigned char grayL;
  * 
  */
 static int next_index() {
-    for (int i = 0; i < DEVICE_MAX; ++i) {
-        if (info[i].count == 0) return i;
-    }
-    return -ENOMEM;
+    return grove_pool_alloc(&pool);
 }
 
 
@@ -127,9 +129,10 @@ grove_oled grove_oled_open(int grove_id) {
     grove_oled dev_id = next_index();
     if (dev_id >= 0) {
         info[dev_id].count++;
-        info[dev_id].i2c_dev = i2c_open_grove(grove_id);
+        info[dev_id].i2c_dev = i2c_open_grove_speed(grove_id, I2C_MAX_HZ);
         if (grove_oled_set_default_config(dev_id) == -EIO) {
             info[dev_id].count--;
+            grove_pool_free(&pool, dev_id);
             i2c_close(info[dev_id].i2c_dev);
             return -EIO;
         }
@@ -141,6 +144,7 @@ void grove_oled_close(grove_oled oled) {
     if (--info[oled].count != 0) return;
     i2c i2c_dev = info[oled].i2c_dev;
     i2c_close(i2c_dev);
+    grove_pool_free(&pool, oled);
 }
 
 py_void grove_oled_set_contrast_level(grove_oled oled, unsigned char level){
@@ -222,15 +226,20 @@ py_void grove_oled_put_string(grove_oled oled, const char *s){
 }
 
 py_void grove_oled_set_default_config(grove_oled oled){
-    // Unlock OLED driver IC MCU interface
-    if (send_command(oled, 0xFD) == -EIO) return -EIO;
-    if (send_command(oled, 0x12) == -EIO) return -EIO;
-    //Set display off
-    if (send_command(oled, 0xAE) == -EIO) return -EIO;
-    // Switch on display
-    if (send_command(oled, 0xAF) == -EIO) return -EIO;
-    // Set normal display
-    if (send_command(oled, 0xA4) == -EIO) return -EIO;
+    static const u8 default_config[][2] = {
+        // Unlock OLED driver IC MCU interface
+        {OLED_Command_Mode, 0xFD},
+        {OLED_Command_Mode, 0x12},
+        //Set display off
+        {OLED_Command_Mode, 0xAE},
+        // Switch on display
+        {OLED_Command_Mode, 0xAF},
+        // Set normal display
+        {OLED_Command_Mode, 0xA4},
+    };
+    const unsigned int count = sizeof(default_config) / sizeof(default_config[0]);
+    if (i2c_write_table(info[oled].i2c_dev, OLED_Address, default_config[0],
+                        count) != count) return -EIO;
     // Init gray level for text. Default:Brightest White
     grayH= 0xF0;
     grayL= 0x0F;
@@ -148,4 +148,20 @@ py_float grove_ph_first_calibrate(grove_ph p, float ph);
  *     NAN  general operation error (raises exception)
  *
  */
-py_float grove_ph_second_calibrate(grove_ph p, float ph);
\ No newline at end of file
+py_float grove_ph_second_calibrate(grove_ph p, float ph);
+/* Average several conversions into every reading to reduce noise
+ *
+ * Parameters
+ * ----------
+ * samples : int
+ *    Conversions per reading: 1, 16, 64 or 256 on an Arduino analog
+ *    port, 1 to 256 on a Grove ADC. Readings take proportionally longer.
+ *
+ * Returns
+ * -------
+ *   int:
+ *     PY_SUCCESS if the setting was applied
+ *     negative value if the number of samples is not supported
+ *
+ */
+py_int grove_ph_set_averaging(grove_ph ph, int samples);
@@ -31,19 +31,23 @@
  *****************************************************************************/
 
 #include <grove_interfaces.h>
+#include <grove_pool.h>
 #include <grove_ph.h>
 #include <grove_adc.h>
 #include "grove_constants.h"
 #include <pyprintf.h>
 
-#define DEVICE_MAX 4
+#ifndef GROVE_PH_INSTANCES
+#define GROVE_PH_INSTANCES 4
+#endif
 
 struct info {
     analog pin;
     int count;
 };
 
-static struct info info[DEVICE_MAX];
+static struct info info[GROVE_PH_INSTANCES];
+GROVE_POOL(pool, GROVE_PH_INSTANCES);
 
 float vol_1 = 1.66;
 float ph_1 = 9.18;
@@ -72,10 +76,7 @@ float offset = 41.02740741;
  * 
  */
 static int next_index() {
-    for (int i = 0; i < DEVICE_MAX; ++i) {
-        if (info[i].count == 0) return i;
-    }
-    return -ENOMEM;
+    return grove_pool_alloc(&pool);
 }
 
 static grove_ph grove_ph_open_analog(analog pin) {
@@ -102,13 +103,31 @@ void grove_ph_close(grove_ph ph) {
     if (--info[ph].count != 0) return;
     analog pin = info[ph].pin;
     analog_close(pin);
+    grove_pool_free(&pool, ph);
+}
+
+/* Fit the line through both calibration points
+ * 
+ * Parameters
+ * ----------
+ *     None
+ * 
+ * Return
+ * ------
+ *     None
+ * 
+ */
+static void fit() {
+    k = (ph_2 - ph_1) / (vol_2 - vol_1);
+    offset = ((ph_2 + ph_1) - k*(vol_1 + vol_2))*0.5f;
 }
 
 py_float grove_ph_first_calibrate(grove_ph p, float ph) {
     if (ph < 7 || ph > 14) return -1;
     ph_1 = ph;
     analog pin = info[p].pin;
-    vol_1 = (float)analog_get_voltage(pin);
+    vol_1 = analog_get_millivolts(pin) * 0.001f;
+    fit();
     return vol_1;
 }
 
@@ -116,17 +135,21 @@ py_float grove_ph_second_calibrate(grove_ph p, float ph) {
     if (ph < 0 || ph > 7) return -1;
     ph_2 = ph;
     analog pin = info[p].pin;
-    vol_2 = (float)analog_get_voltage(pin);
+    vol_2 = analog_get_millivolts(pin) * 0.001f;
+    fit();
     return vol_2;
 }
 
 py_float grove_ph_get_ph(grove_ph ph) {
     analog pin = info[ph].pin;
-    float current_voltage = (float)analog_get_voltage(pin);
-    k = (ph_2 - ph_1) / (vol_2 - vol_1);
-    offset = ((ph_2 + ph_1) - k*(vol_1 + vol_2))*0.5;
+    float current_voltage = analog_get_millivolts(pin) * 0.001f;
     float raw_value = k*current_voltage + offset;
     raw_value = (raw_value > 14) ? 14 : raw_value;
     raw_value = (raw_value < 0 ) ? 0 : raw_value;
     return raw_value;
 }
+
+py_int grove_ph_set_averaging(grove_ph ph, int samples) {
+    analog pin = info[ph].pin;
+    return analog_set_averaging(pin, samples);
+}
@@ -96,3 +96,21 @@ void grove_pir_close(grove_pir pir);
  *
  */
 py_bool grove_pir_motion_detected(grove_pir pir);
+
+/* Record when motion starts and ends as gpio edge events
+ *
+ * The events are drained for all watched sensors at once with
+ * gpio_event_wait and gpio_event_read. The level of an event is
+ * 1 when motion starts.
+ *
+ * Parameters
+ * ----------
+ *     None
+ *
+ * Returns
+ * -------
+ *     Watch id carried by the events of this sensor
+ *     -ENOMEM if too many pins are watched (raises exception)
+ *
+ */
+py_int grove_pir_watch(grove_pir pir);
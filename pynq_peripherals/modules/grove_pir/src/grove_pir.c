@@ -31,35 +31,42 @@
  *****************************************************************************/
 
 #include <grove_interfaces.h>
+#include <grove_pool.h>
 #include <grove_pir.h>
 
-#define DEVICE_MAX 4
+#ifndef GROVE_PIR_INSTANCES
+#define GROVE_PIR_INSTANCES 4
+#endif
 
 struct info {
     gpio pin;
+    int watch;
     int count;
 };
 
-static struct info info[DEVICE_MAX];
+static struct info info[GROVE_PIR_INSTANCES];
+GROVE_POOL(pool, GROVE_PIR_INSTANCES);
 
 static int next_index() {
-    for (int i = 0; i < DEVICE_MAX; ++i) {
-        if (info[i].count == 0) return i;
-    }
-    return -ENOMEM;
+    return grove_pool_alloc(&pool);
 }
 grove_pir grove_pir_open(int grove_id) {
     grove_pir dev_id = next_index();
+    if (dev_id == -ENOMEM)
+        return -ENOMEM;
     info[dev_id].count++;
     info[dev_id].pin = gpio_open_grove(grove_id);
+    info[dev_id].watch = -1;
     gpio_set_direction(info[dev_id].pin, GPIO_IN);
     return dev_id;
 }
 
 void grove_pir_close(grove_pir pir) {
     if (--info[pir].count != 0) return;
+    if (info[pir].watch >= 0) gpio_event_unwatch(info[pir].watch);
     gpio pin = info[pir].pin;
     gpio_close(pin);
+    grove_pool_free(&pool, pir);
 }
 
 py_bool grove_pir_motion_detected(grove_pir pir) {
@@ -67,3 +74,8 @@ py_bool grove_pir_motion_detected(grove_pir pir) {
     return gpio_read(pin);
 }
 
+py_int grove_pir_watch(grove_pir pir) {
+    if (info[pir].watch < 0)
+        info[pir].watch = gpio_event_watch(info[pir].pin, GROVE_GPIO_BOTH);
+    return info[pir].watch;
+}
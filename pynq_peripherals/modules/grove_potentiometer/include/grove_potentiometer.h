@@ -122,3 +122,23 @@ void grove_potentiometer_close(grove_potentiometer potentiometer);
  *
  */
 py_float grove_potentiometer_get_position(grove_potentiometer potentiometer);
+
+/* Take readings of the position periodically on the IOP
+ *
+ * The readings are collected from all sampled devices at once with
+ * grove_sampler_drain, or the drain method of the adapter.
+ *
+ * Parameters
+ * ----------
+ * period_us : unsigned int
+ *     Time between two readings in microseconds
+ *
+ * Returns
+ * -------
+ *   int:
+ *     Source id carried by the samples of this device
+ *     -EINVAL if the period is 0 (raises exception)
+ *     -ENOMEM if too many readings are sampled (raises exception)
+ *
+ */
+py_int grove_potentiometer_sample(grove_potentiometer potentiometer, unsigned int period_us);
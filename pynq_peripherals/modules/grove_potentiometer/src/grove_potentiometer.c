@@ -31,27 +31,29 @@
  *****************************************************************************/
 
 #include <grove_interfaces.h>
+#include <grove_pool.h>
+#include <grove_sampler.h>
 #include "grove_constants.h"
 #include <grove_potentiometer.h>
 #include <grove_adc.h>
 
 #define MIN(a,b) ((a) < (b) ? a : b)
 
-#define DEVICE_MAX 4
+#ifndef GROVE_POTENTIOMETER_INSTANCES
+#define GROVE_POTENTIOMETER_INSTANCES 4
+#endif
 
 struct info {
     analog pin;
     int count;
 };
 
-static struct info info[DEVICE_MAX];
+static struct info info[GROVE_POTENTIOMETER_INSTANCES];
+GROVE_POOL(pool, GROVE_POTENTIOMETER_INSTANCES);
 const int R = 10000; // maximun resistance
 
 static int next_index() {
-    for (int i = 0; i < DEVICE_MAX; ++i) {
-        if (info[i].count == 0) return i;
-    }
-    return -1;
+    return grove_pool_alloc(&pool);
 }
 
 static grove_potentiometer grove_potentiometer_open_analog(analog pin) {
@@ -77,12 +79,19 @@ grove_potentiometer grove_potentiometer_open_at_address(int grove_id, int addres
 
 void grove_potentiometer_close(grove_potentiometer potentiometer) {
     if (--info[potentiometer].count != 0) return;
+    grove_sampler_forget(grove_potentiometer_get_position, potentiometer);
     analog pin = info[potentiometer].pin;
     analog_close(pin);
+    grove_pool_free(&pool, potentiometer);
 }
 
 py_float grove_potentiometer_get_position(grove_potentiometer potentiometer) {
     analog pin = info[potentiometer].pin;
-    float ration = analog_get_voltage(pin)/analog_get_reference(pin);
-    return MIN(ration, 1.0);
+    int millivolts = analog_get_millivolts(pin);
+    int reference = analog_get_reference_millivolts(pin);
+    return (float)MIN(millivolts, reference) / reference;
+}
+
+py_int grove_potentiometer_sample(grove_potentiometer potentiometer, unsigned int period_us) {
+    return grove_sampler_add(grove_potentiometer_get_position, potentiometer, period_us);
 }
@@ -31,17 +31,22 @@
  *****************************************************************************/
 
 #include <grove_interfaces.h>
+#include <grove_pool.h>
+#include <grove_batch.h>
 #include <grove_relay.h>
 #include <gpio.h>
 
-#define DEVICE_MAX 4
+#ifndef GROVE_RELAY_INSTANCES
+#define GROVE_RELAY_INSTANCES 4
+#endif
 
 struct info {
     gpio pin;
     int count;
 };
 
-static struct info info[DEVICE_MAX];
+static struct info info[GROVE_RELAY_INSTANCES];
+GROVE_POOL(pool, GROVE_RELAY_INSTANCES);
 
 /*
  * Documentation for public functions is provided as part of the external 
@@ -63,17 +68,28 @@ static struct info info[DEVICE_MAX];
  * 
  */
 static int next_index() {
-    for (int i = 0; i < DEVICE_MAX; ++i) {
-        if (info[i].count == 0) return i;
-    }
-    return -ENOMEM;
+    return grove_pool_alloc(&pool);
+}
+static int batch_on(int dev, const struct grove_batch_args *args) {
+    return grove_relay_on(dev);
+}
+
+static int batch_off(int dev, const struct grove_batch_args *args) {
+    return grove_relay_off(dev);
 }
+
+static const struct grove_batch_op batch_ops[] = {
+    {"grove_relay_on", batch_on},
+    {"grove_relay_off", batch_off},
+};
+
 grove_relay grove_relay_open(int grove_id) {
     grove_relay dev_id = next_index();
     if (dev_id >= 0) {
         info[dev_id].count++;
         info[dev_id].pin = gpio_open_grove(grove_id);
         gpio_set_direction(info[dev_id].pin, GPIO_OUT);
+        grove_batch_register(batch_ops, sizeof(batch_ops) / sizeof(batch_ops[0]));
     }
     return dev_id;
 }
@@ -83,6 +99,7 @@ void grove_relay_close(grove_relay relay) {
     gpio pin = info[relay].pin;
     gpio_write(pin, 0);
     gpio_close(pin);
+    grove_pool_free(&pool, relay);
 }
 
 py_void grove_relay_on(grove_relay relay) {
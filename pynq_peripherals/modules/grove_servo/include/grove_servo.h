@@ -61,6 +61,7 @@ typedef py_int grove_servo;
  * -------
  * grove_servo
  *     The device object  
+ *     -EBUSY if no PWM channel of the IOP is free
  * 
  */
 grove_servo grove_servo_open(int grove_id);
@@ -31,9 +31,13 @@
  *****************************************************************************/
 
 #include <grove_interfaces.h>
+#include <grove_pool.h>
+#include <grove_batch.h>
 #include <grove_servo.h>
 
-#define DEVICE_MAX 4
+#ifndef GROVE_SERVO_INSTANCES
+#define GROVE_SERVO_INSTANCES 4
+#endif
 #define PERIOD 2000000
 #define DUTY_MIN 60000
 #define DUTY_MAX 235000
@@ -44,7 +48,8 @@ struct info {
     int count;
 };
 
-static struct info info[DEVICE_MAX];
+static struct info info[GROVE_SERVO_INSTANCES];
+GROVE_POOL(pool, GROVE_SERVO_INSTANCES);
 
 /*
  * Documentation for public functions is provided as part of the external 
@@ -66,17 +71,29 @@ static struct info info[DEVICE_MAX];
  * 
  */
 static int next_index() {
-    for (int i = 0; i < DEVICE_MAX; ++i) {
-        if (info[i].count == 0) return i;
-    }
-    return -ENOMEM;
+    return grove_pool_alloc(&pool);
+}
+static int batch_set_angular_position(int dev,
+                                      const struct grove_batch_args *args) {
+    return grove_servo_set_angular_position(dev, grove_batch_float(args, 0));
 }
+
+static const struct grove_batch_op batch_ops[] = {
+    {"grove_servo_set_angular_position", batch_set_angular_position},
+};
+
 grove_servo grove_servo_open(int grove_id) {
     grove_servo dev_id = next_index();
     if (dev_id >= 0) {
         info[dev_id].count++;
         info[dev_id].pin = timer_open_grove(grove_id);
+        if (info[dev_id].pin < 0) {
+            info[dev_id].count--;
+            grove_pool_free(&pool, dev_id);
+            return info[dev_id].pin;
+        }
         timer_pwm_generate(info[dev_id].pin, PERIOD, DUTY_MIN);
+        grove_batch_register(batch_ops, sizeof(batch_ops) / sizeof(batch_ops[0]));
     }
     return dev_id;
 }
@@ -86,6 +103,7 @@ void grove_servo_close(grove_servo p) {
     timer pin = info[p].pin;
     timer_pwm_stop(pin);
     timer_close(pin);
+    grove_pool_free(&pool, p);
 }
 
 py_void grove_servo_set_angular_position(grove_servo p, float angle) {
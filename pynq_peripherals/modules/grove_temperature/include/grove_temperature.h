@@ -42,7 +42,7 @@
 /* Temperature class
  *
  * Available Methods:
- *    open, close, get_temperature
+ *    open, close, get_temperature, sample
  * 
  * The open_adc is used when Grove_adc module is used to sample a signal
  * The open is used when System Monitor of the Zynq device used to sample a signal
@@ -120,3 +120,40 @@ void grove_temperature_close(grove_temperature temp);
  *
  */
 py_float grove_temperature_get_temperature(grove_temperature temp);
+
+/* Average several conversions into every reading to reduce noise
+ *
+ * Parameters
+ * ----------
+ * samples : int
+ *    Conversions per reading: 1, 16, 64 or 256 on an Arduino analog
+ *    port, 1 to 256 on a Grove ADC. Readings take proportionally longer.
+ *
+ * Returns
+ * -------
+ *   int:
+ *     PY_SUCCESS if the setting was applied
+ *     negative value if the number of samples is not supported
+ *
+ */
+py_int grove_temperature_set_averaging(grove_temperature temp, int samples);
+
+/* Take readings of the temperature periodically on the IOP
+ *
+ * The readings are collected from all sampled devices at once with
+ * grove_sampler_drain, or the drain method of the adapter.
+ *
+ * Parameters
+ * ----------
+ * period_us : unsigned int
+ *     Time between two readings in microseconds
+ *
+ * Returns
+ * -------
+ *   int:
+ *     Source id carried by the samples of this device
+ *     -EINVAL if the period is 0 (raises exception)
+ *     -ENOMEM if too many readings are sampled (raises exception)
+ *
+ */
+py_int grove_temperature_sample(grove_temperature temp, unsigned int period_us);
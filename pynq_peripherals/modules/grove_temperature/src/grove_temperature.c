@@ -31,17 +31,22 @@
  *****************************************************************************/
 
 #include <grove_interfaces.h>
+#include <grove_pool.h>
+#include <grove_sampler.h>
 #include <grove_temperature.h>
 #include <math.h>
 
-#define DEVICE_MAX 4
+#ifndef GROVE_TEMPERATURE_INSTANCES
+#define GROVE_TEMPERATURE_INSTANCES 4
+#endif
 
 struct info {
     analog pin;
     int count;
 };
 
-static struct info info[DEVICE_MAX];
+static struct info info[GROVE_TEMPERATURE_INSTANCES];
+GROVE_POOL(pool, GROVE_TEMPERATURE_INSTANCES);
 const int B = 4275; // B value of the thermistor
 const int R0 = 100000; // Resistance R0 = 100k
 
@@ -65,10 +70,7 @@ const int R0 = 100000; // Resistance R0 = 100k
  * 
  */
 static int next_index() {
-    for (int i = 0; i < DEVICE_MAX; ++i) {
-        if (info[i].count == 0) return i;
-    }
-    return -ENOMEM;
+    return grove_pool_alloc(&pool);
 }
 
 static grove_temperature grove_temperature_open_analog(analog pin) {
@@ -95,8 +97,10 @@ grove_temperature grove_temperature_open_at_address(int grove_id, int address) {
 
 void grove_temperature_close(grove_temperature temp) {
     if (--info[temp].count != 0) return;
+    grove_sampler_forget(grove_temperature_get_temperature, temp);
     analog pin = info[temp].pin;
     analog_close(pin);
+    grove_pool_free(&pool, temp);
 }
 
 py_float grove_temperature_get_temperature(grove_temperature temp) {
@@ -106,3 +110,12 @@ py_float grove_temperature_get_temperature(grove_temperature temp) {
     float temperature = 1.0/(log(R/R0)/B+1/298.15)-273.15;
     return temperature;
 }
+
+py_int grove_temperature_set_averaging(grove_temperature temp, int samples) {
+    analog pin = info[temp].pin;
+    return analog_set_averaging(pin, samples);
+}
+
+py_int grove_temperature_sample(grove_temperature temp, unsigned int period_us) {
+    return grove_sampler_add(grove_temperature_get_temperature, temp, period_us);
+}
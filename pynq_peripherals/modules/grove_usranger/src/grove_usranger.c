@@ -31,14 +31,15 @@
  *****************************************************************************/
 
 #include <grove_interfaces.h>
+#include <grove_pool.h>
 #include <grove_usranger.h>
 #include "xparameters.h"
-#include "xtmrctr.h"
 #include "gpio.h"
 #include "timer.h"
 
-#define DEVICE_MAX 4
-#define MAX_COUNT 0xFFFFFFFF
+#ifndef GROVE_USRANGER_INSTANCES
+#define GROVE_USRANGER_INSTANCES 4
+#endif
 #define TIMEOUT 1e8
 
 struct info {
@@ -46,7 +47,8 @@ struct info {
     int count;
 };
 
-static struct info info[DEVICE_MAX];
+static struct info info[GROVE_USRANGER_INSTANCES];
+GROVE_POOL(pool, GROVE_USRANGER_INSTANCES);
 
 /*
  * Documentation for public functions is provided as part of the external 
@@ -68,10 +70,7 @@ static struct info info[DEVICE_MAX];
  * 
  */
 static int next_index() {
-    for (int i = 0; i < DEVICE_MAX; ++i) {
-        if (info[i].count == 0) return i;
-    }
-    return -ENOMEM;
+    return grove_pool_alloc(&pool);
 }
 
 grove_usranger grove_usranger_open(int grove_id) {
@@ -87,6 +86,7 @@ void grove_usranger_close(grove_usranger p) {
     if (--info[p].count != 0) return;
     gpio pin = info[p].pin;
     gpio_close(pin);
+    grove_pool_free(&pool, p);
 }
 
 /* Generate a 10 us pulse
@@ -109,7 +109,7 @@ static void create_10us_pulse(gpio pin){
     gpio_write(pin, 0);
 }
 
-/* Measure a pulse width
+/* Measure a pulse width on the shared time base
  * 
  * Parameters
  * ----------
@@ -118,29 +118,22 @@ static void create_10us_pulse(gpio pin){
  * Return
  * ------
  * pulse width: unsigned int
+ *     Width in timer cycles
  * 
  */
 static unsigned int capture_duration(gpio pin){
     unsigned int count0, count1, count2;
-    count1 = 0;
-    count2 = 0;
-    XTmrCtr_WriteReg(XPAR_TMRCTR_0_BASEADDR, 0, TLR0, 0x0);
-    XTmrCtr_WriteReg(XPAR_TMRCTR_0_BASEADDR, 0, TCSR0, 0x190);
-    count0 = XTmrCtr_ReadReg(XPAR_TMRCTR_0_BASEADDR, 0, TCR0);
-    count1=XTmrCtr_ReadReg(XPAR_TMRCTR_0_BASEADDR, 0, TCR0);
+    count0 = grove_timer_cycles();
+    count1 = count0;
     while((!gpio_read(pin)) && ((count1 - count0) < TIMEOUT)) {
-        count1=XTmrCtr_ReadReg(XPAR_TMRCTR_0_BASEADDR, 0, TCR0);
+        count1 = grove_timer_cycles();
     }
-    count2=XTmrCtr_ReadReg(XPAR_TMRCTR_0_BASEADDR, 0, TCR0);
+    count2 = grove_timer_cycles();
     while(gpio_read(pin) && ((count2 - count1) < TIMEOUT)) {
-        count2=XTmrCtr_ReadReg(XPAR_TMRCTR_0_BASEADDR, 0, TCR0);
-    }
-    
-    if(count2 > count1) {
-        return (count2 - count1);
-    } else {
-        return((MAX_COUNT - count1) + count2);  
+        count2 = grove_timer_cycles();
     }
+    // Unsigned differences stay correct across a wrap of the count
+    return count2 - count1;
 }
 
 py_float grove_usranger_get_distance(grove_usranger usranger) {
@@ -31,6 +31,7 @@
  *****************************************************************************/
 
 #include <grove_interfaces.h>
+#include <grove_pool.h>
 #include <grove_water_level.h>
 #include <math.h>
 #include <pyprintf.h>
@@ -39,7 +40,9 @@
 #define I2C_ADDRESS_LO       0x77
 #define I2C_ADDRESS_HI       0x78
 #define THRESHOLD            100
-#define DEVICE_MAX           4
+#ifndef GROVE_WATER_LEVEL_INSTANCES
+#define GROVE_WATER_LEVEL_INSTANCES 4
+#endif
 
 struct info {
     i2c i2c_dev;
@@ -47,7 +50,8 @@ struct info {
     int count;
 };
 
-static struct info info[DEVICE_MAX];
+static struct info info[GROVE_WATER_LEVEL_INSTANCES];
+GROVE_POOL(pool, GROVE_WATER_LEVEL_INSTANCES);
 
 /*
  * Documentation for public functions is provided as part of the external 
@@ -69,10 +73,7 @@ static struct info info[DEVICE_MAX];
  * 
  */
 static int next_index() {
-    for (int i = 0; i < DEVICE_MAX; ++i) {
-        if (info[i].count == 0) return i;
-    }
-    return -ENOMEM; 
+    return grove_pool_alloc(&pool);
 }
 
 /* Get the water level value
@@ -135,6 +136,7 @@ void grove_water_level_close(grove_water_level water_level) {
     if (--info[water_level].count != 0) return;
     i2c i2c_dev = info[water_level].i2c_dev;
     i2c_close(i2c_dev);
+    grove_pool_free(&pool, water_level);
 }
 
 py_float grove_water_level_get_level(grove_water_level water_level) {
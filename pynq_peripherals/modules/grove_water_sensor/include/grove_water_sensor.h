@@ -41,7 +41,7 @@
 /* Water_sensor class
  *
  * Available Methods:
- *    open, close, is_dry
+ *    open, close, is_dry, sample, watch
  *    
  */
 typedef py_int grove_water_sensor;
@@ -93,3 +93,41 @@ void grove_water_sensor_close(grove_water_sensor water);
  *
  */
 py_bool grove_water_sensor_is_dry(grove_water_sensor water);
+
+/* Take readings of the dry state periodically on the IOP
+ *
+ * Samples are 1.0 while dry and 0.0 while wet. The readings are collected from all sampled devices at once with
+ * grove_sampler_drain, or the drain method of the adapter.
+ *
+ * Parameters
+ * ----------
+ * period_us : unsigned int
+ *     Time between two readings in microseconds
+ *
+ * Returns
+ * -------
+ *   int:
+ *     Source id carried by the samples of this device
+ *     -EINVAL if the period is 0 (raises exception)
+ *     -ENOMEM if too many readings are sampled (raises exception)
+ *
+ */
+py_int grove_water_sensor_sample(grove_water_sensor water, unsigned int period_us);
+
+/* Record when the sensor gets wet and dry as gpio edge events
+ *
+ * The events are drained for all watched sensors at once with
+ * gpio_event_wait and gpio_event_read. The level of an event is
+ * 1 when the sensor becomes dry.
+ *
+ * Parameters
+ * ----------
+ *     None
+ *
+ * Returns
+ * -------
+ *     Watch id carried by the events of this sensor
+ *     -ENOMEM if too many pins are watched (raises exception)
+ *
+ */
+py_int grove_water_sensor_watch(grove_water_sensor water);
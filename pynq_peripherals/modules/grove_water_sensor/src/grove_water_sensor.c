@@ -31,16 +31,24 @@
  *****************************************************************************/
 
 #include <grove_interfaces.h>
+#include <grove_pool.h>
+#include <grove_sampler.h>
 #include <grove_water_sensor.h>
 
-#define DEVICE_MAX 4
+#ifndef GROVE_WATER_SENSOR_INSTANCES
+#define GROVE_WATER_SENSOR_INSTANCES 4
+#endif
 
 struct info {
     gpio pin;
+    int watch;
     int count;
 };
 
-static struct info info[DEVICE_MAX];
+static struct info info[GROVE_WATER_SENSOR_INSTANCES];
+GROVE_POOL(pool, GROVE_WATER_SENSOR_INSTANCES);
+
+static float water_is_dry(int water);
 
 /*
  * Documentation for public functions is provided as part of the external 
@@ -62,10 +70,7 @@ static struct info info[DEVICE_MAX];
  * 
  */
 static int next_index() {
-    for (int i = 0; i < DEVICE_MAX; ++i) {
-        if (info[i].count == 0) return i;
-    }
-    return -ENOMEM;
+    return grove_pool_alloc(&pool);
 }
 
 grove_water_sensor grove_water_sensor_open(int grove_id) {
@@ -73,6 +78,7 @@ grove_water_sensor grove_water_sensor_open(int grove_id) {
     if (dev_id >= 0) {
         info[dev_id].count++;
         info[dev_id].pin = gpio_open_grove(grove_id);
+        info[dev_id].watch = -1;
         gpio_set_direction(info[dev_id].pin, GPIO_IN);
     }
     return dev_id;
@@ -80,11 +86,29 @@ grove_water_sensor grove_water_sensor_open(int grove_id) {
 
 void grove_water_sensor_close(grove_water_sensor water) {
     if (--info[water].count != 0) return;
+    grove_sampler_forget(water_is_dry, water);
+    if (info[water].watch >= 0) gpio_event_unwatch(info[water].watch);
     gpio pin = info[water].pin;
     gpio_close(pin);
+    grove_pool_free(&pool, water);
 }
 
 py_bool grove_water_sensor_is_dry(grove_water_sensor water) {
     gpio pin = info[water].pin;
     return gpio_read(pin);
 }
+
+// The sampler stores readings as floats
+static float water_is_dry(int water) {
+    return grove_water_sensor_is_dry(water);
+}
+
+py_int grove_water_sensor_sample(grove_water_sensor water, unsigned int period_us) {
+    return grove_sampler_add(water_is_dry, water, period_us);
+}
+
+py_int grove_water_sensor_watch(grove_water_sensor water) {
+    if (info[water].watch < 0)
+        info[water].watch = gpio_event_watch(info[water].pin, GROVE_GPIO_BOTH);
+    return info[water].watch;
+}
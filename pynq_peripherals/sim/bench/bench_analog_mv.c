@@ -0,0 +1,135 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* Host cycles of the analog conversion paths
+ *
+ * Each call starts at an end of sequence of the simulated System Monitor,
+ * so the time measured is the driver and conversion code rather than the
+ * wait for a conversion. The fastest of many calls is reported to filter
+ * out host noise; analog_get_raw is the baseline without conversion. The
+ * host has a hardware FPU: on a MicroBlaze without one every float
+ * operation is a libgcc call, so the difference between the float and
+ * integer paths is much larger on the IOP.
+ */
+
+#include <stdio.h>
+#include <time.h>
+#include <sim.h>
+#include <grove_constants.h>
+#include <grove_interfaces.h>
+#include <grove_capacitive_soil_moisture.h>
+#include <grove_light.h>
+#include <grove_ph.h>
+#include <grove_potentiometer.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CYCLES_UNIT "cycles"
+static unsigned long long host_cycles(void) {
+    return __rdtsc();
+}
+#else
+#define CYCLES_UNIT "ns"
+static unsigned long long host_cycles(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+#endif
+
+#define BENCH_PORT      ARDUINO_SEEED_A0
+#define BENCH_CALLS     100000
+
+static int dev;
+
+static void raw(void) {
+    analog_get_raw(dev);
+}
+
+static void voltage(void) {
+    analog_get_voltage(dev);
+}
+
+static void millivolts(void) {
+    analog_get_millivolts(dev);
+}
+
+static void light(void) {
+    grove_light_get_intensity(dev);
+}
+
+static void potentiometer(void) {
+    grove_potentiometer_get_position(dev);
+}
+
+static void ph(void) {
+    grove_ph_get_ph(dev);
+}
+
+static void moisture(void) {
+    grove_capacitive_soil_moisture_get_moisture(dev);
+}
+
+struct bench_case {
+    const char *name;
+    int (*open)(int grove_id);
+    void (*call)(void);
+};
+
+static const struct bench_case cases[] = {
+    {"analog_get_raw", analog_open_grove, raw},
+    {"analog_get_voltage", analog_open_grove, voltage},
+    {"analog_get_millivolts", analog_open_grove, millivolts},
+    {"grove_light", grove_light_open, light},
+    {"grove_potentiometer", grove_potentiometer_open, potentiometer},
+    {"grove_ph", grove_ph_open, ph},
+    {"grove_soil_moisture", grove_capacitive_soil_moisture_open, moisture},
+};
+
+int main(void) {
+    printf("%-22s %12s\n", "call", "min_" CYCLES_UNIT);
+    for (unsigned int i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        sim_reset();
+        sim_xadc_set_aux(1, 0x8000);
+        dev = cases[i].open(BENCH_PORT);
+        unsigned long long best = ~0ull;
+        for (int n = 0; n < BENCH_CALLS; n++) {
+            sim_advance_ns(SIM_XADC_SEQUENCE_NS);
+            unsigned long long start = host_cycles();
+            cases[i].call();
+            unsigned long long elapsed = host_cycles() - start;
+            if (elapsed < best) best = elapsed;
+        }
+        printf("%-22s %12llu\n", cases[i].name, best);
+    }
+    return 0;
+}
@@ -0,0 +1,119 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* The led_meter helper of the plant monitoring app, call by call and batched
+ *
+ * led_meter sets the ten pixels of an LED stick and shows them. The call
+ * case makes one RPC per method call; the batch case sends the same calls
+ * as one command buffer to grove_batch_run, as GroveAdapter.batch does.
+ * Every RPC is charged BENCH_RPC_US for the mailbox round trip on top of
+ * the simulated time of the calls themselves.
+ */
+
+#include <stdio.h>
+#include <sim.h>
+#include <grove_constants.h>
+#include <grove_interfaces.h>
+#include <grove_led_stick.h>
+
+#define BENCH_PORT      ARDUINO_SEEED_D7
+#define BENCH_RPC_US    150
+#define BENCH_PIXELS    10
+#define BENCH_LEVEL     4
+
+static const unsigned int colors[BENCH_PIXELS] = {
+    0x0000FF, 0x00E4FF, 0x00FF5C, 0x00FF10, 0x3EFF00,
+    0xFFFA00, 0xFFC800, 0xFF4600, 0xFF2800, 0xFF0000,
+};
+
+static unsigned int name_hash(const char *name) {
+    unsigned int hash = 2166136261u;
+    while (*name) {
+        hash ^= (unsigned char)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static unsigned int pixel_color(int i) {
+    return i < BENCH_LEVEL ? colors[i] : 0;
+}
+
+static void report(const char *name, int calls, uint64_t ns) {
+    printf("%-8s %8d %10.1f\n", name, calls, ns / 1000.0);
+}
+
+static void run_calls(grove_led_stick stick) {
+    uint64_t start = sim_time_ns();
+    int calls = 0;
+    for (int i = 0; i < BENCH_PIXELS; i++) {
+        delay_us(BENCH_RPC_US);
+        grove_led_stick_set_pixel(stick, i, pixel_color(i));
+        calls++;
+    }
+    delay_us(BENCH_RPC_US);
+    grove_led_stick_show(stick);
+    calls++;
+    report("calls", calls, sim_time_ns() - start);
+}
+
+static void run_batch(grove_led_stick stick) {
+    unsigned int commands[5 * BENCH_PIXELS + 3];
+    int results[BENCH_PIXELS + 1];
+    int words = 0;
+    for (int i = 0; i < BENCH_PIXELS; i++) {
+        commands[words++] = name_hash("grove_led_stick_set_pixel");
+        commands[words++] = stick;
+        commands[words++] = 2;
+        commands[words++] = i;
+        commands[words++] = pixel_color(i);
+    }
+    commands[words++] = name_hash("grove_led_stick_show");
+    commands[words++] = stick;
+    commands[words++] = 0;
+
+    uint64_t start = sim_time_ns();
+    delay_us(BENCH_RPC_US);
+    int done = grove_batch_run(commands, words, results);
+    if (done != BENCH_PIXELS + 1) printf("batch stopped after %d\n", done);
+    report("batch", 1, sim_time_ns() - start);
+}
+
+int main(void) {
+    sim_reset();
+    grove_led_stick stick = grove_led_stick_open(BENCH_PORT);
+    printf("%-8s %8s %10s\n", "case", "calls", "time_us");
+    run_calls(stick);
+    run_batch(stick);
+    grove_led_stick_close(stick);
+    return 0;
+}
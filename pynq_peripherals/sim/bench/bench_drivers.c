@@ -0,0 +1,202 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* Latency and bus usage of the I2C Grove drivers on the simulated HAL
+ *
+ * Every case starts from a reset simulation with the device models of the
+ * sensor attached to the IO switch I2C bus and reports the simulated time
+ * of opening the driver and of one read, together with the bus traffic of
+ * the read.
+ */
+
+#include <stdio.h>
+#include <sim.h>
+#include <grove_constants.h>
+#include <grove_adc.h>
+#include <grove_barometer.h>
+#include <grove_envsensor.h>
+#include <grove_gesture.h>
+#include <grove_imu.h>
+#include <grove_lgcp.h>
+#include <grove_oled.h>
+
+#define BENCH_PORT      GROVE1
+#define BENCH_BUS       SIM_I2C_SWITCH
+#define BENCH_READS     10
+
+struct bench_case {
+    const char *name;
+    void (*attach)(void);
+    int (*open)(void);
+    void (*read)(int dev);
+    void (*close)(int dev);
+};
+
+static void attach_bme680(void) {
+    sim_i2c_attach(BENCH_BUS, sim_bme680_create(0x76));
+}
+
+static void attach_dps310(void) {
+    sim_i2c_attach(BENCH_BUS, sim_dps310_create(0x77));
+}
+
+static void attach_imu(void) {
+    struct sim_i2c_device *mpu = sim_mpu9250_create(0x68);
+    sim_i2c_attach(BENCH_BUS, mpu);
+    sim_i2c_attach(BENCH_BUS, sim_ak8963_create(mpu));
+    sim_i2c_attach(BENCH_BUS, sim_bmp280_create(0x77));
+}
+
+static void attach_apds9960(void) {
+    sim_i2c_attach(BENCH_BUS, sim_apds9960_create(0x39));
+}
+
+static void attach_paj7620(void) {
+    sim_i2c_attach(BENCH_BUS, sim_paj7620_create(0x73));
+}
+
+static void attach_ssd1327(void) {
+    sim_i2c_attach(BENCH_BUS, sim_ssd1327_create(0x3c));
+}
+
+static void attach_adc121(void) {
+    sim_i2c_attach(BENCH_BUS, sim_adc121_create(0x50));
+}
+
+static int open_envsensor(void) {
+    int dev = grove_envsensor_open_at_address(BENCH_PORT, 0x76);
+    if (dev >= 0 && !grove_envsensor_init(dev)) return -1;
+    return dev;
+}
+
+static void read_envsensor(int dev) {
+    grove_envsensor_read_temperature(dev);
+}
+
+static int open_barometer(void) {
+    int dev = grove_barometer_open(BENCH_PORT);
+    if (dev >= 0 && grove_barometer_configure(dev)) return -1;
+    return dev;
+}
+
+static void read_barometer(int dev) {
+    grove_barometer_pressure(dev);
+}
+
+static int open_imu(void) {
+    return grove_imu_open(BENCH_PORT);
+}
+
+static void read_imu(int dev) {
+    grove_imu_fetch_motion9(dev);
+}
+
+static int open_lgcp(void) {
+    return grove_lgcp_open(BENCH_PORT);
+}
+
+static void read_lgcp(int dev) {
+    grove_lgcp_get_rgbc_raw(dev);
+}
+
+static int open_gesture(void) {
+    return grove_gesture_open(BENCH_PORT);
+}
+
+static void read_gesture(int dev) {
+    grove_gesture_gesture(dev);
+}
+
+static int open_oled(void) {
+    return grove_oled_open(BENCH_PORT);
+}
+
+static void read_oled(int dev) {
+    grove_oled_put_char(dev, 'A');
+}
+
+static int open_adc(void) {
+    return grove_adc_open(BENCH_PORT);
+}
+
+static void read_adc(int dev) {
+    grove_adc_read_raw(dev);
+}
+
+static const struct bench_case cases[] = {
+    {"envsensor", attach_bme680, open_envsensor, read_envsensor,
+     grove_envsensor_close},
+    {"barometer", attach_dps310, open_barometer, read_barometer,
+     grove_barometer_close},
+    {"imu", attach_imu, open_imu, read_imu, grove_imu_close},
+    {"lgcp", attach_apds9960, open_lgcp, read_lgcp, grove_lgcp_close},
+    {"gesture", attach_paj7620, open_gesture, read_gesture,
+     grove_gesture_close},
+    {"oled", attach_ssd1327, open_oled, read_oled, grove_oled_close},
+    {"adc", attach_adc121, open_adc, read_adc, grove_adc_close},
+};
+
+static void run(const struct bench_case *c) {
+    sim_reset();
+    c->attach();
+
+    uint64_t start = sim_time_ns();
+    int dev = c->open();
+    uint64_t open_ns = sim_time_ns() - start;
+    if (dev < 0) {
+        printf("%-10s open failed (%d)\n", c->name, dev);
+        return;
+    }
+
+    sim_i2c_reset_stats(BENCH_BUS);
+    start = sim_time_ns();
+    for (int i = 0; i < BENCH_READS; i++) c->read(dev);
+    uint64_t read_ns = (sim_time_ns() - start) / BENCH_READS;
+    struct sim_i2c_stats s = sim_i2c_get_stats(BENCH_BUS);
+
+    printf("%-10s %10.1f %10.1f %8.1f %8.1f %8.1f %10.1f\n", c->name,
+           open_ns / 1000.0, read_ns / 1000.0,
+           (double)s.transactions / BENCH_READS,
+           (double)(s.bytes_written + s.bytes_read) / BENCH_READS,
+           (double)s.naks / BENCH_READS,
+           s.busy_ns / 1000.0 / BENCH_READS);
+    c->close(dev);
+}
+
+int main(void) {
+    printf("%-10s %10s %10s %8s %8s %8s %10s\n", "driver", "open_us",
+           "read_us", "xfers", "bytes", "naks", "bus_us");
+    for (unsigned int i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        run(&cases[i]);
+    }
+    return 0;
+}
@@ -0,0 +1,162 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* All four values of the environmental sensor, one by one and together
+ *
+ * The single case calls read_temperature, read_pressure, read_humidity and
+ * read_gas, so each value costs a forced mode measurement with its heater
+ * phase. The read_all case takes the four values from one measurement,
+ * and the cached case reads them back with the measured_ accessors. The
+ * fast case configures 1x oversampling and a 20 ms heater phase once and
+ * then reads all values with a trigger-only measurement.
+ *
+ * The pair cases read a second sensor as well, one after the other and
+ * with both conversions started before polling either.
+ */
+
+#include <stdio.h>
+#include <sim.h>
+#include <grove_constants.h>
+#include <grove_interfaces.h>
+#include <grove_envsensor.h>
+
+#define BENCH_PORT      GROVE1
+#define BENCH_ADDRESS   0x76
+#define BENCH_SECOND    0x77
+#define BENCH_POLL_US   1000
+
+static grove_envsensor envsensor;
+static grove_envsensor second;
+
+static void report(const char *name, uint64_t ns, const float *values) {
+    struct sim_i2c_stats stats = sim_i2c_get_stats(SIM_I2C_SWITCH);
+    printf("%-8s %10.1f %8lu %8.2f %10.0f %8.2f %10.0f\n", name, ns / 1e6,
+           stats.transactions,
+           values[GROVE_ENVSENSOR_TEMPERATURE],
+           values[GROVE_ENVSENSOR_PRESSURE],
+           values[GROVE_ENVSENSOR_HUMIDITY], values[GROVE_ENVSENSOR_GAS]);
+}
+
+static void run_single(void) {
+    float values[GROVE_ENVSENSOR_VALUES];
+    sim_i2c_reset_stats(SIM_I2C_SWITCH);
+    uint64_t start = sim_time_ns();
+    values[GROVE_ENVSENSOR_TEMPERATURE] =
+        grove_envsensor_read_temperature(envsensor);
+    values[GROVE_ENVSENSOR_PRESSURE] = grove_envsensor_read_pressure(envsensor);
+    values[GROVE_ENVSENSOR_HUMIDITY] = grove_envsensor_read_humidity(envsensor);
+    values[GROVE_ENVSENSOR_GAS] = grove_envsensor_read_gas(envsensor);
+    report("single", sim_time_ns() - start, values);
+}
+
+static void run_read_all(void) {
+    float values[GROVE_ENVSENSOR_VALUES];
+    sim_i2c_reset_stats(SIM_I2C_SWITCH);
+    uint64_t start = sim_time_ns();
+    if (grove_envsensor_read_all(envsensor, values))
+        printf("read_all failed\n");
+    report("read_all", sim_time_ns() - start, values);
+}
+
+static void measured(grove_envsensor p, float *values) {
+    values[GROVE_ENVSENSOR_TEMPERATURE] = grove_envsensor_measured_temperature(p);
+    values[GROVE_ENVSENSOR_PRESSURE] = grove_envsensor_measured_pressure(p);
+    values[GROVE_ENVSENSOR_HUMIDITY] = grove_envsensor_measured_humidity(p);
+    values[GROVE_ENVSENSOR_GAS] = grove_envsensor_measured_gas(p);
+}
+
+static void run_cached(void) {
+    float values[GROVE_ENVSENSOR_VALUES];
+    sim_i2c_reset_stats(SIM_I2C_SWITCH);
+    uint64_t start = sim_time_ns();
+    measured(envsensor, values);
+    report("cached", sim_time_ns() - start, values);
+}
+
+static void run_pair(void) {
+    float values[GROVE_ENVSENSOR_VALUES];
+    sim_i2c_reset_stats(SIM_I2C_SWITCH);
+    uint64_t start = sim_time_ns();
+    if (grove_envsensor_read_all(envsensor, values) ||
+        grove_envsensor_read_all(second, values))
+        printf("read_all failed\n");
+    report("pair", sim_time_ns() - start, values);
+}
+
+static void run_pair_overlapped(void) {
+    float values[GROVE_ENVSENSOR_VALUES];
+    sim_i2c_reset_stats(SIM_I2C_SWITCH);
+    uint64_t start = sim_time_ns();
+    if (grove_envsensor_start(envsensor) || grove_envsensor_start(second))
+        printf("start failed\n");
+    int pending;
+    do {
+        delay_us(BENCH_POLL_US);
+        pending = (grove_envsensor_poll(envsensor) == GROVE_PENDING) +
+            (grove_envsensor_poll(second) == GROVE_PENDING);
+    } while (pending);
+    measured(second, values);
+    report("overlap", sim_time_ns() - start, values);
+}
+
+static void run_fast(void) {
+    float values[GROVE_ENVSENSOR_VALUES];
+    if (grove_envsensor_configure(envsensor, 1, 1, 1, 300, 20))
+        printf("configure failed\n");
+    sim_i2c_reset_stats(SIM_I2C_SWITCH);
+    uint64_t start = sim_time_ns();
+    if (grove_envsensor_read_all(envsensor, values))
+        printf("read_all failed\n");
+    report("fast", sim_time_ns() - start, values);
+}
+
+int main(void) {
+    sim_reset();
+    sim_i2c_attach(SIM_I2C_SWITCH, sim_bme680_create(BENCH_ADDRESS));
+    sim_i2c_attach(SIM_I2C_SWITCH, sim_bme680_create(BENCH_SECOND));
+    envsensor = grove_envsensor_open_at_address(BENCH_PORT, BENCH_ADDRESS);
+    grove_envsensor_init(envsensor);
+    second = grove_envsensor_open_at_address(BENCH_PORT, BENCH_SECOND);
+    grove_envsensor_init(second);
+    grove_envsensor_configure(second, 2, 16, 1, 300, 100);
+    printf("%-8s %10s %8s %8s %10s %8s %10s\n", "case", "time_ms", "i2c",
+           "temp", "pressure", "humidity", "gas");
+    run_single();
+    run_read_all();
+    run_cached();
+    run_pair();
+    run_pair_overlapped();
+    run_fast();
+    grove_envsensor_close(second);
+    grove_envsensor_close(envsensor);
+    return 0;
+}
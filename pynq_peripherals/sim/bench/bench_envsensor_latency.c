@@ -0,0 +1,114 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* Latency of environmental sensor reads for each setting combination
+ *
+ * Each combination of oversampling (the same for temperature, pressure
+ * and humidity) and heater duration is configured once and read
+ * BENCH_READS times with read_all. The sensor model stretches every
+ * conversion by up to BENCH_JITTER percent, as a slow part would. The
+ * histogram counts reads by how far their latency is over the nominal
+ * conversion time from the datasheet formula.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sim.h>
+#include <grove_constants.h>
+#include <grove_interfaces.h>
+#include <grove_envsensor.h>
+
+#define BENCH_PORT      GROVE1
+#define BENCH_ADDRESS   0x76
+#define BENCH_READS     64
+#define BENCH_JITTER    5
+
+static const int oversampling[] = {1, 2, 4, 8, 16};
+static const int heater_ms[] = {0, 20, 100};
+static const double bucket_ms[] = {0.5, 1, 2, 5, 10};
+#define BUCKETS (sizeof(bucket_ms) / sizeof(bucket_ms[0]))
+
+static grove_envsensor envsensor;
+
+static double nominal_ms(int os, int heater) {
+    return (3 * os * 1963 + 477 * 4 + 477 * 5 + 500) / 1000.0 + heater;
+}
+
+static int compare(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void run(int os, int heater) {
+    double latency[BENCH_READS];
+    unsigned int histogram[BUCKETS + 1] = {0};
+    float values[GROVE_ENVSENSOR_VALUES];
+    double nominal = nominal_ms(os, heater);
+
+    if (grove_envsensor_configure(envsensor, os, os, os, 300, heater)) {
+        printf("configure failed\n");
+        return;
+    }
+    for (int i = 0; i < BENCH_READS; i++) {
+        uint64_t start = sim_time_ns();
+        if (grove_envsensor_read_all(envsensor, values))
+            printf("read_all failed\n");
+        latency[i] = (sim_time_ns() - start) / 1e6;
+        unsigned int b = 0;
+        while (b < BUCKETS && latency[i] - nominal >= bucket_ms[b]) b++;
+        histogram[b]++;
+    }
+    qsort(latency, BENCH_READS, sizeof(latency[0]), compare);
+    printf("%4d %6d %8.1f %8.1f %8.1f %8.1f ", os, heater, nominal,
+           latency[0], latency[BENCH_READS / 2], latency[BENCH_READS - 1]);
+    for (unsigned int b = 0; b <= BUCKETS; b++) printf(" %5u", histogram[b]);
+    printf("\n");
+}
+
+int main(void) {
+    sim_reset();
+    struct sim_i2c_device *bme680 = sim_bme680_create(BENCH_ADDRESS);
+    sim_i2c_attach(SIM_I2C_SWITCH, bme680);
+    sim_bme680_set_jitter(bme680, BENCH_JITTER);
+    envsensor = grove_envsensor_open_at_address(BENCH_PORT, BENCH_ADDRESS);
+    grove_envsensor_init(envsensor);
+
+    printf("%4s %6s %8s %8s %8s %8s ", "os", "heater", "nominal", "min",
+           "median", "max");
+    for (unsigned int b = 0; b < BUCKETS; b++) printf(" <%4g", bucket_ms[b]);
+    printf(" >=%3g\n", bucket_ms[BUCKETS - 1]);
+    for (unsigned int h = 0; h < sizeof(heater_ms) / sizeof(heater_ms[0]); h++)
+        for (unsigned int o = 0; o < sizeof(oversampling) / sizeof(oversampling[0]); o++)
+            run(oversampling[o], heater_ms[h]);
+    grove_envsensor_close(envsensor);
+    return 0;
+}
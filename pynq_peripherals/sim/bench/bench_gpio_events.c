@@ -0,0 +1,125 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* Short PIR pulses seen by polling against buffered edge events
+ *
+ * A train of short pulses is scheduled on the PIR input. The polling case
+ * models a notebook loop that calls grove_pir_motion_detected and sleeps
+ * between calls; the event case blocks in gpio_event_wait and drains the
+ * buffered edges with gpio_event_read. Calls are the RPCs each case makes.
+ */
+
+#include <stdio.h>
+#include <sim.h>
+#include <grove_constants.h>
+#include <grove_interfaces.h>
+#include <grove_pir.h>
+
+#define BENCH_PORT      PMOD_G1
+#define BENCH_PIN       0
+#define BENCH_PULSES    100
+#define BENCH_WIDTH_NS  20000ULL
+#define BENCH_SLEEP_MS  5
+#define BENCH_WAIT_US   100000
+
+static uint64_t pulse_at[BENCH_PULSES];
+
+static uint64_t schedule_pulses(void) {
+    uint64_t at = sim_time_ns() + 1000000;
+    for (int i = 0; i < BENCH_PULSES; i++) {
+        // Irregular spacing of 10 to 13 ms
+        at += 10000000ULL + (i * 7919ULL % 3000) * 1000;
+        pulse_at[i] = at;
+        sim_gpio_schedule_input(BENCH_PIN, 1, at);
+        sim_gpio_schedule_input(BENCH_PIN, 0, at + BENCH_WIDTH_NS);
+    }
+    return at + 10000000ULL;
+}
+
+static void report(const char *name, int caught, int calls, double latency) {
+    printf("%-8s %8d %8d %8d %12.1f\n", name, BENCH_PULSES, caught, calls,
+           latency);
+}
+
+static void run_poll(void) {
+    sim_reset();
+    grove_pir pir = grove_pir_open(BENCH_PORT);
+    uint64_t end = schedule_pulses();
+    int caught = 0, calls = 0, last = 0;
+    while (sim_time_ns() < end) {
+        int level = grove_pir_motion_detected(pir);
+        calls++;
+        if (level && !last) caught++;
+        last = level;
+        delay_ms(BENCH_SLEEP_MS);
+    }
+    report("poll", caught, calls, 0);
+    grove_pir_close(pir);
+}
+
+static void run_events(void) {
+    sim_reset();
+    grove_pir pir = grove_pir_open(BENCH_PORT);
+    int watch = grove_pir_watch(pir);
+    // Event timestamps are on the grove_time_us time base
+    uint64_t base_ns = sim_time_ns() - grove_time_us() * 1000;
+    uint64_t end = schedule_pulses();
+    unsigned int events[GROVE_GPIO_EVENT_WORDS * GROVE_GPIO_EVENT_DEPTH];
+    int caught = 0, calls = 1;
+    double latency = 0;
+    while (sim_time_ns() < end) {
+        gpio_event_wait(GROVE_GPIO_EVENT_DEPTH, BENCH_WAIT_US);
+        int n = gpio_event_read(events, GROVE_GPIO_EVENT_DEPTH);
+        calls += 2;
+        for (int i = 0; i < n; i++) {
+            const unsigned int *event = events + GROVE_GPIO_EVENT_WORDS * i;
+            if (GROVE_GPIO_EVENT_WATCH(event) != (unsigned int)watch ||
+                !GROVE_GPIO_EVENT_LEVEL(event)) continue;
+            // Both sides in whole microseconds of the time base
+            uint64_t seen_us = GROVE_GPIO_EVENT_TIME_US(event);
+            if (caught < BENCH_PULSES)
+                latency += (double)seen_us -
+                           (double)((pulse_at[caught] - base_ns) / 1000);
+            caught++;
+        }
+    }
+    report("events", caught, calls, caught ? latency / caught : 0);
+    grove_pir_close(pir);
+}
+
+int main(void) {
+    printf("%-8s %8s %8s %8s %12s\n", "case", "pulses", "caught", "calls",
+           "latency_us");
+    run_poll();
+    run_events();
+    return 0;
+}
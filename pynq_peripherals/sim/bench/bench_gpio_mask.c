@@ -0,0 +1,85 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* LED bar refresh cost of bit-banging both pins of a Grove port
+ *
+ * A refresh shifts 13 16-bit words into the LED bar and then latches them
+ * with four data pulses after a 10 ms pause. The pause is left out of the
+ * reported time so that only the pin writes are compared.
+ */
+
+#include <stdio.h>
+#include <sim.h>
+#include <grove_constants.h>
+#include <grove_ledbar.h>
+
+#define BENCH_RUNS      10
+#define BENCH_LATCH_NS  10000000ULL
+#define BENCH_BITS      (13 * 16)
+
+static const struct {
+    const char *name;
+    int port;
+} ports[] = {
+    {"PMOD_G1", PMOD_G1},
+    {"PMOD_G3", PMOD_G3},
+    {"SEEED_D2", ARDUINO_SEEED_D2},
+};
+
+int main(void) {
+    printf("%-10s %10s %10s %10s %10s\n", "port", "refresh_us", "reads",
+           "writes", "bits/us");
+    for (unsigned int i = 0; i < sizeof(ports) / sizeof(ports[0]); i++) {
+        sim_reset();
+        int dev = grove_ledbar_open(ports[i].port);
+        if (dev < 0) {
+            printf("%-10s open failed (%d)\n", ports[i].name, dev);
+            continue;
+        }
+
+        struct sim_gpio_stats before = sim_gpio_get_stats();
+        uint64_t start = sim_time_ns();
+        for (int run = 0; run < BENCH_RUNS; run++) {
+            grove_ledbar_set_level(dev, run % 11, 3, run & 1);
+        }
+        uint64_t run_ns = (sim_time_ns() - start) / BENCH_RUNS - BENCH_LATCH_NS;
+        struct sim_gpio_stats after = sim_gpio_get_stats();
+
+        printf("%-10s %10.1f %10.1f %10.1f %10.3f\n", ports[i].name,
+               run_ns / 1000.0,
+               (double)(after.reads - before.reads) / BENCH_RUNS,
+               (double)(after.writes - before.writes) / BENCH_RUNS,
+               BENCH_BITS * 1000.0 / run_ns);
+        grove_ledbar_close(dev);
+    }
+    return 0;
+}
@@ -0,0 +1,131 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* Driver throughput at each I2C bus speed
+ *
+ * The drivers declare fast mode as their maximum, so a placeholder device
+ * limited to the requested speed is opened on the port first to pin the
+ * negotiated bus clock. A requested speed above what the driver supports
+ * runs at the driver's maximum instead.
+ */
+
+#include <stdio.h>
+#include <sim.h>
+#include <grove_constants.h>
+#include <grove_interfaces.h>
+#include <grove_imu.h>
+#include <grove_oled.h>
+
+#define BENCH_PORT      GROVE1
+#define BENCH_BUS       SIM_I2C_SWITCH
+#define BENCH_RUNS      10
+
+struct bench_case {
+    const char *name;
+    void (*attach)(void);
+    int (*open)(void);
+    void (*run)(int dev);
+    void (*close)(int dev);
+};
+
+static void attach_imu(void) {
+    struct sim_i2c_device *mpu = sim_mpu9250_create(0x68);
+    sim_i2c_attach(BENCH_BUS, mpu);
+    sim_i2c_attach(BENCH_BUS, sim_ak8963_create(mpu));
+    sim_i2c_attach(BENCH_BUS, sim_bmp280_create(0x77));
+}
+
+static void attach_ssd1327(void) {
+    sim_i2c_attach(BENCH_BUS, sim_ssd1327_create(0x3c));
+}
+
+static int open_imu(void) {
+    return grove_imu_open(BENCH_PORT);
+}
+
+static void run_imu(int dev) {
+    grove_imu_fetch_motion9(dev);
+}
+
+static int open_oled(void) {
+    return grove_oled_open(BENCH_PORT);
+}
+
+static void run_oled(int dev) {
+    grove_oled_clear_display(dev);
+}
+
+static const struct bench_case cases[] = {
+    {"imu burst", attach_imu, open_imu, run_imu, grove_imu_close},
+    {"oled frame", attach_ssd1327, open_oled, run_oled, grove_oled_close},
+};
+
+static const unsigned int speeds[] = {
+    GROVE_I2C_STANDARD_HZ, GROVE_I2C_FAST_HZ, GROVE_I2C_FAST_PLUS_HZ
+};
+
+static void run(const struct bench_case *c, unsigned int hz) {
+    sim_reset();
+    c->attach();
+
+    i2c limit = i2c_open_grove_speed(BENCH_PORT, hz);
+    int dev = c->open();
+    if (dev < 0) {
+        printf("%-10s open failed (%d)\n", c->name, dev);
+        return;
+    }
+
+    sim_i2c_reset_stats(BENCH_BUS);
+    uint64_t start = sim_time_ns();
+    for (int i = 0; i < BENCH_RUNS; i++) c->run(dev);
+    uint64_t run_ns = (sim_time_ns() - start) / BENCH_RUNS;
+    struct sim_i2c_stats s = sim_i2c_get_stats(BENCH_BUS);
+    double bytes = (double)(s.bytes_written + s.bytes_read) / BENCH_RUNS;
+
+    printf("%-10s %10u %10u %10.1f %10.1f %8.1f %8.1f\n", c->name, hz,
+           i2c_get_speed(limit), run_ns / 1000.0,
+           s.busy_ns / 1000.0 / BENCH_RUNS, bytes,
+           bytes * 1000000.0 / run_ns);
+    c->close(dev);
+    i2c_close(limit);
+}
+
+int main(void) {
+    printf("%-10s %10s %10s %10s %10s %8s %8s\n", "case", "request_hz",
+           "bus_hz", "run_us", "bus_us", "bytes", "kB/s");
+    for (unsigned int i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        for (unsigned int j = 0; j < sizeof(speeds) / sizeof(speeds[0]); j++) {
+            run(&cases[i], speeds[j]);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* Time base accuracy while a servo runs, for IOPs with one or more timers
+ *
+ * Built with -DSIM_TIMERS=1 the servo has to share AXI timer 0 with the
+ * time base, as on the PMOD IOP, and the time base counts the 20 ms PWM
+ * periods. Each case reads the time base at a fixed interval, moving the
+ * servo on every read, and compares the time it measured with the
+ * simulated time. Built with the default six timers the servo gets a timer
+ * of its own and the time base is exact in every case.
+ */
+
+#include <stdio.h>
+#include <sim.h>
+#include <grove_constants.h>
+#include <grove_interfaces.h>
+#include <grove_servo.h>
+
+#define BENCH_PORT      PMOD_G1
+#define BENCH_PIN       0
+#define BENCH_READS     200
+
+static void run(const char *name, grove_servo servo, unsigned int interval_us,
+                int move) {
+    uint64_t start_ns = sim_time_ns();
+    unsigned long long start_us = grove_time_us();
+    for (int i = 0; i < BENCH_READS; i++) {
+        delay_us(interval_us);
+        if (move && servo >= 0)
+            grove_servo_set_angular_position(servo, (i * 37) % 180);
+        grove_time_us();
+    }
+    double real = (sim_time_ns() - start_ns) / 1e3;
+    double seen = grove_time_us() - start_us;
+    printf("%-12s %12u %14.0f %14.0f %8.2f\n", name, interval_us, real, seen,
+           100 * (seen - real) / real);
+}
+
+int main(void) {
+    sim_reset();
+    grove_servo servo = grove_servo_open(BENCH_PORT);
+    printf("timers %d servo %d period %u\n", XPAR_XTMRCTR_NUM_INSTANCES,
+           servo, sim_pwm_get_period(BENCH_PIN));
+    printf("%-12s %12s %14s %14s %8s\n", "case", "interval_us", "real_us",
+           "time_base_us", "error_%");
+    run("pwm", servo, 1000, 0);
+    run("pwm_move", servo, 1000, 1);
+    run("pwm", servo, 15000, 0);
+    run("pwm", servo, 50000, 0);
+    run("pwm_move", servo, 50000, 1);
+    if (servo >= 0) grove_servo_close(servo);
+    run("stopped", -1, 50000, 0);
+    return 0;
+}
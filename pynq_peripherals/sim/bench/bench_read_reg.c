@@ -0,0 +1,92 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* Register reads with and without a repeated start
+ *
+ * Compares the previous driver pattern of an i2c_write of the register
+ * pointer followed by a separate i2c_read against i2c_read_reg, which
+ * keeps the bus with a repeated start, for the burst lengths used by the
+ * Grove drivers.
+ */
+
+#include <stdio.h>
+#include <sim.h>
+#include <grove_constants.h>
+#include <grove_interfaces.h>
+
+#define BENCH_PORT      GROVE1
+#define BENCH_BUS       SIM_I2C_SWITCH
+#define BENCH_ADDRESS   0x76
+#define BENCH_REG       0x8A
+#define BENCH_READS     100
+
+static const unsigned int lengths[] = {1, 2, 3, 6, 8, 18};
+
+static void report(const char *name, unsigned int length, uint64_t ns) {
+    struct sim_i2c_stats s = sim_i2c_get_stats(BENCH_BUS);
+    printf("%-12s %4u %8.1f %8.1f %10.1f\n", name, length,
+           (double)s.transactions / BENCH_READS,
+           (double)s.calls / BENCH_READS,
+           ns / 1000.0 / BENCH_READS);
+}
+
+int main(void) {
+    unsigned char buffer[32];
+
+    sim_reset();
+    sim_i2c_attach(BENCH_BUS, sim_bme680_create(BENCH_ADDRESS));
+    i2c dev = i2c_open_grove(BENCH_PORT);
+
+    printf("%-12s %4s %8s %8s %10s\n", "method", "len", "xfers", "calls",
+           "read_us");
+    for (unsigned int i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        unsigned int length = lengths[i];
+        unsigned char reg = BENCH_REG;
+
+        sim_i2c_reset_stats(BENCH_BUS);
+        uint64_t start = sim_time_ns();
+        for (int n = 0; n < BENCH_READS; n++) {
+            i2c_write(dev, BENCH_ADDRESS, &reg, 1);
+            i2c_read(dev, BENCH_ADDRESS, buffer, length);
+        }
+        report("write+read", length, sim_time_ns() - start);
+
+        sim_i2c_reset_stats(BENCH_BUS);
+        start = sim_time_ns();
+        for (int n = 0; n < BENCH_READS; n++) {
+            i2c_read_reg(dev, BENCH_ADDRESS, reg, buffer, length);
+        }
+        report("read_reg", length, sim_time_ns() - start);
+    }
+    i2c_close(dev);
+    return 0;
+}
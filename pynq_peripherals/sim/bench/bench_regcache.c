@@ -0,0 +1,155 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* Bus cost of repeated configuration calls
+ *
+ * Each case opens a driver and then repeats a call that changes a few
+ * bits of configuration registers. With the shadow register cache the
+ * read half of each read-modify-write is served from the cached copy.
+ */
+
+#include <stdio.h>
+#include <sim.h>
+#include <grove_constants.h>
+#include <grove_barometer.h>
+#include <grove_envsensor.h>
+#include <grove_imu.h>
+#include <grove_lgcp.h>
+
+#define BENCH_PORT      GROVE1
+#define BENCH_BUS       SIM_I2C_SWITCH
+#define BENCH_CALLS     20
+
+struct bench_case {
+    const char *name;
+    void (*attach)(void);
+    int (*open)(void);
+    void (*call)(int dev);
+    void (*close)(int dev);
+};
+
+static void attach_imu(void) {
+    struct sim_i2c_device *mpu = sim_mpu9250_create(0x68);
+    sim_i2c_attach(BENCH_BUS, mpu);
+    sim_i2c_attach(BENCH_BUS, sim_ak8963_create(mpu));
+    sim_i2c_attach(BENCH_BUS, sim_bmp280_create(0x77));
+}
+
+static void attach_dps310(void) {
+    sim_i2c_attach(BENCH_BUS, sim_dps310_create(0x77));
+}
+
+static void attach_bme680(void) {
+    sim_i2c_attach(BENCH_BUS, sim_bme680_create(0x76));
+}
+
+static void attach_apds9960(void) {
+    sim_i2c_attach(BENCH_BUS, sim_apds9960_create(0x39));
+}
+
+static int open_imu(void) {
+    return grove_imu_open(BENCH_PORT);
+}
+
+static void imu_gyro_range(int dev) {
+    grove_imu_set_full_scale_gyro_range(dev, 1);
+}
+
+static int open_barometer(void) {
+    int dev = grove_barometer_open(BENCH_PORT);
+    if (dev >= 0 && grove_barometer_configure(dev)) return -1;
+    return dev;
+}
+
+static void barometer_fifo(int dev) {
+    grove_barometer_enable_fifo(dev, 0);
+}
+
+static int open_envsensor(void) {
+    int dev = grove_envsensor_open_at_address(BENCH_PORT, 0x76);
+    if (dev >= 0 && !grove_envsensor_init(dev)) return -1;
+    return dev;
+}
+
+static void envsensor_read(int dev) {
+    grove_envsensor_read_data(dev);
+}
+
+static int open_lgcp(void) {
+    return grove_lgcp_open(BENCH_PORT);
+}
+
+static void lgcp_als(int dev) {
+    grove_lgcp_select_als(dev);
+}
+
+static const struct bench_case cases[] = {
+    {"imu_gyro_range", attach_imu, open_imu, imu_gyro_range,
+     grove_imu_close},
+    {"barometer_fifo", attach_dps310, open_barometer, barometer_fifo,
+     grove_barometer_close},
+    {"envsensor_read", attach_bme680, open_envsensor, envsensor_read,
+     grove_envsensor_close},
+    {"lgcp_select_als", attach_apds9960, open_lgcp, lgcp_als,
+     grove_lgcp_close},
+};
+
+static void run(const struct bench_case *c) {
+    sim_reset();
+    c->attach();
+    int dev = c->open();
+    if (dev < 0) {
+        printf("%-16s open failed (%d)\n", c->name, dev);
+        return;
+    }
+
+    sim_i2c_reset_stats(BENCH_BUS);
+    uint64_t start = sim_time_ns();
+    for (int i = 0; i < BENCH_CALLS; i++) c->call(dev);
+    uint64_t call_ns = (sim_time_ns() - start) / BENCH_CALLS;
+    struct sim_i2c_stats s = sim_i2c_get_stats(BENCH_BUS);
+
+    printf("%-16s %8.1f %8.1f %8.1f %10.1f\n", c->name,
+           (double)s.transactions / BENCH_CALLS,
+           (double)s.bytes_read / BENCH_CALLS,
+           (double)s.bytes_written / BENCH_CALLS, call_ns / 1000.0);
+    c->close(dev);
+}
+
+int main(void) {
+    printf("%-16s %8s %8s %8s %10s\n", "call", "xfers", "rd_bytes",
+           "wr_bytes", "call_us");
+    for (unsigned int i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        run(&cases[i]);
+    }
+    return 0;
+}
@@ -0,0 +1,116 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* Readings per RPC of a notebook loop against the IOP sampler
+ *
+ * A temperature sensor and a water sensor are read for one second. The
+ * call case models a loop that makes one RPC per reading; the sampler case
+ * samples both sensors on the IOP and drains the ring buffer. Every RPC is
+ * charged BENCH_RPC_US for the mailbox round trip on top of the simulated
+ * time of the call itself.
+ */
+
+#include <stdio.h>
+#include <sim.h>
+#include <grove_constants.h>
+#include <grove_interfaces.h>
+#include <grove_temperature.h>
+#include <grove_water_sensor.h>
+
+#define BENCH_TEMP_PORT     ARDUINO_SEEED_A0
+#define BENCH_WATER_PORT    ARDUINO_SEEED_D2
+#define BENCH_RPC_US        150
+#define BENCH_RUN_NS        1000000000ULL
+#define BENCH_PERIOD_US     250
+#define BENCH_DRAIN         GROVE_SAMPLER_DEPTH
+#define BENCH_DRAIN_US      20000
+
+static grove_temperature temp;
+static grove_water_sensor water;
+
+static void setup(void) {
+    sim_reset();
+    temp = grove_temperature_open(BENCH_TEMP_PORT);
+    water = grove_water_sensor_open(BENCH_WATER_PORT);
+}
+
+static void teardown(void) {
+    grove_water_sensor_close(water);
+    grove_temperature_close(temp);
+}
+
+static void report(const char *name, int readings, int calls,
+                   unsigned int dropped) {
+    printf("%-8s %10d %8d %14.1f %8u\n", name, readings, calls,
+           (double)readings / calls, dropped);
+}
+
+static void run_calls(void) {
+    setup();
+    uint64_t end = sim_time_ns() + BENCH_RUN_NS;
+    int readings = 0, calls = 0;
+    while (sim_time_ns() < end) {
+        delay_us(BENCH_RPC_US);
+        grove_temperature_get_temperature(temp);
+        delay_us(BENCH_RPC_US);
+        grove_water_sensor_is_dry(water);
+        readings += 2;
+        calls += 2;
+    }
+    report("calls", readings, calls, 0);
+    teardown();
+}
+
+static void run_sampler(void) {
+    setup();
+    unsigned int words[GROVE_SAMPLE_WORDS * BENCH_DRAIN];
+    unsigned int dropped = grove_sampler_dropped();
+    grove_temperature_sample(temp, BENCH_PERIOD_US);
+    grove_water_sensor_sample(water, BENCH_PERIOD_US);
+    uint64_t end = sim_time_ns() + BENCH_RUN_NS;
+    int readings = 0, calls = 2;
+    while (sim_time_ns() < end) {
+        delay_us(BENCH_RPC_US);
+        readings += grove_sampler_drain(words, BENCH_DRAIN, BENCH_DRAIN_US);
+        calls++;
+    }
+    report("sampler", readings, calls, grove_sampler_dropped() - dropped);
+    teardown();
+}
+
+int main(void) {
+    printf("%-8s %10s %8s %14s %8s\n", "case", "readings", "calls",
+           "readings/call", "dropped");
+    run_calls();
+    run_sampler();
+    return 0;
+}
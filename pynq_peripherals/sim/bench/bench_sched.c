@@ -0,0 +1,119 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* Three slow sensors read one after the other against overlapped
+ *
+ * The IMU sits on the shield bus, the barometer and the environmental
+ * sensor on the IO switch bus. The blocking case calls the blocking read
+ * of each driver in turn. The overlapped case starts all three and polls
+ * them, so their conversions are in flight at the same time and the IOP
+ * only waits for the slowest. Polls are the RPCs a notebook loop makes.
+ */
+
+#include <stdio.h>
+#include <sim.h>
+#include <grove_constants.h>
+#include <grove_interfaces.h>
+#include <grove_barometer.h>
+#include <grove_envsensor.h>
+#include <grove_imu.h>
+
+#define BENCH_SWITCH_PORT   GROVE1
+#define BENCH_SHIELD_PORT   ARDUINO_SEEED_I2C
+#define BENCH_POLL_US       1000
+
+static grove_imu imu;
+static grove_barometer barometer;
+static grove_envsensor envsensor;
+
+static void setup(void) {
+    sim_reset();
+    struct sim_i2c_device *mpu = sim_mpu9250_create(0x68);
+    sim_i2c_attach(SIM_I2C_SHIELD, mpu);
+    sim_i2c_attach(SIM_I2C_SHIELD, sim_ak8963_create(mpu));
+    sim_i2c_attach(SIM_I2C_SHIELD, sim_bmp280_create(0x77));
+    sim_i2c_attach(SIM_I2C_SWITCH, sim_dps310_create(0x77));
+    sim_i2c_attach(SIM_I2C_SWITCH, sim_bme680_create(0x76));
+    imu = grove_imu_open(BENCH_SHIELD_PORT);
+    barometer = grove_barometer_open(BENCH_SWITCH_PORT);
+    grove_barometer_configure(barometer);
+    envsensor = grove_envsensor_open_at_address(BENCH_SWITCH_PORT, 0x76);
+    grove_envsensor_init(envsensor);
+}
+
+static void teardown(void) {
+    grove_envsensor_close(envsensor);
+    grove_barometer_close(barometer);
+    grove_imu_close(imu);
+}
+
+static void report(const char *name, uint64_t ns, int polls) {
+    printf("%-12s %10.1f %8d %10.4f %12.1f\n", name, ns / 1e6, polls,
+           grove_imu_get_accel_z(imu),
+           grove_barometer_measured_pressure(barometer));
+}
+
+static void run_blocking(void) {
+    setup();
+    uint64_t start = sim_time_ns();
+    grove_imu_fetch_motion9(imu);
+    grove_barometer_pressure(barometer);
+    grove_envsensor_read_data(envsensor);
+    report("blocking", sim_time_ns() - start, 0);
+    teardown();
+}
+
+static void run_overlapped(void) {
+    setup();
+    uint64_t start = sim_time_ns();
+    grove_imu_start_motion9(imu);
+    grove_barometer_start_measurement(barometer);
+    grove_envsensor_start(envsensor);
+    int polls = 0, pending = 3;
+    while (pending) {
+        delay_us(BENCH_POLL_US);
+        pending = (grove_imu_poll_motion9(imu) == GROVE_PENDING) +
+            (grove_barometer_poll_measurement(barometer) == GROVE_PENDING) +
+            (grove_envsensor_poll(envsensor) == GROVE_PENDING);
+        polls += 3;
+    }
+    report("overlapped", sim_time_ns() - start, polls);
+    teardown();
+}
+
+int main(void) {
+    printf("%-12s %10s %8s %10s %12s\n", "case", "time_ms", "polls",
+           "accel_z", "pressure");
+    run_blocking();
+    run_overlapped();
+    return 0;
+}
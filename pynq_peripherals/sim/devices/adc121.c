@@ -0,0 +1,100 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* TI ADC121C021 12-bit ADC of the Grove I2C ADC
+ *
+ * The result, limit and hysteresis registers are 16 bits wide and
+ * transferred MSB first; the status and configuration registers are 8 bits.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sim.h>
+
+#define REG_RESULT      0x00
+#define REG_ALERT       0x01
+#define REG_CONFIG      0x02
+#define REG_NUM         8
+
+struct adc121 {
+    struct sim_i2c_device dev;
+    unsigned short value[REG_NUM];
+    unsigned int raw;
+    unsigned int byte;
+};
+
+static int is_wide(unsigned char reg) {
+    return reg != REG_ALERT && reg != REG_CONFIG;
+}
+
+static int transfer(struct sim_i2c_device *dev, int read,
+                    unsigned char *buffer, unsigned int length) {
+    struct adc121 *s = (struct adc121 *)dev;
+    unsigned int i = 0;
+    if (!read) {
+        if (length == 0) return 0;
+        if (buffer[0] >= REG_NUM) return -1;
+        dev->pointer = buffer[i++];
+        s->byte = 0;
+        unsigned short value = 0;
+        for (; i < length; i++) value = (value << 8) | buffer[i];
+        if (length > 1 && dev->pointer != REG_RESULT) {
+            s->value[dev->pointer] = value;
+        }
+        return 0;
+    }
+    s->value[REG_RESULT] = s->raw & 0x0FFF;
+    for (; i < length; i++) {
+        unsigned short value = s->value[dev->pointer];
+        if (is_wide(dev->pointer)) {
+            buffer[i] = (s->byte++ & 1) ? (value & 0xFF) : (value >> 8);
+        } else {
+            buffer[i] = value & 0xFF;
+        }
+    }
+    return 0;
+}
+
+void sim_adc121_set_raw(struct sim_i2c_device *dev, unsigned int raw) {
+    ((struct adc121 *)dev)->raw = raw;
+}
+
+struct sim_i2c_device *sim_adc121_create(unsigned char address) {
+    struct adc121 *s = (struct adc121 *)calloc(1, sizeof(*s));
+    if (!s) return NULL;
+    s->dev.name = "adc121";
+    s->dev.address = address;
+    s->dev.transfer = transfer;
+    s->value[4] = 0x0FFF;
+    s->raw = 2048;
+    return &s->dev;
+}
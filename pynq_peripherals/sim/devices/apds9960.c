@@ -0,0 +1,117 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* Broadcom APDS-9960 / ams TMG3993 light, colour, gesture and proximity
+ * sensor as found on the Grove Light Gesture Color Proximity sensor
+ *
+ * ALS and proximity results become valid one integration time after the
+ * corresponding engine is enabled.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sim.h>
+
+#define REG_ENABLE      0x80
+#define REG_ATIME       0x81
+#define REG_ID          0x92
+#define REG_STATUS      0x93
+#define REG_RGBC_DATA   0x94
+#define REG_PROX_DATA   0x9C
+
+#define ENABLE_PON      0x01
+#define ENABLE_AEN      0x02
+#define ENABLE_PEN      0x04
+
+#define STATUS_AVALID   0x01
+#define STATUS_PVALID   0x02
+
+/* Integration cycle of the ALS engine */
+#define ATIME_CYCLE_NS  2780000ull
+
+struct apds9960 {
+    struct sim_i2c_device dev;
+    uint64_t enabled_ns;
+};
+
+static void update(struct apds9960 *s) {
+    unsigned char *r = s->dev.regs;
+    if (!(r[REG_ENABLE] & ENABLE_PON)) {
+        r[REG_STATUS] &= ~(STATUS_AVALID | STATUS_PVALID);
+        return;
+    }
+    uint64_t since = sim_time_ns() - s->enabled_ns;
+    uint64_t atime = (256 - r[REG_ATIME]) * ATIME_CYCLE_NS;
+    if ((r[REG_ENABLE] & ENABLE_AEN) && since >= atime) {
+        r[REG_STATUS] |= STATUS_AVALID;
+    }
+    if ((r[REG_ENABLE] & ENABLE_PEN) && since >= ATIME_CYCLE_NS) {
+        r[REG_STATUS] |= STATUS_PVALID;
+    }
+}
+
+static void reg_write(struct sim_i2c_device *dev, unsigned char reg,
+                      unsigned char value) {
+    struct apds9960 *s = (struct apds9960 *)dev;
+    if (reg == REG_ID || reg == REG_STATUS ||
+        (reg >= REG_RGBC_DATA && reg <= REG_PROX_DATA)) {
+        return;
+    }
+    if (reg == REG_ENABLE && value != dev->regs[reg]) {
+        s->enabled_ns = sim_time_ns();
+        dev->regs[REG_STATUS] = 0;
+    }
+    dev->regs[reg] = value;
+}
+
+static unsigned char reg_read(struct sim_i2c_device *dev, unsigned char reg) {
+    update((struct apds9960 *)dev);
+    return dev->regs[reg];
+}
+
+struct sim_i2c_device *sim_apds9960_create(unsigned char address) {
+    static const unsigned short rgbc[4] = {812, 233, 301, 196};
+    struct apds9960 *s = (struct apds9960 *)calloc(1, sizeof(*s));
+    if (!s) return NULL;
+    s->dev.name = "apds9960";
+    s->dev.address = address;
+    s->dev.reg_write = reg_write;
+    s->dev.reg_read = reg_read;
+    s->dev.regs[REG_ATIME] = 0xFF;
+    s->dev.regs[REG_ID] = 0xA8;
+    for (int i = 0; i < 4; i++) {
+        s->dev.regs[REG_RGBC_DATA + 2 * i] = rgbc[i] & 0xFF;
+        s->dev.regs[REG_RGBC_DATA + 2 * i + 1] = rgbc[i] >> 8;
+    }
+    s->dev.regs[REG_PROX_DATA] = 42;
+    return &s->dev;
+}
@@ -0,0 +1,183 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* Bosch BME680 environmental sensor
+ *
+ * Forced mode conversions take the TPH duration of the programmed
+ * oversampling plus the heater wait time of profile 0. meas_status_0
+ * reports new_data once the conversion has finished. A jitter set with
+ * sim_bme680_set_jitter stretches each conversion by a pseudo-random part
+ * of that duration, as the internal oscillator of a part may run slow.
+ * Writes carry a register address before every data byte, as on the
+ * real part, instead of auto-incrementing.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sim.h>
+
+#define REG_STATUS      0x1D
+#define REG_GAS_WAIT0   0x64
+#define REG_CTRL_GAS_1  0x71
+#define REG_CTRL_HUM    0x72
+#define REG_CTRL_MEAS   0x74
+#define REG_CHIP_ID     0xD0
+#define REG_RESET       0xE0
+
+#define CHIP_ID         0x61
+#define RESET_CMD       0xB6
+
+struct bme680 {
+    struct sim_i2c_device dev;
+    uint64_t done_ns;
+    int measuring;
+    unsigned char meas_index;
+    unsigned int jitter_percent;
+    unsigned int seed;
+};
+
+/* Calibration image of 0x89-0xA1 followed by 0xE1-0xF0 */
+static const unsigned char calibration[41] = {
+    0x00, 0xE6, 0x66, 0x03, 0x00, 0x94, 0x8D, 0x11, 0xD7, 0x58, 0x00, 0xB5,
+    0x1B, 0x9C, 0xFF, 0x28, 0x1E, 0x00, 0x00, 0x09, 0xF4, 0xB5, 0xF9, 0x1E,
+    0x00, 0x41, 0x63, 0x31, 0x00, 0x2D, 0x14, 0x78, 0x9C, 0x59, 0x66, 0x30,
+    0xD4, 0xD4, 0x12, 0x00, 0x00,
+};
+
+static void set_field(struct bme680 *s) {
+    unsigned char *f = &s->dev.regs[REG_STATUS];
+    unsigned int temp = 497680, pres = 360000, hum = 23000, gas = 512;
+    int run_gas = s->dev.regs[REG_CTRL_GAS_1] & 0x10;
+
+    f[0] = 0x80;
+    f[1] = s->meas_index++;
+    f[2] = pres >> 12;
+    f[3] = pres >> 4;
+    f[4] = (pres & 0xF) << 4;
+    f[5] = temp >> 12;
+    f[6] = temp >> 4;
+    f[7] = (temp & 0xF) << 4;
+    f[8] = hum >> 8;
+    f[9] = hum;
+    f[13] = gas >> 2;
+    f[14] = ((gas & 0x3) << 6) | (run_gas ? 0x30 : 0x00) | 0x04;
+}
+
+static void update(struct bme680 *s) {
+    if (s->measuring && sim_time_ns() >= s->done_ns) {
+        s->measuring = 0;
+        s->dev.regs[REG_CTRL_MEAS] &= ~0x03;
+        set_field(s);
+    }
+}
+
+static uint64_t conversion_ns(struct bme680 *s) {
+    static const unsigned char cycles[8] = {0, 1, 2, 4, 8, 16, 16, 16};
+    unsigned char *r = s->dev.regs;
+    uint64_t us = cycles[r[REG_CTRL_MEAS] >> 5] +
+                  cycles[(r[REG_CTRL_MEAS] >> 2) & 0x7] +
+                  cycles[r[REG_CTRL_HUM] & 0x7];
+    us = us * 1963 + 477 * 4 + 477 * 5 + 500;
+    if (r[REG_CTRL_GAS_1] & 0x10) {
+        unsigned char wait = r[REG_GAS_WAIT0];
+        us += (uint64_t)(wait & 0x3F) * (1u << (2 * (wait >> 6))) * 1000;
+    }
+    uint64_t ns = us * 1000;
+    if (s->jitter_percent) {
+        s->seed = s->seed * 1103515245u + 12345u;
+        ns += ns * s->jitter_percent / 100 * ((s->seed >> 16) & 0x7FFF) / 0x8000;
+    }
+    return ns;
+}
+
+static void reset(struct bme680 *s) {
+    unsigned char *r = s->dev.regs;
+    memset(r, 0, sizeof(s->dev.regs));
+    memcpy(&r[0x89], calibration, 25);
+    memcpy(&r[0xE1], &calibration[25], 16);
+    r[0x00] = 0x30;         /* res_heat_val */
+    r[0x02] = 0x10;         /* res_heat_range */
+    r[0x04] = 0x00;         /* range_switching_error */
+    r[REG_CHIP_ID] = CHIP_ID;
+    s->measuring = 0;
+}
+
+static void reg_write(struct sim_i2c_device *dev, unsigned char reg,
+                      unsigned char value) {
+    struct bme680 *s = (struct bme680 *)dev;
+    update(s);
+    if (reg == REG_RESET) {
+        if (value == RESET_CMD) reset(s);
+        return;
+    }
+    if (reg == REG_STATUS || reg == REG_CHIP_ID) return;
+    dev->regs[reg] = value;
+    if (reg == REG_CTRL_MEAS && (value & 0x03) == 0x01 && !s->measuring) {
+        s->measuring = 1;
+        s->done_ns = sim_time_ns() + conversion_ns(s);
+        dev->regs[REG_STATUS] = 0x20;
+    }
+}
+
+static unsigned char reg_read(struct sim_i2c_device *dev, unsigned char reg) {
+    struct bme680 *s = (struct bme680 *)dev;
+    update(s);
+    return dev->regs[reg];
+}
+
+static int transfer(struct sim_i2c_device *dev, int read,
+                    unsigned char *buffer, unsigned int length) {
+    if (read) return sim_regdev_transfer(dev, read, buffer, length);
+    for (unsigned int i = 0; i < length; i += 2) {
+        dev->pointer = buffer[i];
+        if (i + 1 < length) reg_write(dev, buffer[i], buffer[i + 1]);
+    }
+    return 0;
+}
+
+struct sim_i2c_device *sim_bme680_create(unsigned char address) {
+    struct bme680 *s = (struct bme680 *)calloc(1, sizeof(*s));
+    if (!s) return NULL;
+    s->dev.name = "bme680";
+    s->dev.address = address;
+    s->dev.reg_write = reg_write;
+    s->dev.reg_read = reg_read;
+    s->dev.transfer = transfer;
+    reset(s);
+    return &s->dev;
+}
+
+void sim_bme680_set_jitter(struct sim_i2c_device *dev, unsigned int percent) {
+    struct bme680 *s = (struct bme680 *)dev;
+    s->jitter_percent = percent;
+    s->seed = 1;
+}
@@ -0,0 +1,170 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* Infineon DPS310 barometric pressure sensor in command mode
+ *
+ * SENSOR_RDY and COEF_RDY in MEAS_CFG are raised a fixed time after a soft
+ * reset and each command mode conversion takes the datasheet time for the
+ * programmed oversampling rate.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sim.h>
+
+#define REG_PRS_B0      0x02
+#define REG_TMP_B0      0x05
+#define REG_PRS_CFG     0x06
+#define REG_TMP_CFG     0x07
+#define REG_MEAS_CFG    0x08
+#define REG_RESET       0x0C
+#define REG_ID          0x0D
+#define REG_COEF        0x10
+#define REG_COEF_SRCE   0x28
+
+#define COEF_RDY        0x80
+#define SENSOR_RDY      0x40
+#define TMP_RDY         0x20
+#define PRS_RDY         0x10
+
+#define SENSOR_RDY_NS   12000000ull
+#define COEF_RDY_NS     40000000ull
+
+struct dps310 {
+    struct sim_i2c_device dev;
+    uint64_t reset_ns;
+    uint64_t done_ns;
+    unsigned char pending;
+};
+
+/* Conversion time per oversampling rate in microseconds */
+static const unsigned int conversion_us[8] = {
+    3600, 5200, 8400, 14800, 27600, 53200, 104400, 206800
+};
+
+static void put_coefficients(unsigned char *c) {
+    int c0 = 204, c1 = -261, c00 = 80469, c10 = -54769;
+    int c16[5] = {-2788, 1234, -10012, 200, -1500};
+    c[0] = (c0 >> 4) & 0xFF;
+    c[1] = ((c0 & 0xF) << 4) | ((c1 >> 8) & 0xF);
+    c[2] = c1 & 0xFF;
+    c[3] = (c00 >> 12) & 0xFF;
+    c[4] = (c00 >> 4) & 0xFF;
+    c[5] = ((c00 & 0xF) << 4) | ((c10 >> 16) & 0xF);
+    c[6] = (c10 >> 8) & 0xFF;
+    c[7] = c10 & 0xFF;
+    for (int i = 0; i < 5; i++) {
+        c[8 + 2 * i] = (c16[i] >> 8) & 0xFF;
+        c[9 + 2 * i] = c16[i] & 0xFF;
+    }
+}
+
+static void put_result(unsigned char *r, int value) {
+    r[0] = (value >> 16) & 0xFF;
+    r[1] = (value >> 8) & 0xFF;
+    r[2] = value & 0xFF;
+}
+
+static void reset(struct dps310 *s) {
+    unsigned char *r = s->dev.regs;
+    memset(r, 0, sizeof(s->dev.regs));
+    r[REG_ID] = 0x10;
+    r[REG_COEF_SRCE] = 0x80;
+    put_coefficients(&r[REG_COEF]);
+    s->reset_ns = sim_time_ns();
+    s->pending = 0;
+}
+
+static void update(struct dps310 *s) {
+    unsigned char *meas = &s->dev.regs[REG_MEAS_CFG];
+    uint64_t since = sim_time_ns() - s->reset_ns;
+    if (since >= SENSOR_RDY_NS) *meas |= SENSOR_RDY;
+    if (since >= COEF_RDY_NS) *meas |= COEF_RDY;
+    if (s->pending && sim_time_ns() >= s->done_ns) {
+        if (s->pending == 1) {
+            put_result(&s->dev.regs[0x00], -793805);
+            *meas |= PRS_RDY;
+        } else {
+            put_result(&s->dev.regs[0x03], 616243);
+            *meas |= TMP_RDY;
+        }
+        *meas &= ~0x07;
+        s->pending = 0;
+    }
+}
+
+static void reg_write(struct sim_i2c_device *dev, unsigned char reg,
+                      unsigned char value) {
+    struct dps310 *s = (struct dps310 *)dev;
+    update(s);
+    switch (reg) {
+    case REG_RESET:
+        if ((value & 0x0F) == 0x09) reset(s);
+        break;
+    case REG_MEAS_CFG:
+        dev->regs[reg] = (dev->regs[reg] & 0xF0) | (value & 0x07);
+        if ((value & 0x07) == 1 || (value & 0x07) == 2) {
+            unsigned char cfg = dev->regs[(value & 0x07) == 1 ?
+                                          REG_PRS_CFG : REG_TMP_CFG];
+            s->pending = value & 0x07;
+            s->done_ns = sim_time_ns() + conversion_us[cfg & 0x7] * 1000ull;
+            dev->regs[reg] &= ~(s->pending == 1 ? PRS_RDY : TMP_RDY);
+        }
+        break;
+    case REG_ID:
+    case REG_COEF_SRCE:
+        break;
+    default:
+        if (reg < REG_COEF) dev->regs[reg] = value;
+        break;
+    }
+}
+
+static unsigned char reg_read(struct sim_i2c_device *dev, unsigned char reg) {
+    struct dps310 *s = (struct dps310 *)dev;
+    update(s);
+    unsigned char value = dev->regs[reg];
+    if (reg == REG_PRS_B0) dev->regs[REG_MEAS_CFG] &= ~PRS_RDY;
+    if (reg == REG_TMP_B0) dev->regs[REG_MEAS_CFG] &= ~TMP_RDY;
+    return value;
+}
+
+struct sim_i2c_device *sim_dps310_create(unsigned char address) {
+    struct dps310 *s = (struct dps310 *)calloc(1, sizeof(*s));
+    if (!s) return NULL;
+    s->dev.name = "dps310";
+    s->dev.address = address;
+    s->dev.reg_write = reg_write;
+    s->dev.reg_read = reg_read;
+    reset(s);
+    return &s->dev;
+}
@@ -0,0 +1,204 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* InvenSense MPU-9250 with its AK8963 magnetometer and the BMP280 found on
+ * the Grove IMU 10DOF
+ *
+ * The AK8963 only answers on the bus while the MPU-9250 has the auxiliary
+ * I2C bypass enabled in INT_PIN_CFG.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sim.h>
+
+#define MPU_INT_PIN_CFG     0x37
+#define MPU_ACCEL_XOUT_H    0x3B
+#define MPU_PWR_MGMT_1      0x6B
+#define MPU_WHO_AM_I        0x75
+#define MPU_BYPASS_EN       0x02
+#define MPU_DEVICE_RESET    0x80
+
+#define AK_ADDRESS          0x0C
+#define AK_WIA              0x00
+#define AK_ST1              0x02
+#define AK_HXL              0x03
+#define AK_ST2              0x09
+#define AK_CNTL1            0x0A
+#define AK_MEASURE_NS       7200000ull
+
+#define BMP_CHIP_ID         0xD0
+#define BMP_RESET           0xE0
+#define BMP_CTRL_MEAS       0xF4
+#define BMP_PRESS_MSB       0xF7
+
+struct mpu9250 {
+    struct sim_i2c_device dev;
+};
+
+struct ak8963 {
+    struct sim_i2c_device dev;
+    struct sim_i2c_device *mpu;
+    uint64_t done_ns;
+    int measuring;
+};
+
+static void put_be16(unsigned char *r, int value) {
+    r[0] = (value >> 8) & 0xFF;
+    r[1] = value & 0xFF;
+}
+
+static void put_le16(unsigned char *r, int value) {
+    r[0] = value & 0xFF;
+    r[1] = (value >> 8) & 0xFF;
+}
+
+static void mpu_reset(struct sim_i2c_device *dev) {
+    unsigned char *r = dev->regs;
+    memset(r, 0, sizeof(dev->regs));
+    r[MPU_PWR_MGMT_1] = 0x40;
+    r[MPU_WHO_AM_I] = 0x71;
+    put_be16(&r[MPU_ACCEL_XOUT_H + 0], 120);
+    put_be16(&r[MPU_ACCEL_XOUT_H + 2], -64);
+    put_be16(&r[MPU_ACCEL_XOUT_H + 4], 16384);
+    put_be16(&r[MPU_ACCEL_XOUT_H + 6], 4200);
+    put_be16(&r[MPU_ACCEL_XOUT_H + 8], 13);
+    put_be16(&r[MPU_ACCEL_XOUT_H + 10], -7);
+    put_be16(&r[MPU_ACCEL_XOUT_H + 12], 2);
+}
+
+static void mpu_write(struct sim_i2c_device *dev, unsigned char reg,
+                      unsigned char value) {
+    if (reg == MPU_WHO_AM_I || (reg >= MPU_ACCEL_XOUT_H && reg < 0x49)) {
+        return;
+    }
+    if (reg == MPU_PWR_MGMT_1 && (value & MPU_DEVICE_RESET)) {
+        mpu_reset(dev);
+        return;
+    }
+    dev->regs[reg] = value;
+}
+
+struct sim_i2c_device *sim_mpu9250_create(unsigned char address) {
+    struct mpu9250 *s = (struct mpu9250 *)calloc(1, sizeof(*s));
+    if (!s) return NULL;
+    s->dev.name = "mpu9250";
+    s->dev.address = address;
+    s->dev.reg_write = mpu_write;
+    mpu_reset(&s->dev);
+    return &s->dev;
+}
+
+static int ak_ack(struct sim_i2c_device *dev) {
+    struct ak8963 *s = (struct ak8963 *)dev;
+    return (s->mpu->regs[MPU_INT_PIN_CFG] & MPU_BYPASS_EN) ? 0 : -1;
+}
+
+static void ak_update(struct ak8963 *s) {
+    if (s->measuring && sim_time_ns() >= s->done_ns) {
+        s->measuring = 0;
+        s->dev.regs[AK_ST1] |= 0x01;
+        s->dev.regs[AK_CNTL1] &= ~0x0F;
+    }
+}
+
+static void ak_write(struct sim_i2c_device *dev, unsigned char reg,
+                     unsigned char value) {
+    struct ak8963 *s = (struct ak8963 *)dev;
+    ak_update(s);
+    if (reg != AK_CNTL1) return;
+    dev->regs[reg] = value;
+    if ((value & 0x0F) == 0x01) {
+        s->measuring = 1;
+        s->done_ns = sim_time_ns() + AK_MEASURE_NS;
+    }
+}
+
+static unsigned char ak_read(struct sim_i2c_device *dev, unsigned char reg) {
+    struct ak8963 *s = (struct ak8963 *)dev;
+    ak_update(s);
+    unsigned char value = dev->regs[reg];
+    if (reg == AK_ST2) dev->regs[AK_ST1] &= ~0x01;
+    return value;
+}
+
+struct sim_i2c_device *sim_ak8963_create(struct sim_i2c_device *mpu) {
+    struct ak8963 *s = (struct ak8963 *)calloc(1, sizeof(*s));
+    if (!s) return NULL;
+    s->dev.name = "ak8963";
+    s->dev.address = AK_ADDRESS;
+    s->dev.ack = ak_ack;
+    s->dev.reg_write = ak_write;
+    s->dev.reg_read = ak_read;
+    s->mpu = mpu;
+    s->dev.regs[AK_WIA] = 0x48;
+    put_le16(&s->dev.regs[AK_HXL + 0], 152);
+    put_le16(&s->dev.regs[AK_HXL + 2], -310);
+    put_le16(&s->dev.regs[AK_HXL + 4], 402);
+    return &s->dev;
+}
+
+static void bmp_reset(struct sim_i2c_device *dev) {
+    static const int dig[12] = {27504, 26435, -1000, 36477, -10685, 3024,
+                                2855, 140, -7, 15500, -14600, 6000};
+    unsigned char *r = dev->regs;
+    unsigned int adc_p = 415148, adc_t = 519888;
+    memset(r, 0, sizeof(dev->regs));
+    for (int i = 0; i < 12; i++) put_le16(&r[0x88 + 2 * i], dig[i]);
+    r[BMP_CHIP_ID] = 0x58;
+    r[BMP_PRESS_MSB + 0] = adc_p >> 12;
+    r[BMP_PRESS_MSB + 1] = adc_p >> 4;
+    r[BMP_PRESS_MSB + 2] = (adc_p & 0xF) << 4;
+    r[BMP_PRESS_MSB + 3] = adc_t >> 12;
+    r[BMP_PRESS_MSB + 4] = adc_t >> 4;
+    r[BMP_PRESS_MSB + 5] = (adc_t & 0xF) << 4;
+}
+
+static void bmp_write(struct sim_i2c_device *dev, unsigned char reg,
+                      unsigned char value) {
+    if (reg == BMP_RESET) {
+        if (value == 0xB6) bmp_reset(dev);
+    } else if (reg >= BMP_CTRL_MEAS && reg < BMP_PRESS_MSB) {
+        dev->regs[reg] = value;
+    }
+}
+
+struct sim_i2c_device *sim_bmp280_create(unsigned char address) {
+    struct sim_i2c_device *dev =
+        (struct sim_i2c_device *)calloc(1, sizeof(*dev));
+    if (!dev) return NULL;
+    dev->name = "bmp280";
+    dev->address = address;
+    dev->reg_write = bmp_write;
+    bmp_reset(dev);
+    return dev;
+}
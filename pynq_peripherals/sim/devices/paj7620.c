@@ -0,0 +1,90 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* PixArt PAJ7620U2 gesture sensor
+ *
+ * Register 0xEF selects between bank 0 (kept in regs) and bank 1. The
+ * gesture result registers 0x43/0x44 of bank 0 are cleared when read.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sim.h>
+
+#define REG_BANK_SEL    0xEF
+#define REG_GES_FLAG0   0x43
+#define REG_GES_FLAG1   0x44
+
+struct paj7620 {
+    struct sim_i2c_device dev;
+    unsigned char bank1[256];
+    unsigned char bank;
+};
+
+static void reg_write(struct sim_i2c_device *dev, unsigned char reg,
+                      unsigned char value) {
+    struct paj7620 *s = (struct paj7620 *)dev;
+    if (reg == REG_BANK_SEL) {
+        s->bank = value & 0x01;
+    } else if (s->bank) {
+        s->bank1[reg] = value;
+    } else if (reg > 0x01 && reg != REG_GES_FLAG0 && reg != REG_GES_FLAG1) {
+        dev->regs[reg] = value;
+    }
+}
+
+static unsigned char reg_read(struct sim_i2c_device *dev, unsigned char reg) {
+    struct paj7620 *s = (struct paj7620 *)dev;
+    if (reg == REG_BANK_SEL) return s->bank;
+    if (s->bank) return s->bank1[reg];
+    unsigned char value = dev->regs[reg];
+    if (reg == REG_GES_FLAG0 || reg == REG_GES_FLAG1) dev->regs[reg] = 0;
+    return value;
+}
+
+void sim_paj7620_set_gesture(struct sim_i2c_device *dev, unsigned char flag0,
+                             unsigned char flag1) {
+    dev->regs[REG_GES_FLAG0] = flag0;
+    dev->regs[REG_GES_FLAG1] = flag1;
+}
+
+struct sim_i2c_device *sim_paj7620_create(unsigned char address) {
+    struct paj7620 *s = (struct paj7620 *)calloc(1, sizeof(*s));
+    if (!s) return NULL;
+    s->dev.name = "paj7620";
+    s->dev.address = address;
+    s->dev.reg_write = reg_write;
+    s->dev.reg_read = reg_read;
+    s->dev.regs[0x00] = 0x20;
+    s->dev.regs[0x01] = 0x76;
+    return &s->dev;
+}
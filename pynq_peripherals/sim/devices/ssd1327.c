@@ -0,0 +1,90 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* Solomon SSD1327 OLED controller on I2C
+ *
+ * Each write starts with a control byte: Co (bit 7) set means a single
+ * byte follows before the next control byte, D/C# (bit 6) selects between
+ * the command stream and GDDRAM data.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sim.h>
+
+#define CONTROL_CO      0x80
+#define CONTROL_DC      0x40
+
+struct ssd1327 {
+    struct sim_i2c_device dev;
+    unsigned long commands;
+    unsigned long data;
+};
+
+static int transfer(struct sim_i2c_device *dev, int read,
+                    unsigned char *buffer, unsigned int length) {
+    struct ssd1327 *s = (struct ssd1327 *)dev;
+    if (read) {
+        memset(buffer, 0, length);
+        return 0;
+    }
+    unsigned int i = 0;
+    while (i < length) {
+        unsigned char control = buffer[i++];
+        unsigned int count = (control & CONTROL_CO) ?
+                             (i < length ? 1 : 0) : length - i;
+        if (control & CONTROL_DC) {
+            s->data += count;
+        } else {
+            s->commands += count;
+        }
+        i += count;
+    }
+    return 0;
+}
+
+unsigned long sim_ssd1327_commands(struct sim_i2c_device *dev) {
+    return ((struct ssd1327 *)dev)->commands;
+}
+
+unsigned long sim_ssd1327_data_bytes(struct sim_i2c_device *dev) {
+    return ((struct ssd1327 *)dev)->data;
+}
+
+struct sim_i2c_device *sim_ssd1327_create(unsigned char address) {
+    struct ssd1327 *s = (struct ssd1327 *)calloc(1, sizeof(*s));
+    if (!s) return NULL;
+    s->dev.name = "ssd1327";
+    s->dev.address = address;
+    s->dev.transfer = transfer;
+    return &s->dev;
+}
@@ -0,0 +1,61 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* Host stand-in for the PYNQ Microblaze gpio.h
+ *
+ * Every access goes through the simulated AXI GPIO data register and is
+ * charged as an AXI transaction.
+ */
+
+#pragma once
+
+#include <xil_types.h>
+#include <xparameters.h>
+
+#ifdef XPAR_XGPIO_NUM_INSTANCES
+typedef int gpio;
+
+#define GPIO_OUT 0
+#define GPIO_IN 1
+#define GPIO_INDEX_MIN 0
+#define GPIO_INDEX_MAX 31
+
+gpio gpio_open_device(unsigned int device);
+gpio gpio_open(unsigned int pin);
+gpio gpio_configure(gpio parent, unsigned int low, unsigned int hi,
+                    unsigned int channel);
+void gpio_set_direction(gpio device, unsigned int direction);
+int gpio_read(gpio device);
+void gpio_write(gpio device, unsigned int data);
+void gpio_close(gpio device);
+unsigned int gpio_get_num_devices(void);
+#endif
@@ -0,0 +1,190 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* Host simulation of the PYNQ IOP peripherals
+ *
+ * Drivers are compiled unchanged against the stand-in BSP headers in this
+ * directory. Bus and register accesses advance a simulated clock so that
+ * latency and throughput of driver calls can be measured on a plain Linux
+ * host before the code is run on an IOP.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// Simulation clock
+
+/* Cost of a single AXI-lite register access from the IOP (10 cycles) */
+#define SIM_AXI_ACCESS_NS       100
+
+/* Return the simulated time in nanoseconds since the last sim_reset */
+uint64_t sim_time_ns(void);
+
+/* Advance the simulated clock */
+void sim_advance_ns(uint64_t ns);
+
+/* Charge one AXI register access to the simulated clock */
+void sim_axi_access(void);
+
+/* Reset the clock, detach all I2C models and clear GPIO/XADC state */
+void sim_reset(void);
+
+// I2C buses
+
+enum SIM_I2C_BUS {
+    SIM_I2C_SHIELD,     /* dedicated controller, i2c_open_device(0) */
+    SIM_I2C_SWITCH,     /* IO switch controller, i2c_open(sda, scl) */
+    SIM_I2C_NUM_BUSES
+};
+
+/* Default SCL frequency of a simulated bus */
+#define SIM_I2C_DEFAULT_HZ      100000
+
+/* Software cost of one polled XIic_Send/XIic_Recv call, excluding bytes */
+#define SIM_I2C_CALL_AXI        20
+
+/* Software cost per byte moved through the XIic FIFO */
+#define SIM_I2C_BYTE_AXI        4
+
+struct sim_i2c_stats {
+    unsigned long transactions;     /* START ... STOP sequences */
+    unsigned long calls;            /* XIic_Send/XIic_Recv calls */
+    unsigned long bytes_written;
+    unsigned long bytes_read;
+    unsigned long naks;
+    uint64_t busy_ns;
+};
+
+/* A register-level model of an I2C target
+ *
+ * transfer is called once per bus phase (address byte plus data) and
+ * returns 0 if the target acknowledged or -1 for a NAK. When transfer is
+ * NULL the generic register file behaviour is used: the first written byte
+ * is the register pointer, further bytes are stored with auto-increment
+ * through reg_write and reads auto-increment through reg_read.
+ */
+struct sim_i2c_device {
+    const char *name;
+    unsigned char address;
+    unsigned char pointer;
+    unsigned char regs[256];
+    int (*transfer)(struct sim_i2c_device *dev, int read,
+                    unsigned char *buffer, unsigned int length);
+    int (*ack)(struct sim_i2c_device *dev);
+    void (*reg_write)(struct sim_i2c_device *dev, unsigned char reg,
+                      unsigned char value);
+    unsigned char (*reg_read)(struct sim_i2c_device *dev, unsigned char reg);
+    struct sim_i2c_device *next;
+};
+
+/* Attach a device model to a simulated bus */
+void sim_i2c_attach(int bus, struct sim_i2c_device *dev);
+
+/* Set the SCL frequency used to charge transfers on a bus */
+void sim_i2c_set_clock_hz(int bus, unsigned int hz);
+unsigned int sim_i2c_get_clock_hz(int bus);
+
+/* Read and clear the counters of a bus */
+struct sim_i2c_stats sim_i2c_get_stats(int bus);
+void sim_i2c_reset_stats(int bus);
+
+/* Generic register file transfer used when a model has no transfer hook */
+int sim_regdev_transfer(struct sim_i2c_device *dev, int read,
+                        unsigned char *buffer, unsigned int length);
+
+// GPIO
+
+struct sim_gpio_stats {
+    unsigned long reads;
+    unsigned long writes;
+};
+
+/* Drive the level seen by an IO switch pin configured as an input */
+void sim_gpio_set_input(unsigned int pin, unsigned int level);
+
+/* Most input changes that can be scheduled ahead of the clock */
+#define SIM_GPIO_SCHEDULE_DEPTH 256
+
+/* Change the level of an input pin once the clock reaches a given time
+ *
+ * Changes must be scheduled in time order. Returns -1 if the schedule is
+ * full.
+ */
+int sim_gpio_schedule_input(unsigned int pin, unsigned int level,
+                            uint64_t at_ns);
+
+/* Level currently driven by the IOP on a pin */
+unsigned int sim_gpio_get_output(unsigned int pin);
+
+struct sim_gpio_stats sim_gpio_get_stats(void);
+
+// PWM
+
+/* Period and pulse width in timer cycles currently generated on a pin, or
+ * 0 if no PWM is routed to it */
+unsigned int sim_pwm_get_period(unsigned int pin);
+unsigned int sim_pwm_get_pulse(unsigned int pin);
+
+// XADC
+
+/* Length of one System Monitor sequence over the enabled channels */
+#define SIM_XADC_SEQUENCE_NS    50000
+
+/* Set the raw 16-bit value returned for an auxiliary channel (0-15) */
+void sim_xadc_set_aux(unsigned int channel, unsigned int value);
+
+// Device models
+
+struct sim_i2c_device *sim_bme680_create(unsigned char address);
+struct sim_i2c_device *sim_dps310_create(unsigned char address);
+struct sim_i2c_device *sim_mpu9250_create(unsigned char address);
+struct sim_i2c_device *sim_ak8963_create(struct sim_i2c_device *mpu);
+struct sim_i2c_device *sim_bmp280_create(unsigned char address);
+struct sim_i2c_device *sim_apds9960_create(unsigned char address);
+struct sim_i2c_device *sim_paj7620_create(unsigned char address);
+struct sim_i2c_device *sim_ssd1327_create(unsigned char address);
+struct sim_i2c_device *sim_adc121_create(unsigned char address);
+
+/* Latch a gesture into the PAJ7620 result registers 0x43/0x44 */
+void sim_paj7620_set_gesture(struct sim_i2c_device *dev, unsigned char flag0,
+                             unsigned char flag1);
+
+/* Stretch each BME680 conversion by up to percent of its nominal time */
+void sim_bme680_set_jitter(struct sim_i2c_device *dev, unsigned int percent);
+
+/* Set the 12-bit conversion result of an ADC121 */
+void sim_adc121_set_raw(struct sim_i2c_device *dev, unsigned int raw);
+
+/* Number of command and GDDRAM data bytes received by an SSD1327 */
+unsigned long sim_ssd1327_commands(struct sim_i2c_device *dev);
+unsigned long sim_ssd1327_data_bytes(struct sim_i2c_device *dev);
@@ -0,0 +1,71 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* Host stand-in for the Xilinx XIic low-level (polled) driver
+ *
+ * Of the controller registers only the SCL timing registers are modelled:
+ * the bus clock used to charge transfers follows THIGH and TLOW.
+ */
+
+#pragma once
+
+#include <xil_types.h>
+
+#define XIIC_STOP               0x00
+#define XIIC_REPEATED_START     0x01
+
+#define XIIC_REG_OFFSET         0x100
+#define XIIC_TSUSTA_REG_OFFSET  (0x28 + XIIC_REG_OFFSET)
+#define XIIC_TSUSTO_REG_OFFSET  (0x2C + XIIC_REG_OFFSET)
+#define XIIC_THDSTA_REG_OFFSET  (0x30 + XIIC_REG_OFFSET)
+#define XIIC_TSUDAT_REG_OFFSET  (0x34 + XIIC_REG_OFFSET)
+#define XIIC_TBUF_REG_OFFSET    (0x38 + XIIC_REG_OFFSET)
+#define XIIC_THIGH_REG_OFFSET   (0x3C + XIIC_REG_OFFSET)
+#define XIIC_TLOW_REG_OFFSET    (0x40 + XIIC_REG_OFFSET)
+#define XIIC_THDDAT_REG_OFFSET  (0x44 + XIIC_REG_OFFSET)
+
+typedef struct {
+    u16 DeviceId;
+    UINTPTR BaseAddress;
+    int Has10BitAddr;
+    u8 GpOutWidth;
+} XIic_Config;
+
+extern XIic_Config XIic_ConfigTable[];
+
+u32 XIic_ReadReg(UINTPTR BaseAddress, u32 RegOffset);
+void XIic_WriteReg(UINTPTR BaseAddress, u32 RegOffset, u32 RegisterValue);
+
+unsigned XIic_Send(UINTPTR BaseAddress, u8 Address, u8 *BufferPtr,
+                   unsigned ByteCount, u8 Option);
+unsigned XIic_Recv(UINTPTR BaseAddress, u8 Address, u8 *BufferPtr,
+                   unsigned ByteCount, u8 Option);
@@ -0,0 +1,65 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* Host stand-in for the PYNQ Microblaze xio_switch.h */
+
+#pragma once
+
+#include <xil_types.h>
+
+enum {
+    GPIO = 0x00,
+    UART0_TX = 0x02,
+    UART0_RX = 0x03,
+    SPICLK0 = 0x04,
+    MISO0 = 0x05,
+    MOSI0 = 0x06,
+    SS0 = 0x07,
+    SDA0 = 0x0C,
+    SCL0 = 0x0D,
+    SDA1 = 0x0E,
+    SCL1 = 0x0F,
+    PWM0 = 0x10,
+    PWM1 = 0x11,
+    PWM2 = 0x12,
+    PWM3 = 0x13,
+    PWM4 = 0x14,
+    PWM5 = 0x15,
+    TIMER_G0 = 0x18,
+    TIMER_IC0 = 0x38,
+};
+
+#define IO_SWITCH_NUM_PINS 32
+
+void init_io_switch(void);
+void set_pin(int pin_number, u8 pin_type);
+u8 get_pin(int pin_number);
@@ -0,0 +1,75 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* Host stand-in for the generated xparameters.h of an Arduino-style IOP
+ *
+ * The simulated IOP has a dedicated shield I2C controller (device 0), an
+ * IO switch with its own I2C controller (device 1), a GPIO block, one AXI
+ * timer per PWM channel and the System Monitor. Build with -DSIM_TIMERS=1
+ * to model an IOP with a single timer, such as the PMOD IOP.
+ */
+
+#pragma once
+
+#define XPAR_XIIC_NUM_INSTANCES          2
+#define XPAR_IIC_0_DEVICE_ID             0
+#define XPAR_IIC_0_BASEADDR              0x40800000
+#define XPAR_IIC_1_DEVICE_ID             1
+#define XPAR_IIC_1_BASEADDR              0x40810000
+
+#define XPAR_IO_SWITCH_NUM_INSTANCES     1
+#define XPAR_IO_SWITCH_0_BASEADDR        0x44A00000
+#define XPAR_IO_SWITCH_0_I2C0_BASEADDR   XPAR_IIC_1_BASEADDR
+#define XPAR_IO_SWITCH_0_GPIO_BASEADDR   0x40000000
+
+#define XPAR_XGPIO_NUM_INSTANCES         1
+#define XPAR_GPIO_0_DEVICE_ID            0
+#define XPAR_GPIO_0_BASEADDR             0x40000000
+
+#ifndef SIM_TIMERS
+#define SIM_TIMERS                       6
+#endif
+#define XPAR_XTMRCTR_NUM_INSTANCES       SIM_TIMERS
+#define XPAR_TMRCTR_0_DEVICE_ID          0
+#define XPAR_TMRCTR_0_BASEADDR           0x41C00000
+#define XPAR_TMRCTR_1_BASEADDR           0x41C10000
+#define XPAR_TMRCTR_2_BASEADDR           0x41C20000
+#define XPAR_TMRCTR_3_BASEADDR           0x41C30000
+#define XPAR_TMRCTR_4_BASEADDR           0x41C40000
+#define XPAR_TMRCTR_5_BASEADDR           0x41C50000
+#define XPAR_TMRCTR_0_CLOCK_FREQ_HZ      100000000
+
+#define XPAR_XSYSMON_NUM_INSTANCES       1
+#define XPAR_SYSMON_0_DEVICE_ID          0
+#define XPAR_SYSMON_0_BASEADDR           0x44A10000
+
+#define XPAR_CPU_CORE_CLOCK_FREQ_HZ      100000000
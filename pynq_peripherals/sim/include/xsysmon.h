@@ -0,0 +1,82 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* Host stand-in for the Xilinx xsysmon.h
+ *
+ * The sequencer runs continuously; the end-of-sequence flag latches once
+ * per simulated sequence period and is cleared when the status is read.
+ * Averaging stretches the sequence period by the number of samples.
+ */
+
+#pragma once
+
+#include <xil_types.h>
+
+#define XSM_SR_EOS_MASK         0x00000010
+#define XSM_SR_EOC_MASK         0x00000020
+#define XSM_CH_AUX_MIN          16
+#define XSM_CH_AUX_MAX          31
+
+#define XSM_SEQ_MODE_SAFE       0
+#define XSM_SEQ_MODE_ONEPASS    1
+#define XSM_SEQ_MODE_CONTINPASS 2
+
+#define XSM_SEQ_CH_AUX00        0x00010000
+
+#define XSM_AVG_0_SAMPLES       0
+#define XSM_AVG_16_SAMPLES      1
+#define XSM_AVG_64_SAMPLES      2
+#define XSM_AVG_256_SAMPLES     3
+
+typedef struct {
+    u16 DeviceId;
+    UINTPTR BaseAddress;
+} XSysMon_Config;
+
+typedef struct {
+    XSysMon_Config Config;
+    u32 IsReady;
+} XSysMon;
+
+XSysMon_Config *XSysMon_LookupConfig(u16 DeviceId);
+int XSysMon_CfgInitialize(XSysMon *InstancePtr, XSysMon_Config *ConfigPtr,
+                          UINTPTR EffectiveAddr);
+u32 XSysMon_GetStatus(XSysMon *InstancePtr);
+u16 XSysMon_GetAdcData(XSysMon *InstancePtr, u8 Channel);
+void XSysMon_SetSequencerMode(XSysMon *InstancePtr, u8 SequencerMode);
+u8 XSysMon_GetSequencerMode(XSysMon *InstancePtr);
+int XSysMon_SetSeqChEnables(XSysMon *InstancePtr, u32 ChEnableMask);
+u32 XSysMon_GetSeqChEnables(XSysMon *InstancePtr);
+void XSysMon_SetAvg(XSysMon *InstancePtr, u8 Average);
+u8 XSysMon_GetAvg(XSysMon *InstancePtr);
+int XSysMon_SetSeqAvgEnables(XSysMon *InstancePtr, u32 AvgEnableChMask);
+u32 XSysMon_GetSeqAvgEnables(XSysMon *InstancePtr);
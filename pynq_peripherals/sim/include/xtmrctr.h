@@ -0,0 +1,57 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* Host stand-in for the Xilinx xtmrctr.h low-level register accessors
+ *
+ * The counters run off the simulated clock at XPAR_TMRCTR_0_CLOCK_FREQ_HZ.
+ */
+
+#pragma once
+
+#include <xil_types.h>
+
+#define XTC_CSR_CASC_MASK               0x00000800
+#define XTC_CSR_ENABLE_ALL_MASK         0x00000400
+#define XTC_CSR_ENABLE_PWM_MASK         0x00000200
+#define XTC_CSR_INT_OCCURED_MASK        0x00000100
+#define XTC_CSR_ENABLE_TMR_MASK         0x00000080
+#define XTC_CSR_ENABLE_INT_MASK         0x00000040
+#define XTC_CSR_LOAD_MASK               0x00000020
+#define XTC_CSR_AUTO_RELOAD_MASK        0x00000010
+#define XTC_CSR_EXT_CAPTURE_MASK        0x00000008
+#define XTC_CSR_EXT_GENERATE_MASK       0x00000004
+#define XTC_CSR_DOWN_COUNT_MASK         0x00000002
+#define XTC_CSR_CAPTURE_MODE_MASK       0x00000001
+
+u32 XTmrCtr_ReadReg(UINTPTR BaseAddress, u8 TmrCtrNumber, u32 RegOffset);
+void XTmrCtr_WriteReg(UINTPTR BaseAddress, u8 TmrCtrNumber, u32 RegOffset,
+                      u32 Value);
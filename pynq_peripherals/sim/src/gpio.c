@@ -0,0 +1,187 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* GPIO API of the PYNQ BSP on top of a simulated AXI GPIO bank
+ *
+ * Handles encode the device, the pin range and the channel in the same way
+ * as the BSP so that drivers may keep using them as opaque integers.
+ */
+
+#include <string.h>
+#include <xparameters.h>
+#include <xgpio.h>
+#include <xio_switch.h>
+#include <gpio.h>
+#include "sim_internal.h"
+
+#define DEVICE(g)  ((g) & 0xFF)
+#define LOW(g)     (((g) >> 8) & 0xFF)
+#define HIGH(g)    (((g) >> 16) & 0xFF)
+#define CHANNEL(g) (((g) >> 24) & 0xFF)
+
+static u32 data_out;
+static u32 tri = 0xFFFFFFFF;
+static u32 data_in;
+static struct sim_gpio_stats stats;
+
+static struct {
+    uint64_t at_ns;
+    unsigned char pin;
+    unsigned char level;
+} schedule[SIM_GPIO_SCHEDULE_DEPTH];
+static unsigned int schedule_head, schedule_count;
+
+void sim_gpio_reset(void) {
+    data_out = 0;
+    tri = 0xFFFFFFFF;
+    data_in = 0;
+    schedule_head = schedule_count = 0;
+    memset(&stats, 0, sizeof(stats));
+}
+
+int sim_gpio_schedule_input(unsigned int pin, unsigned int level,
+                            uint64_t at_ns) {
+    if (pin > GPIO_INDEX_MAX || schedule_count == SIM_GPIO_SCHEDULE_DEPTH)
+        return -1;
+    unsigned int tail = (schedule_head + schedule_count++) %
+        SIM_GPIO_SCHEDULE_DEPTH;
+    schedule[tail].at_ns = at_ns;
+    schedule[tail].pin = pin;
+    schedule[tail].level = level;
+    return 0;
+}
+
+/* Apply the scheduled input changes that are due */
+static void apply_schedule(void) {
+    uint64_t now = sim_time_ns();
+    while (schedule_count && schedule[schedule_head].at_ns <= now) {
+        sim_gpio_set_input(schedule[schedule_head].pin,
+                           schedule[schedule_head].level);
+        schedule_head = (schedule_head + 1) % SIM_GPIO_SCHEDULE_DEPTH;
+        schedule_count--;
+    }
+}
+
+void sim_gpio_set_input(unsigned int pin, unsigned int level) {
+    if (pin > GPIO_INDEX_MAX) return;
+    data_in = (data_in & ~(1u << pin)) | ((level ? 1u : 0u) << pin);
+}
+
+unsigned int sim_gpio_get_output(unsigned int pin) {
+    if (pin > GPIO_INDEX_MAX) return 0;
+    return (data_out >> pin) & 1;
+}
+
+struct sim_gpio_stats sim_gpio_get_stats(void) {
+    return stats;
+}
+
+u32 XGpio_ReadReg(UINTPTR BaseAddress, u32 RegOffset) {
+    (void)BaseAddress;
+    sim_axi_access();
+    stats.reads++;
+    switch (RegOffset) {
+    case XGPIO_DATA_OFFSET:
+        apply_schedule();
+        return (data_out & ~tri) | (data_in & tri);
+    case XGPIO_TRI_OFFSET:
+        return tri;
+    default:
+        return 0;
+    }
+}
+
+void XGpio_WriteReg(UINTPTR BaseAddress, u32 RegOffset, u32 Data) {
+    (void)BaseAddress;
+    sim_axi_access();
+    stats.writes++;
+    switch (RegOffset) {
+    case XGPIO_DATA_OFFSET:
+        data_out = Data;
+        break;
+    case XGPIO_TRI_OFFSET:
+        tri = Data;
+        break;
+    default:
+        break;
+    }
+}
+
+gpio gpio_open_device(unsigned int device) {
+    if (device >= XPAR_XGPIO_NUM_INSTANCES) return -1;
+    return gpio_configure(device, GPIO_INDEX_MIN, GPIO_INDEX_MAX, 1);
+}
+
+gpio gpio_open(unsigned int pin) {
+    if (pin > GPIO_INDEX_MAX) return -1;
+    set_pin(pin, GPIO);
+    return gpio_configure(gpio_open_device(0), pin, pin, 1);
+}
+
+gpio gpio_configure(gpio parent, unsigned int low, unsigned int hi,
+                    unsigned int channel) {
+    if (parent < 0 || low > hi || hi > GPIO_INDEX_MAX) return -1;
+    return DEVICE(parent) | (low << 8) | (hi << 16) | (channel << 24);
+}
+
+static u32 pin_mask(gpio device) {
+    unsigned int width = HIGH(device) - LOW(device) + 1;
+    u32 mask = width >= 32 ? 0xFFFFFFFF : ((1u << width) - 1);
+    return mask << LOW(device);
+}
+
+void gpio_set_direction(gpio device, unsigned int direction) {
+    u32 mask = pin_mask(device);
+    u32 value = XGpio_ReadReg(XPAR_GPIO_0_BASEADDR, XGPIO_TRI_OFFSET);
+    value = direction == GPIO_IN ? (value | mask) : (value & ~mask);
+    XGpio_WriteReg(XPAR_GPIO_0_BASEADDR, XGPIO_TRI_OFFSET, value);
+}
+
+int gpio_read(gpio device) {
+    u32 value = XGpio_ReadReg(XPAR_GPIO_0_BASEADDR, XGPIO_DATA_OFFSET);
+    return (value & pin_mask(device)) >> LOW(device);
+}
+
+void gpio_write(gpio device, unsigned int data) {
+    u32 mask = pin_mask(device);
+    u32 value = XGpio_ReadReg(XPAR_GPIO_0_BASEADDR, XGPIO_DATA_OFFSET);
+    value = (value & ~mask) | ((data << LOW(device)) & mask);
+    XGpio_WriteReg(XPAR_GPIO_0_BASEADDR, XGPIO_DATA_OFFSET, value);
+}
+
+void gpio_close(gpio device) {
+    (void)device;
+}
+
+unsigned int gpio_get_num_devices(void) {
+    return XPAR_XGPIO_NUM_INSTANCES;
+}
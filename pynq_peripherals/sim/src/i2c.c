@@ -0,0 +1,75 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* I2C API of the PYNQ BSP on top of the simulated XIic controllers */
+
+#include <xparameters.h>
+#include <xiic_l.h>
+#include <xio_switch.h>
+#include <i2c.h>
+
+i2c i2c_open_device(unsigned int device) {
+    if (device >= XPAR_XIIC_NUM_INSTANCES) return -1;
+    return device;
+}
+
+i2c i2c_open(unsigned int sda, unsigned int scl) {
+    for (unsigned int i = 0; i < XPAR_XIIC_NUM_INSTANCES; i++) {
+        if (XIic_ConfigTable[i].BaseAddress ==
+                XPAR_IO_SWITCH_0_I2C0_BASEADDR) {
+            set_pin(scl, SCL0);
+            set_pin(sda, SDA0);
+            return i2c_open_device(i);
+        }
+    }
+    return -1;
+}
+
+unsigned int i2c_read(i2c dev_id, unsigned int slave_address,
+                      unsigned char* buffer, unsigned int length) {
+    return XIic_Recv(XIic_ConfigTable[dev_id].BaseAddress, slave_address,
+                     buffer, length, XIIC_STOP);
+}
+
+unsigned int i2c_write(i2c dev_id, unsigned int slave_address,
+                       unsigned char* buffer, unsigned int length) {
+    return XIic_Send(XIic_ConfigTable[dev_id].BaseAddress, slave_address,
+                     buffer, length, XIIC_STOP);
+}
+
+void i2c_close(i2c dev_id) {
+    (void)dev_id;
+}
+
+unsigned int i2c_get_num_devices(void) {
+    return XPAR_XIIC_NUM_INSTANCES;
+}
@@ -0,0 +1,215 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+#include <string.h>
+#include <xparameters.h>
+#include <xiic.h>
+#include "sim_internal.h"
+
+XIic_Config XIic_ConfigTable[XPAR_XIIC_NUM_INSTANCES] = {
+    {XPAR_IIC_0_DEVICE_ID, XPAR_IIC_0_BASEADDR, 0, 0},
+    {XPAR_IIC_1_DEVICE_ID, XPAR_IIC_1_BASEADDR, 0, 0},
+};
+
+/* Number of modelled timing registers, TSUSTA to THDDAT */
+#define SIM_I2C_TIMING_REGS 8
+
+struct sim_i2c_bus {
+    struct sim_i2c_device *devices;
+    unsigned int clock_hz;
+    u32 timing[SIM_I2C_TIMING_REGS];
+    int held;
+    struct sim_i2c_stats stats;
+};
+
+static struct sim_i2c_bus buses[SIM_I2C_NUM_BUSES];
+
+void sim_i2c_reset(void) {
+    for (int i = 0; i < SIM_I2C_NUM_BUSES; i++) {
+        memset(&buses[i], 0, sizeof(buses[i]));
+        buses[i].clock_hz = SIM_I2C_DEFAULT_HZ;
+    }
+}
+
+void sim_i2c_attach(int bus, struct sim_i2c_device *dev) {
+    if (bus < 0 || bus >= SIM_I2C_NUM_BUSES || !dev) return;
+    dev->next = buses[bus].devices;
+    buses[bus].devices = dev;
+}
+
+void sim_i2c_set_clock_hz(int bus, unsigned int hz) {
+    if (bus < 0 || bus >= SIM_I2C_NUM_BUSES || hz == 0) return;
+    buses[bus].clock_hz = hz;
+}
+
+unsigned int sim_i2c_get_clock_hz(int bus) {
+    if (bus < 0 || bus >= SIM_I2C_NUM_BUSES) return 0;
+    return buses[bus].clock_hz;
+}
+
+struct sim_i2c_stats sim_i2c_get_stats(int bus) {
+    struct sim_i2c_stats empty = {0, 0, 0, 0, 0, 0};
+    if (bus < 0 || bus >= SIM_I2C_NUM_BUSES) return empty;
+    return buses[bus].stats;
+}
+
+void sim_i2c_reset_stats(int bus) {
+    if (bus < 0 || bus >= SIM_I2C_NUM_BUSES) return;
+    memset(&buses[bus].stats, 0, sizeof(buses[bus].stats));
+}
+
+int sim_regdev_transfer(struct sim_i2c_device *dev, int read,
+                        unsigned char *buffer, unsigned int length) {
+    unsigned int i = 0;
+    if (!read) {
+        if (length == 0) return 0;
+        dev->pointer = buffer[i++];
+        for (; i < length; i++) {
+            if (dev->reg_write) {
+                dev->reg_write(dev, dev->pointer, buffer[i]);
+            } else {
+                dev->regs[dev->pointer] = buffer[i];
+            }
+            dev->pointer++;
+        }
+    } else {
+        for (; i < length; i++) {
+            buffer[i] = dev->reg_read ? dev->reg_read(dev, dev->pointer) :
+                                        dev->regs[dev->pointer];
+            dev->pointer++;
+        }
+    }
+    return 0;
+}
+
+XIic_Config *XIic_LookupConfig(u16 DeviceId) {
+    for (int i = 0; i < XPAR_XIIC_NUM_INSTANCES; i++) {
+        if (XIic_ConfigTable[i].DeviceId == DeviceId) {
+            return &XIic_ConfigTable[i];
+        }
+    }
+    return NULL;
+}
+
+static struct sim_i2c_bus *bus_from_base(UINTPTR base) {
+    for (int i = 0; i < XPAR_XIIC_NUM_INSTANCES; i++) {
+        if (XIic_ConfigTable[i].BaseAddress == base) return &buses[i];
+    }
+    return NULL;
+}
+
+static u32 *timing_reg(struct sim_i2c_bus *bus, u32 offset) {
+    if (!bus || offset < XIIC_TSUSTA_REG_OFFSET ||
+            offset > XIIC_THDDAT_REG_OFFSET || (offset & 3)) return NULL;
+    return &bus->timing[(offset - XIIC_TSUSTA_REG_OFFSET) / 4];
+}
+
+u32 XIic_ReadReg(UINTPTR BaseAddress, u32 RegOffset) {
+    u32 *reg = timing_reg(bus_from_base(BaseAddress), RegOffset);
+    sim_axi_access();
+    return reg ? *reg : 0;
+}
+
+/* SCL runs for THIGH + 7 and TLOW + 1 AXI clock cycles per period */
+void XIic_WriteReg(UINTPTR BaseAddress, u32 RegOffset, u32 RegisterValue) {
+    struct sim_i2c_bus *bus = bus_from_base(BaseAddress);
+    u32 *reg = timing_reg(bus, RegOffset);
+    sim_axi_access();
+    if (!reg) return;
+    *reg = RegisterValue;
+    u32 high = bus->timing[(XIIC_THIGH_REG_OFFSET - XIIC_TSUSTA_REG_OFFSET) / 4];
+    u32 low = bus->timing[(XIIC_TLOW_REG_OFFSET - XIIC_TSUSTA_REG_OFFSET) / 4];
+    if (high && low) {
+        bus->clock_hz = XPAR_CPU_CORE_CLOCK_FREQ_HZ / (high + 7 + low + 1);
+    }
+}
+
+static void charge_bits(struct sim_i2c_bus *bus, unsigned int bits) {
+    uint64_t ns = (uint64_t)bits * 1000000000ull / bus->clock_hz;
+    bus->stats.busy_ns += ns;
+    sim_advance_ns(ns);
+}
+
+/* One bus phase: (repeated) START, address byte and data bytes. The bus is
+ * only released with a STOP when requested or when the target NAKs.
+ */
+static unsigned transfer(UINTPTR base, u8 address, u8 *buffer,
+                         unsigned length, u8 option, int read) {
+    struct sim_i2c_bus *bus = bus_from_base(base);
+    if (!bus) return 0;
+    struct sim_i2c_device *dev = bus->devices;
+    while (dev && dev->address != address) dev = dev->next;
+    if (dev && dev->ack && dev->ack(dev) != 0) dev = NULL;
+
+    for (unsigned int i = 0; i < SIM_I2C_CALL_AXI; i++) sim_axi_access();
+    bus->stats.calls++;
+    if (!bus->held) bus->stats.transactions++;
+    charge_bits(bus, 1 + 9);
+
+    int status = -1;
+    if (dev) {
+        status = dev->transfer ? dev->transfer(dev, read, buffer, length) :
+                                 sim_regdev_transfer(dev, read, buffer, length);
+    }
+    if (status != 0) {
+        bus->stats.naks++;
+        charge_bits(bus, 1);
+        bus->held = 0;
+        return 0;
+    }
+    for (unsigned int i = 0; i < length * SIM_I2C_BYTE_AXI; i++) {
+        sim_axi_access();
+    }
+    charge_bits(bus, 9 * length);
+    if (read) {
+        bus->stats.bytes_read += length;
+    } else {
+        bus->stats.bytes_written += length;
+    }
+    if (option == XIIC_REPEATED_START) {
+        bus->held = 1;
+    } else {
+        charge_bits(bus, 1);
+        bus->held = 0;
+    }
+    return length;
+}
+
+unsigned XIic_Send(UINTPTR BaseAddress, u8 Address, u8 *BufferPtr,
+                   unsigned ByteCount, u8 Option) {
+    return transfer(BaseAddress, Address, BufferPtr, ByteCount, Option, 0);
+}
+
+unsigned XIic_Recv(UINTPTR BaseAddress, u8 Address, u8 *BufferPtr,
+                   unsigned ByteCount, u8 Option) {
+    return transfer(BaseAddress, Address, BufferPtr, ByteCount, Option, 1);
+}
@@ -0,0 +1,247 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* Timer API of the PYNQ BSP and the XTmrCtr register interface
+ *
+ * Counters are derived from the simulated clock so that drivers polling a
+ * free-running counter observe time passing as they poll.
+ */
+
+#include <string.h>
+#include <xparameters.h>
+#include <xtmrctr.h>
+#include <xio_switch.h>
+#include <timer.h>
+#include "sim_internal.h"
+
+#define CYCLE_NS (1000000000u / XPAR_TMRCTR_0_CLOCK_FREQ_HZ)
+
+struct sim_counter {
+    u32 csr;
+    u32 load;
+    u32 value;
+    uint64_t since_ns;
+};
+
+struct sim_timer {
+    struct sim_counter counter[2];
+    unsigned int period;
+    unsigned int pulse;
+};
+
+static struct sim_timer timers[XPAR_XTMRCTR_NUM_INSTANCES];
+
+/* Driver state survives a reset of the simulation, so counters that were
+ * started keep running from zero at the new time origin */
+void sim_timer_reset(void) {
+    for (int i = 0; i < XPAR_XTMRCTR_NUM_INSTANCES; i++) {
+        for (int j = 0; j < 2; j++) {
+            struct sim_counter *c = &timers[i].counter[j];
+            u32 csr = c->csr & XTC_CSR_ENABLE_TMR_MASK ? c->csr : 0;
+            u32 load = csr ? c->load : 0;
+            memset(c, 0, sizeof(*c));
+            c->csr = csr;
+            c->load = load;
+            c->value = load;
+        }
+        if (!(timers[i].counter[0].csr & XTC_CSR_ENABLE_PWM_MASK)) {
+            timers[i].period = 0;
+            timers[i].pulse = 0;
+        }
+    }
+}
+
+static struct sim_timer *timer_at(UINTPTR base) {
+    unsigned int index = (base - XPAR_TMRCTR_0_BASEADDR) / 0x10000;
+    if (base < XPAR_TMRCTR_0_BASEADDR || index >= XPAR_XTMRCTR_NUM_INSTANCES)
+        return NULL;
+    return &timers[index];
+}
+
+static struct sim_counter *counter_at(UINTPTR base, u8 number) {
+    struct sim_timer *t = timer_at(base);
+    if (!t || number > 1) return NULL;
+    return &t->counter[number];
+}
+
+static u32 counter_value(struct sim_counter *c) {
+    if (!(c->csr & XTC_CSR_ENABLE_TMR_MASK)) return c->value;
+    uint64_t elapsed = (sim_time_ns() - c->since_ns) / CYCLE_NS;
+    if ((c->csr & XTC_CSR_AUTO_RELOAD_MASK) &&
+        (c->csr & XTC_CSR_DOWN_COUNT_MASK)) {
+        // Counts down to zero and takes two cycles to reload from TLR
+        uint64_t period = (uint64_t)c->load + 2;
+        return c->load - (u32)((c->load - c->value + elapsed) % period);
+    }
+    u32 ticks = (u32)elapsed;
+    return (c->csr & XTC_CSR_DOWN_COUNT_MASK) ? c->value - ticks :
+                                                c->value + ticks;
+}
+
+/* In cascade mode counter 0 holds the low and counter 1 the high half of
+ * one 64-bit up-counter, run by the control bits of counter 0. While the
+ * LOAD bit of counter 1 is set, the high half keeps reloading from TLR1. */
+static uint64_t cascade_value(struct sim_timer *t) {
+    struct sim_counter *low = &t->counter[0];
+    struct sim_counter *high = &t->counter[1];
+    uint64_t value = ((uint64_t)high->value << 32) | low->value;
+    if (low->csr & XTC_CSR_ENABLE_TMR_MASK)
+        value += (sim_time_ns() - low->since_ns) / CYCLE_NS;
+    if (high->csr & XTC_CSR_LOAD_MASK)
+        value = ((uint64_t)high->load << 32) | (u32)value;
+    return value;
+}
+
+u32 XTmrCtr_ReadReg(UINTPTR BaseAddress, u8 TmrCtrNumber, u32 RegOffset) {
+    struct sim_timer *t = timer_at(BaseAddress);
+    struct sim_counter *c = counter_at(BaseAddress, TmrCtrNumber);
+    sim_axi_access();
+    if (!c) return 0;
+    switch (RegOffset) {
+    case TCSR0:
+        return c->csr;
+    case TLR0:
+        return c->load;
+    case TCR0:
+        if (t->counter[0].csr & XTC_CSR_CASC_MASK) {
+            uint64_t value = cascade_value(t);
+            return TmrCtrNumber ? (u32)(value >> 32) : (u32)value;
+        }
+        return counter_value(c);
+    default:
+        return 0;
+    }
+}
+
+void XTmrCtr_WriteReg(UINTPTR BaseAddress, u8 TmrCtrNumber, u32 RegOffset,
+                      u32 Value) {
+    struct sim_timer *t = timer_at(BaseAddress);
+    struct sim_counter *c = counter_at(BaseAddress, TmrCtrNumber);
+    sim_axi_access();
+    if (!c) return;
+    switch (RegOffset) {
+    case TCSR0:
+        if (Value & XTC_CSR_LOAD_MASK) {
+            c->value = c->load;
+        } else if (!TmrCtrNumber && (c->csr & XTC_CSR_CASC_MASK)) {
+            // Split the 64-bit count back into both halves
+            uint64_t value = cascade_value(t);
+            t->counter[1].value = (u32)(value >> 32);
+            c->value = (u32)value;
+        } else {
+            c->value = counter_value(c);
+        }
+        c->since_ns = sim_time_ns();
+        c->csr = Value & ~XTC_CSR_INT_OCCURED_MASK;
+        break;
+    case TLR0:
+        c->load = Value;
+        break;
+    default:
+        break;
+    }
+}
+
+timer timer_open_device(unsigned int device) {
+    if (device >= XPAR_XTMRCTR_NUM_INSTANCES) return -1;
+    return device;
+}
+
+timer timer_open(unsigned int pin) {
+    set_pin(pin, PWM0);
+    return timer_open_device(0);
+}
+
+void timer_delay(timer dev_id, unsigned int cycles) {
+    (void)dev_id;
+    sim_advance_ns((uint64_t)cycles * CYCLE_NS);
+}
+
+/* PWM is programmed as the BSP does: counter 0 counts the period and
+ * counter 1 the pulse down from their load registers, reloading on zero */
+void timer_pwm_generate(timer dev_id, unsigned int period,
+                        unsigned int pulse) {
+    if (dev_id < 0 || dev_id >= XPAR_XTMRCTR_NUM_INSTANCES) return;
+    UINTPTR base = XPAR_TMRCTR_0_BASEADDR + dev_id * 0x10000;
+    const u32 csr = XTC_CSR_ENABLE_PWM_MASK | XTC_CSR_ENABLE_TMR_MASK |
+                    XTC_CSR_AUTO_RELOAD_MASK | XTC_CSR_EXT_GENERATE_MASK |
+                    XTC_CSR_DOWN_COUNT_MASK;
+    XTmrCtr_WriteReg(base, 0, TLR0, period);
+    XTmrCtr_WriteReg(base, 1, TLR0, pulse);
+    XTmrCtr_WriteReg(base, 0, TCSR0, XTC_CSR_LOAD_MASK);
+    XTmrCtr_WriteReg(base, 1, TCSR0, XTC_CSR_LOAD_MASK);
+    XTmrCtr_WriteReg(base, 0, TCSR0, csr);
+    XTmrCtr_WriteReg(base, 1, TCSR0, csr);
+    timers[dev_id].period = period;
+    timers[dev_id].pulse = pulse;
+}
+
+void timer_pwm_stop(timer dev_id) {
+    if (dev_id < 0 || dev_id >= XPAR_XTMRCTR_NUM_INSTANCES) return;
+    UINTPTR base = XPAR_TMRCTR_0_BASEADDR + dev_id * 0x10000;
+    XTmrCtr_WriteReg(base, 0, TCSR0, 0);
+    XTmrCtr_WriteReg(base, 1, TCSR0, 0);
+    timers[dev_id].period = 0;
+    timers[dev_id].pulse = 0;
+}
+
+void timer_close(timer dev_id) {
+    timer_pwm_stop(dev_id);
+}
+
+unsigned int timer_get_num_devices(void) {
+    return XPAR_XTMRCTR_NUM_INSTANCES;
+}
+
+static struct sim_timer *timer_on_pin(unsigned int pin) {
+    u8 type = get_pin(pin);
+    if (type < PWM0 || type > PWM5) return NULL;
+    return &timers[type - PWM0];
+}
+
+unsigned int sim_pwm_get_period(unsigned int pin) {
+    struct sim_timer *t = timer_on_pin(pin);
+    return t ? t->period : 0;
+}
+
+unsigned int sim_pwm_get_pulse(unsigned int pin) {
+    struct sim_timer *t = timer_on_pin(pin);
+    return t ? t->pulse : 0;
+}
+
+void delay_us(unsigned int us) {
+    sim_advance_ns((uint64_t)us * 1000);
+}
+
+void delay_ms(unsigned int ms) {
+    sim_advance_ns((uint64_t)ms * 1000000);
+}
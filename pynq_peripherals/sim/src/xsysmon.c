@@ -0,0 +1,162 @@
+/******************************************************************************
+ *  Copyright (c) 2021, Xilinx, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1.  Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2.  Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *
+ *  3.  Neither the name of the copyright holder nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ *  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+
+/* System Monitor (XADC) running a continuous sequence over the auxiliary
+ * channels. EOS is latched at the end of every sequence and cleared when
+ * the status register is read.
+ */
+
+#include <string.h>
+#include <xparameters.h>
+#include <xsysmon.h>
+#include "sim_internal.h"
+
+static XSysMon_Config config = {XPAR_SYSMON_0_DEVICE_ID,
+                                XPAR_SYSMON_0_BASEADDR};
+static u16 aux[16];
+static uint64_t last_sequence;
+static u8 sequencer_mode;
+static u32 channel_enables;
+static u8 average;
+static u32 average_enables;
+
+/* Out of reset the sequence converts every auxiliary channel */
+void sim_xadc_reset(void) {
+    memset(aux, 0, sizeof(aux));
+    last_sequence = 0;
+    sequencer_mode = XSM_SEQ_MODE_CONTINPASS;
+    channel_enables = 0xFFFF0000;
+    average = XSM_AVG_0_SAMPLES;
+    average_enables = 0;
+}
+
+/* Length of one pass of the sequencer, longer while channels average */
+static uint64_t sequence_ns(void) {
+    static const unsigned int samples[] = {1, 16, 64, 256};
+    if (!average_enables) return SIM_XADC_SEQUENCE_NS;
+    return (uint64_t)SIM_XADC_SEQUENCE_NS * samples[average & 3];
+}
+
+void sim_xadc_set_aux(unsigned int channel, unsigned int value) {
+    if (channel < 16) aux[channel] = value;
+}
+
+XSysMon_Config *XSysMon_LookupConfig(u16 DeviceId) {
+    return DeviceId == XPAR_SYSMON_0_DEVICE_ID ? &config : NULL;
+}
+
+int XSysMon_CfgInitialize(XSysMon *InstancePtr, XSysMon_Config *ConfigPtr,
+                          UINTPTR EffectiveAddr) {
+    if (!InstancePtr || !ConfigPtr) return XST_FAILURE;
+    InstancePtr->Config = *ConfigPtr;
+    InstancePtr->Config.BaseAddress = EffectiveAddr;
+    InstancePtr->IsReady = XIL_COMPONENT_IS_READY;
+    sim_axi_access();
+    return XST_SUCCESS;
+}
+
+u32 XSysMon_GetStatus(XSysMon *InstancePtr) {
+    (void)InstancePtr;
+    sim_axi_access();
+    uint64_t sequence = sim_time_ns() / sequence_ns();
+    if (sequence != last_sequence) {
+        last_sequence = sequence;
+        return XSM_SR_EOS_MASK | XSM_SR_EOC_MASK;
+    }
+    return 0;
+}
+
+u16 XSysMon_GetAdcData(XSysMon *InstancePtr, u8 Channel) {
+    (void)InstancePtr;
+    sim_axi_access();
+    if (Channel < XSM_CH_AUX_MIN || Channel > XSM_CH_AUX_MAX) return 0;
+    if (!(channel_enables & (1u << Channel))) return 0;
+    return aux[Channel - XSM_CH_AUX_MIN];
+}
+
+void XSysMon_SetSequencerMode(XSysMon *InstancePtr, u8 SequencerMode) {
+    (void)InstancePtr;
+    sim_axi_access();
+    sim_axi_access();
+    sequencer_mode = SequencerMode;
+}
+
+u8 XSysMon_GetSequencerMode(XSysMon *InstancePtr) {
+    (void)InstancePtr;
+    sim_axi_access();
+    return sequencer_mode;
+}
+
+int XSysMon_SetSeqChEnables(XSysMon *InstancePtr, u32 ChEnableMask) {
+    (void)InstancePtr;
+    if (sequencer_mode != XSM_SEQ_MODE_SAFE) return XST_FAILURE;
+    sim_axi_access();
+    sim_axi_access();
+    channel_enables = ChEnableMask;
+    return XST_SUCCESS;
+}
+
+u32 XSysMon_GetSeqChEnables(XSysMon *InstancePtr) {
+    (void)InstancePtr;
+    sim_axi_access();
+    sim_axi_access();
+    return channel_enables;
+}
+
+void XSysMon_SetAvg(XSysMon *InstancePtr, u8 Average) {
+    (void)InstancePtr;
+    sim_axi_access();
+    sim_axi_access();
+    average = Average;
+}
+
+u8 XSysMon_GetAvg(XSysMon *InstancePtr) {
+    (void)InstancePtr;
+    sim_axi_access();
+    return average;
+}
+
+int XSysMon_SetSeqAvgEnables(XSysMon *InstancePtr, u32 AvgEnableChMask) {
+    (void)InstancePtr;
+    if (sequencer_mode != XSM_SEQ_MODE_SAFE) return XST_FAILURE;
+    sim_axi_access();
+    sim_axi_access();
+    average_enables = AvgEnableChMask;
+    return XST_SUCCESS;
+}
+
+u32 XSysMon_GetSeqAvgEnables(XSysMon *InstancePtr) {
+    (void)InstancePtr;
+    sim_axi_access();
+    sim_axi_access();
+    return average_enables;
+}
@@ -57,26 +57,27 @@ void {{ peripheral_name }}_example({{ peripheral_name }} p{{example_args}});
 """
 
 GROVE_SOURCE = r"""#include <grove_interfaces.h>
+#include <grove_pool.h>
 #include <{{ peripheral_name }}.h>
 
 {% if i2c_default_address -%}
 #define I2C_ADDRESS {{i2c_default_address}}
 {% endif -%}
 {% if has_data_struct -%}
-#define DEVICE_MAX 4
+#ifndef {{ peripheral_name.upper() }}_INSTANCES
+#define {{ peripheral_name.upper() }}_INSTANCES 4
+#endif
 
 struct {{peripheral_name}}_info {
 {{ data_contents }}
     int count;
 };
 
-static struct {{peripheral_name}}_info info[DEVICE_MAX];
+static struct {{peripheral_name}}_info info[{{ peripheral_name.upper() }}_INSTANCES];
+GROVE_POOL(pool, {{ peripheral_name.upper() }}_INSTANCES);
 
 static int {{peripheral_name}}_next_index() {
-    for (int i = 0; i < DEVICE_MAX; ++i) {
-        if (info[i].count == 0) return i;
-    }
-    return -1;
+    return grove_pool_alloc(&pool);
 }
 {% endif -%}
 
@@ -84,6 +85,8 @@ static int {{peripheral_name}}_next_index() {
 {%- if has_data_struct %}
 static {{ peripheral_name }} {{ peripheral_name }}_open_analog(analog pin) {
     {{peripheral_name}} dev_id = {{peripheral_name}}_next_index();
+    if (dev_id == -ENOMEM)
+        return -ENOMEM;
     info[dev_id].count++;
     info[dev_id].{{device_name}} = pin;
 {%- if has_data %}
@@ -115,6 +118,8 @@ static {{ peripheral_name }} {{ peripheral_name }}_open_analog(analog pin) {
 {%- else %}
 {%- if has_data_struct %}
     {{peripheral_name}} dev_id = {{peripheral_name}}_next_index();
+    if (dev_id == -ENOMEM)
+        return -ENOMEM;
     info[dev_id].count++;
 {%- if twowire %}
     info[dev_id].{{device_name_a}} = {{device_type}}_open_grove_a(grove_id);
@@ -137,6 +142,8 @@ static {{ peripheral_name }} {{ peripheral_name }}_open_analog(analog pin) {
 {% if i2c_use_address -%}
 {{peripheral_name}} {{peripheral_name}}_open_at_address(int grove_id, int address) {
     {{peripheral_name}} dev_id = {{peripheral_name}}_next_index();
+    if (dev_id == -ENOMEM)
+        return -ENOMEM;
     info[dev_id].count++;
     info[dev_id].{{device_name}} = {{device_type}}_open_grove(grove_id);
     info[dev_id].address = address;
@@ -165,6 +172,9 @@ void {{ peripheral_name }}_close({{peripheral_name}} p) {
 {%- else %}
     {{device_type}}_close({{device_name}});
 {%- endif %}
+{%- if has_data_struct %}
+    grove_pool_free(&pool, p);
+{%- endif %}
 }
 
 void {{peripheral_name}}_example({{peripheral_name}} p{{example_args}}) {
@@ -0,0 +1,197 @@
+#   Copyright (c) 2021, Xilinx, Inc.
+#   All rights reserved.
+# 
+#   Redistribution and use in source and binary forms, with or without 
+#   modification, are permitted provided that the following conditions are met:
+#
+#   1.  Redistributions of source code must retain the above copyright notice, 
+#       this list of conditions and the following disclaimer.
+#
+#   2.  Redistributions in binary form must reproduce the above copyright 
+#       notice, this list of conditions and the following disclaimer in the 
+#       documentation and/or other materials provided with the distribution.
+#
+#   3.  Neither the name of the copyright holder nor the names of its 
+#       contributors may be used to endorse or promote products derived from 
+#       this software without specific prior written permission.
+#
+#   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+#   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+#   THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR 
+#   PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+#   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+#   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+#   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+#   OR BUSINESS INTERRUPTION). HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+#   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+#   OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+#   ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""Tests of the firmware cache against a stubbed PYNQ RPC module.
+
+The stubs stand in for the MicroBlaze compiler and preprocessor and count
+how often each runs, so hits, misses and rebuilds can be told apart
+without a board. Run with ``python -m unittest discover tests``.
+"""
+
+import importlib.util
+import os
+import sys
+import tempfile
+import threading
+import types
+import unittest
+
+REPO_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+
+class _PynqMicroblaze:
+    def __init__(self, mb_info, mb_program, force=False):
+        with open(mb_program, "rb") as f:
+            self.image = f.read()
+        if not self.image.startswith(b"BIN:"):
+            raise RuntimeError("bad program")
+
+
+def _install_stubs():
+    counts = {"compile": 0, "preprocess": 0}
+
+    def preprocess(text, mb_info=None):
+        counts["preprocess"] += 1
+        return "PRE:" + text
+
+    class MicroblazeProgram(_PynqMicroblaze):
+        def __init__(self, mb_info, program_text, bsp=None):
+            counts["compile"] += 1
+            with tempfile.TemporaryDirectory() as d:
+                path = os.path.join(d, "program.bin")
+                with open(path, "w") as f:
+                    f.write("BIN:" + program_text)
+                super().__init__(mb_info, path)
+
+    class MicroblazeLibrary:
+        def __init__(self, iop, modules):
+            # Looked up through the module as the PYNQ generator does
+            self.source = rpc.preprocess("\n".join(sorted(modules)),
+                                         mb_info=iop)
+            self.program = rpc.MicroblazeProgram(iop, self.source)
+
+    pynq = types.ModuleType("pynq")
+    pynq.__version__ = "0.0"
+    lib = types.ModuleType("pynq.lib")
+    package = types.ModuleType("pynq.lib.pynqmicroblaze")
+    rpc = types.ModuleType("pynq.lib.pynqmicroblaze.rpc")
+    compile_ = types.ModuleType("pynq.lib.pynqmicroblaze.compile")
+    microblaze = types.ModuleType("pynq.lib.pynqmicroblaze.pynqmicroblaze")
+    rpc.preprocess = preprocess
+    rpc.MicroblazeProgram = MicroblazeProgram
+    rpc.MicroblazeLibrary = MicroblazeLibrary
+    compile_.MicroblazeProgram = MicroblazeProgram
+    microblaze.PynqMicroblaze = _PynqMicroblaze
+    package.rpc = rpc
+    sys.modules.update({
+        "pynq": pynq,
+        "pynq.lib": lib,
+        "pynq.lib.pynqmicroblaze": package,
+        "pynq.lib.pynqmicroblaze.rpc": rpc,
+        "pynq.lib.pynqmicroblaze.compile": compile_,
+        "pynq.lib.pynqmicroblaze.pynqmicroblaze": microblaze,
+    })
+    return rpc, counts
+
+
+_rpc, _counts = _install_stubs()
+_spec = importlib.util.spec_from_file_location(
+    "firmware_cache",
+    os.path.join(REPO_DIR, "pynq_peripherals", "firmware_cache.py"))
+firmware_cache = importlib.util.module_from_spec(_spec)
+_spec.loader.exec_module(firmware_cache)
+
+IOP = {"ip_name": "iop_pmoda", "mbtype": "Pmod"}
+MODULES = {"grove_interfaces", "grove_servo"}
+
+
+class FirmwareCacheTest(unittest.TestCase):
+    def setUp(self):
+        self.directory = tempfile.TemporaryDirectory()
+        self.saved_env = os.environ.get("PYNQ_PERIPHERALS_CACHE")
+        os.environ["PYNQ_PERIPHERALS_CACHE"] = self.directory.name
+        _counts.update(compile=0, preprocess=0)
+
+    def tearDown(self):
+        if self.saved_env is None:
+            del os.environ["PYNQ_PERIPHERALS_CACHE"]
+        else:
+            os.environ["PYNQ_PERIPHERALS_CACHE"] = self.saved_env
+        self.directory.cleanup()
+
+    def build(self, iop=IOP, modules=MODULES):
+        return firmware_cache.build_library(_rpc.MicroblazeLibrary, iop,
+                                            modules)
+
+    def entry_path(self, name):
+        key = firmware_cache.cache_key(IOP, MODULES)
+        return os.path.join(self.directory.name, key, name)
+
+    def test_miss_then_hit(self):
+        first = self.build()
+        self.assertEqual(_counts, {"compile": 1, "preprocess": 1})
+        second = self.build(modules=set(reversed(sorted(MODULES))))
+        self.assertEqual(_counts, {"compile": 1, "preprocess": 1})
+        self.assertEqual(second.program.image, first.program.image)
+        self.assertEqual(second.source, first.source)
+
+    def test_key_changes(self):
+        key = firmware_cache.cache_key(IOP, MODULES)
+        self.assertNotEqual(key, firmware_cache.cache_key(
+            IOP, MODULES | {"grove_pir"}))
+        self.assertNotEqual(key, firmware_cache.cache_key(
+            {"ip_name": "iop_arduino", "mbtype": "Arduino"}, MODULES))
+        saved = firmware_cache._sources_digest
+        try:
+            firmware_cache._sources_digest = "changed"
+            self.assertNotEqual(key, firmware_cache.cache_key(IOP, MODULES))
+        finally:
+            firmware_cache._sources_digest = saved
+        self.build()
+        self.build(iop={"ip_name": "iop_arduino", "mbtype": "Arduino"})
+        self.assertEqual(_counts["compile"], 2)
+
+    def test_corrupt_entry_is_rebuilt(self):
+        self.build()
+        with open(self.entry_path(firmware_cache.PROGRAM_FILE), "wb"):
+            pass
+        lib = self.build()
+        self.assertEqual(_counts["compile"], 2)
+        self.assertTrue(lib.program.image.startswith(b"BIN:"))
+        with open(self.entry_path(firmware_cache.PROGRAM_FILE), "rb") as f:
+            self.assertEqual(f.read(), lib.program.image)
+        self.build()
+        self.assertEqual(_counts["compile"], 2)
+
+    def test_rpc_restored(self):
+        program, preprocess = _rpc.MicroblazeProgram, _rpc.preprocess
+        self.build()
+        self.build()
+        self.assertIs(_rpc.MicroblazeProgram, program)
+        self.assertIs(_rpc.preprocess, preprocess)
+
+    def test_threads(self):
+        program, preprocess = _rpc.MicroblazeProgram, _rpc.preprocess
+        libs = []
+        threads = [threading.Thread(target=lambda: libs.append(self.build()))
+                   for _ in range(8)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        self.assertEqual(len(libs), 8)
+        self.assertEqual(_counts["compile"], 1)
+        for lib in libs:
+            self.assertEqual(lib.program.image, libs[0].program.image)
+        self.assertIs(_rpc.MicroblazeProgram, program)
+        self.assertIs(_rpc.preprocess, preprocess)
+
+
+if __name__ == "__main__":
+    unittest.main()